@@ -95,6 +95,11 @@ public:
                              skia_private::TArray<SkString>* keys,
                              skia_private::TArray<double>* values) {}
 
+    // Metrics to report along with the timing, given the median time of a loop in milliseconds.
+    virtual void getMetrics(double ms,
+                            skia_private::TArray<SkString>* keys,
+                            skia_private::TArray<double>* values) {}
+
     // Replaces the GrRecordingContext's dmsaaStats() with a single frame of this benchmark.
     virtual bool getDMSAAStats(GrRecordingContext*) { return false; }
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkString.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkBlitMask.h"
+#include "src/core/SkBlitRow.h"
+#include "src/core/SkColorData.h"
+
+// Benchmarks the SkOpts row and mask procs that composite sprites and glyph masks onto 8888.
+class BlitRowBench : public Benchmark {
+public:
+    enum class Proc { kS32AOpaque, kColor32, kMaskA8Black, kMaskA8Opaque, kMaskA8General };
+
+    BlitRowBench(Proc proc, const char* name) : fProc(proc) {
+        fName.printf("SkOpts::%s", name);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < K; ++i) {
+            fSrc[i]  = SkPreMultiplyColor(rand.nextU());
+            fDst[i]  = SkPreMultiplyColor(rand.nextU());
+            fMask[i] = rand.nextU() & 0xFF;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            switch (fProc) {
+                case Proc::kS32AOpaque:
+                    SkOpts::blit_row_s32a_opaque(fDst, fSrc, K, 0xFF);
+                    break;
+                case Proc::kColor32:
+                    SkOpts::blit_row_color32(fDst, K, SkPreMultiplyColor(0x80336699));
+                    break;
+                case Proc::kMaskA8Black:
+                    SkOpts::blit_mask_d32_a8(fDst, 0, fMask, 0, SK_ColorBLACK, K, 1);
+                    break;
+                case Proc::kMaskA8Opaque:
+                    SkOpts::blit_mask_d32_a8(fDst, 0, fMask, 0, 0xFF336699, K, 1);
+                    break;
+                case Proc::kMaskA8General:
+                    SkOpts::blit_mask_d32_a8(fDst, 0, fMask, 0, 0x80336699, K, 1);
+                    break;
+            }
+        }
+    }
+
+private:
+    // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
+    inline static constexpr int K = 1023;
+
+    Proc      fProc;
+    SkString  fName;
+    SkPMColor fSrc[K];
+    SkPMColor fDst[K];
+    SkAlpha   fMask[K];
+};
+
+DEF_BENCH(return new BlitRowBench(BlitRowBench::Proc::kS32AOpaque,    "blit_row_s32a_opaque"))
+DEF_BENCH(return new BlitRowBench(BlitRowBench::Proc::kColor32,       "blit_row_color32"))
+DEF_BENCH(return new BlitRowBench(BlitRowBench::Proc::kMaskA8Black,   "blit_mask_d32_a8_black"))
+DEF_BENCH(return new BlitRowBench(BlitRowBench::Proc::kMaskA8Opaque,  "blit_mask_d32_a8_opaque"))
+DEF_BENCH(return new BlitRowBench(BlitRowBench::Proc::kMaskA8General, "blit_mask_d32_a8_general"))
@@ -18,6 +18,7 @@
 #define FILTER_HEIGHT_SMALL 32
 #define FILTER_WIDTH_LARGE  256
 #define FILTER_HEIGHT_LARGE 256
+#define FILTER_SIZE_HUGE    1024
 #define BLUR_SIGMA_MINI     0.5f
 #define BLUR_SIGMA_SMALL    1.0f
 #define BLUR_SIGMA_LARGE    10.0f
@@ -161,3 +162,42 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Blurs a 1024x1024 image so that the X and Y passes can be compared directly at a size where
+// the column walk of a naive vertical pass falls out of cache, and where the passes are split
+// across threads when nanobench runs with --threads.
+class BlurHugeImageFilterBench : public Benchmark {
+public:
+    BlurHugeImageFilterBench(SkScalar sigmaX, SkScalar sigmaY)
+            : fSigmaX(sigmaX), fSigmaY(sigmaY) {
+        fName.printf("blur_image_filter_huge_%.2f_%.2f", sigmaX, sigmaY);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkISize onGetSize() override { return {FILTER_SIZE_HUGE, FILTER_SIZE_HUGE}; }
+
+    void onDelayedSetup() override {
+        if (!fCheckerboard) {
+            fCheckerboard = make_checkerboard(FILTER_SIZE_HUGE, FILTER_SIZE_HUGE);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setImageFilter(SkImageFilters::Blur(fSigmaX, fSigmaY, nullptr));
+        for (int i = 0; i < loops; i++) {
+            canvas->drawImage(fCheckerboard, 0, 0, SkSamplingOptions(), &paint);
+        }
+    }
+
+private:
+    SkString fName;
+    sk_sp<SkImage> fCheckerboard;
+    SkScalar fSigmaX, fSigmaY;
+};
+
+DEF_BENCH(return new BlurHugeImageFilterBench(BLUR_SIGMA_LARGE, 0);)
+DEF_BENCH(return new BlurHugeImageFilterBench(0, BLUR_SIGMA_LARGE);)
+DEF_BENCH(return new BlurHugeImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE);)
@@ -54,8 +54,8 @@ public:
     bool isSuitableFor(Backend backend) override {
         if (kDrawMode == DrawMode::kBatch && kImageMode == ImageMode::kNone) {
             // Currently the bulk color quad API is only available on
-            // skgpu::ganesh::SurfaceDrawContext
-            return backend == Backend::kGanesh;
+            // skgpu::ganesh::SurfaceDrawContext and SkBitmapDevice
+            return backend == Backend::kGanesh || backend == Backend::kRaster;
         } else {
             return this->INHERITED::isSuitableFor(backend);
         }
@@ -134,7 +134,11 @@ protected:
         SkASSERT(kImageMode == ImageMode::kNone);
         SkASSERT(kDrawMode == DrawMode::kBatch);
 
-        SkASSERT(canvas->recordingContext());
+        if (!canvas->recordingContext()) {
+            SkCanvasPriv::DrawEdgeAAQuadSet(canvas, fRects, fColors, SkCanvas::kAll_QuadAAFlags,
+                                            SkBlendMode::kSrcOver);
+            return;
+        }
 
         GrQuadSetEntry batch[kRectCount];
         for (int i = 0; i < kRectCount; ++i) {
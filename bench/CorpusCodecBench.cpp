@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/CorpusCodecBench.h"
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkPngEncoder.h"
+#include "include/encode/SkWebpEncoder.h"
+#include "tools/ProcStats.h"
+
+#include <memory>
+
+using namespace skia_private;
+
+// nanobench --encodeCorpus --benchType corpus --images your_images_directory
+//           [--encodeThreads 0 4 8]
+//
+// PNG at libpng's default and fastest and smallest zlib levels, and JPEG and WebP at the
+// qualities commonly used for photos and thumbnails.
+static constexpr CorpusCodecBench::Setting kSettings[] = {
+        {CorpusCodecBench::Format::kPng, 1},
+        {CorpusCodecBench::Format::kPng, 6},
+        {CorpusCodecBench::Format::kPng, 9},
+        {CorpusCodecBench::Format::kJpeg, 50},
+        {CorpusCodecBench::Format::kJpeg, 75},
+        {CorpusCodecBench::Format::kJpeg, 90},
+        {CorpusCodecBench::Format::kJpeg, 100},
+        {CorpusCodecBench::Format::kWebp, 50},
+        {CorpusCodecBench::Format::kWebp, 75},
+        {CorpusCodecBench::Format::kWebp, 90},
+        {CorpusCodecBench::Format::kWebpLossless, 25},
+        {CorpusCodecBench::Format::kWebpLossless, 75},
+};
+
+SkSpan<const CorpusCodecBench::Setting> CorpusCodecBench::Settings() { return kSettings; }
+
+static const char* format_name(CorpusCodecBench::Format format) {
+    switch (format) {
+        case CorpusCodecBench::Format::kPng:          return "png";
+        case CorpusCodecBench::Format::kJpeg:         return "jpeg";
+        case CorpusCodecBench::Format::kWebp:         return "webp";
+        case CorpusCodecBench::Format::kWebpLossless: return "webpll";
+    }
+    SkUNREACHABLE;
+}
+
+CorpusCodecBench::CorpusCodecBench(
+        SkString basename, SkData* encoded, Mode mode, Setting setting, int threads)
+        : fMode(mode), fSetting(setting), fThreads(threads), fSource(SkRef(encoded)) {
+    fName.printf("Corpus%s_%s_%s_%d_t%d",
+                 mode == Mode::kEncode ? "Encode" : "Decode",
+                 basename.c_str(),
+                 format_name(setting.fFormat),
+                 setting.fLevel,
+                 threads);
+}
+
+const char* CorpusCodecBench::onGetName() { return fName.c_str(); }
+
+bool CorpusCodecBench::isSuitableFor(Backend backend) {
+    return Backend::kNonRendering == backend;
+}
+
+bool CorpusCodecBench::encode(SkWStream* dst) const {
+    const SkPixmap& src = fPixels.pixmap();
+    switch (fSetting.fFormat) {
+        case Format::kPng: {
+            SkPngEncoder::Options options;
+            options.fZLibLevel = fSetting.fLevel;
+            options.fExecutor = fExecutor.get();
+            return SkPngEncoder::Encode(dst, src, options);
+        }
+        case Format::kJpeg: {
+            SkJpegEncoder::Options options;
+            options.fQuality = fSetting.fLevel;
+            options.fExecutor = fExecutor.get();
+            return SkJpegEncoder::Encode(dst, src, options);
+        }
+        case Format::kWebp:
+        case Format::kWebpLossless: {
+            SkWebpEncoder::Options options;
+            options.fCompression = fSetting.fFormat == Format::kWebp
+                                           ? SkWebpEncoder::Compression::kLossy
+                                           : SkWebpEncoder::Compression::kLossless;
+            options.fQuality = fSetting.fLevel;
+            options.fExecutor = fExecutor.get();
+            return SkWebpEncoder::Encode(dst, src, options);
+        }
+    }
+    SkUNREACHABLE;
+}
+
+void CorpusCodecBench::onDelayedSetup() {
+    if (fThreads > 0) {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fSource);
+    SkASSERT_RELEASE(codec);
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    if (info.alphaType() == kUnpremul_SkAlphaType) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    fPixels.allocPixels(info);
+    const SkCodec::Result result = codec->getPixels(fPixels.pixmap());
+    SkASSERT_RELEASE(result == SkCodec::kSuccess || result == SkCodec::kIncompleteInput);
+
+    // The decode benches decode what this setting encodes.
+    SkDynamicMemoryWStream stream;
+    SkAssertResult(this->encode(&stream));
+    fEncoded = stream.detachAsData();
+}
+
+void CorpusCodecBench::onDraw(int loops, SkCanvas*) {
+    SkCodec::Options options;
+    options.fExecutor = fExecutor.get();
+    for (int i = 0; i < loops; i++) {
+        if (fMode == Mode::kEncode) {
+            SkNullWStream dst;
+            SkAssertResult(this->encode(&dst));
+        } else {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fEncoded);
+            SkAssertResult(codec->getPixels(fPixels.info(), fPixels.getPixels(),
+                                            fPixels.rowBytes(), &options) == SkCodec::kSuccess);
+        }
+    }
+}
+
+void CorpusCodecBench::getMetrics(double ms, TArray<SkString>* keys, TArray<double>* values) {
+    const double megapixels = fPixels.width() * fPixels.height() * 1e-6;
+    keys->push_back(SkString("megapixels_per_second"));
+    values->push_back(megapixels / (ms * 1e-3));
+    keys->push_back(SkString("encoded_bytes"));
+    values->push_back(fEncoded->size());
+    keys->push_back(SkString("bits_per_pixel"));
+    values->push_back(8.0 * fEncoded->size() / (fPixels.width() * fPixels.height()));
+    // ProcStats only knows the peak of the whole process, so this is an upper bound for the
+    // settings benched so far.
+    keys->push_back(SkString("max_rss_mb"));
+    values->push_back(sk_tools::getMaxResidentSetSizeMB());
+}
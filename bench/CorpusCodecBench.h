@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef CorpusCodecBench_DEFINED
+#define CorpusCodecBench_DEFINED
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkString.h"
+
+#include <memory>
+
+class SkWStream;
+
+/**
+ *  Times encoding an image of a corpus with one encoder setting, or decoding what that setting
+ *  produced, so that settings can be compared on real images. Besides the time, it reports the
+ *  throughput, the encoded size and the peak memory of the process.
+ */
+class CorpusCodecBench : public Benchmark {
+public:
+    enum class Mode {
+        kEncode,
+        kDecode,
+    };
+
+    enum class Format {
+        kPng,
+        kJpeg,
+        kWebp,
+        kWebpLossless,
+    };
+
+    struct Setting {
+        Format fFormat;
+        int    fLevel;  // The zlib level for PNG, and the quality for JPEG and WebP.
+    };
+
+    // The settings swept over each image.
+    static SkSpan<const Setting> Settings();
+
+    // Calls encoded->ref(). Encodes and decodes serially if |threads| is 0, and otherwise passes
+    // the codecs an executor with that many threads.
+    CorpusCodecBench(SkString basename, SkData* encoded, Mode, Setting, int threads);
+
+    void getMetrics(double ms,
+                    skia_private::TArray<SkString>* keys,
+                    skia_private::TArray<double>* values) override;
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDelayedSetup() override;
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    bool encode(SkWStream*) const;
+
+    SkString                     fName;
+    const Mode                   fMode;
+    const Setting                fSetting;
+    const int                    fThreads;
+    sk_sp<SkData>                fSource;
+    std::unique_ptr<SkExecutor>  fExecutor;
+    SkBitmap                     fPixels;   // Set in onDelayedSetup.
+    sk_sp<SkData>                fEncoded;  // Set in onDelayedSetup.
+};
+
+#endif  // CorpusCodecBench_DEFINED
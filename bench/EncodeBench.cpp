@@ -8,6 +8,7 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -19,6 +20,9 @@
 //
 // There is no corresponding DecodeBench class. Decoder benchmarks are run by:
 // nanobench --benchType skcodec --images your_images_directory
+//
+// Encoder settings and thread counts are swept over a corpus of images by:
+// nanobench --encodeCorpus --benchType corpus --images your_images_directory
 
 class EncodeBench : public Benchmark {
 public:
@@ -63,6 +67,18 @@ static bool encode_jpeg(SkWStream* dst, const SkPixmap& src) {
     return SkJpegEncoder::Encode(dst, src, opts);
 }
 
+static SkExecutor* encode_executor() {
+    static SkExecutor* gExecutor = SkExecutor::MakeFIFOThreadPool().release();
+    return gExecutor;
+}
+
+static bool encode_jpeg_concurrently(SkWStream* dst, const SkPixmap& src) {
+    SkJpegEncoder::Options opts;
+    opts.fQuality = 90;
+    opts.fExecutor = encode_executor();
+    return SkJpegEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossy;
@@ -70,6 +86,14 @@ static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     return SkWebpEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_webp_lossy_concurrently(SkWStream* dst, const SkPixmap& src) {
+    SkWebpEncoder::Options opts;
+    opts.fCompression = SkWebpEncoder::Compression::kLossy;
+    opts.fQuality = 90;
+    opts.fExecutor = encode_executor();
+    return SkWebpEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossless(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossless;
@@ -87,6 +111,12 @@ static bool encode_png(SkWStream* dst,
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_png_concurrently(SkWStream* dst, const SkPixmap& src) {
+    SkPngEncoder::Options opts;
+    opts.fExecutor = encode_executor();
+    return SkPngEncoder::Encode(dst, src, opts);
+}
+
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
@@ -95,10 +125,16 @@ static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG", kRGBA_8888_SkColorType))
 DEF_BENCH(return new EncodeBench(srcs[1], &encode_jpeg, "JPEG", kRGBA_8888_SkColorType))
+DEF_BENCH(return new EncodeBench(srcs[0], encode_jpeg_concurrently, "JPEG_mt", kRGBA_8888_SkColorType))
+DEF_BENCH(return new EncodeBench(srcs[1], encode_jpeg_concurrently, "JPEG_mt", kRGBA_8888_SkColorType))
 
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy, "WEBP", kRGBA_8888_SkColorType))
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossy, "WEBP", kRGBA_8888_SkColorType))
+DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy_concurrently, "WEBP_mt",
+                                 kN32_SkColorType))
+DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossy_concurrently, "WEBP_mt",
+                                 kN32_SkColorType))
 
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossless, "WEBP_LL", kRGBA_8888_SkColorType))
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossless, "WEBP_LL", kRGBA_8888_SkColorType))
@@ -127,6 +163,9 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n", kRGBA_8888_Sk
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n", kRGBA_8888_SkColorType))
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n", kRGBA_8888_SkColorType))
 
+DEF_BENCH(return new EncodeBench(srcs[0], encode_png_concurrently, "PNG_mt", kRGBA_8888_SkColorType))
+DEF_BENCH(return new EncodeBench(srcs[1], encode_png_concurrently, "PNG_mt", kRGBA_8888_SkColorType))
+
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 6), "PNG", kRGBA_F16_SkColorType))
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kAll, 6), "PNG", kRGBA_F16_SkColorType))
 
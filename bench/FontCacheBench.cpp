@@ -7,12 +7,14 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkString.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkChecksum.h"
+#include "src/core/SkTaskGroup.h"
 #include "tools/fonts/FontToolUtils.h"
 
 #include "bench/gUniqueGlyphIDs.h"
@@ -197,3 +199,53 @@ private:
 };
 DEF_BENCH( return new FontPathBench(true); )
 DEF_BENCH( return new FontPathBench(false); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Several threads, each measuring short runs of text with a font whose strike is already cached,
+// as when each thread rasterizes its own text-heavy canvas.
+class FontCacheContentionBench : public Benchmark {
+    static constexpr int kRunsPerThread = 200;
+
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkFont fFont;
+    SkString fName;
+
+public:
+    explicit FontCacheContentionBench(int threads) : fThreads(threads) {
+        fName.printf("fontcache_contention_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        fFont = ToolUtils::DefaultFont();
+        fFont.setEdging(SkFont::Edging::kAntiAlias);
+        (void)fFont.measureText("warm", 4, SkTextEncoding::kUTF8);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static constexpr char kText[] = "Hello";
+        for (int loop = 0; loop < loops; ++loop) {
+            SkTaskGroup(*fExecutor).batch(fThreads, [this](int) {
+                for (int i = 0; i < kRunsPerThread; ++i) {
+                    (void)fFont.measureText(kText, sizeof(kText) - 1, SkTextEncoding::kUTF8);
+                }
+            });
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new FontCacheContentionBench(1); )
+DEF_BENCH( return new FontCacheContentionBench(16); )
@@ -6,7 +6,13 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkShardedResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <memory>
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +78,56 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Many threads looking up (and occasionally adding) resources in one cache at once, as when
+// several threads rasterize tiles that share images.
+class ImageCacheContentionBench : public Benchmark {
+    static constexpr int kThreads = 32;
+    static constexpr int kKeysPerThread = 64;
+    static constexpr int kLookupsPerThread = 1000;
+
+    SkShardedResourceCache fCache;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkString fName;
+
+public:
+    explicit ImageCacheContentionBench(int shardCount)
+            : fCache(kThreads * kKeysPerThread * 100, shardCount) {
+        fName.printf("imagecache_contention_%dshards", shardCount);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(kThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkTaskGroup(*fExecutor).batch(kThreads, [this](int thread) {
+                for (int j = 0; j < kLookupsPerThread; ++j) {
+                    // Each thread mostly revisits its own keys, but shares some with its neighbor.
+                    TestKey key(thread * kKeysPerThread + (j * 7) % (kKeysPerThread + 8));
+                    if (!fCache.find(key, TestRec::Visitor, nullptr)) {
+                        fCache.add(new TestRec(key, j));
+                    }
+                }
+            });
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheContentionBench(1); )
+DEF_BENCH( return new ImageCacheContentionBench(SkShardedResourceCache::kDefaultShardCount); )
@@ -6,8 +6,13 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkCPUContext.h"
+#include "include/core/SkCPURecorder.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "tools/DecodeUtils.h"
 #include "tools/Resources.h"
@@ -180,7 +185,66 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Exercise a wide, shallow DAG like an SVG feMerge of several blurred and offset copies of the
+// source, drawn to a raster surface whose skcpu::Context evaluates independent branches on an
+// executor with 'threads' threads (or serially when 'threads' is 0).
+class ImageFilterWideDAGBench : public Benchmark {
+public:
+    explicit ImageFilterWideDAGBench(int threads) : fThreads(threads) {
+        fName.printf("image_filter_wide_dag_%d_threads", threads);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        skcpu::Context::Options opts;
+        opts.fExecutor = fExecutor.get();
+        fContext = skcpu::Context::Make(opts);
+        fRecorder = fContext->makeRecorder();
+        SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+        fSurface = fRecorder->makeBitmapSurface(info, info.minRowBytes(), {});
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int j = 0; j < loops; j++) {
+            // Make the filters on each loop so that the image filter cache does not skip the work.
+            sk_sp<SkImageFilter> branches[kNumBranches];
+            for (int i = 0; i < kNumBranches; ++i) {
+                branches[i] = SkImageFilters::Blur(
+                        4.f + 2 * i, 4.f + 2 * i,
+                        SkImageFilters::Offset(3.f * i, 2.f * i, nullptr));
+            }
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::Merge(branches, kNumBranches));
+
+            canvas->drawRect(SkRect::MakeWH(kSize, kSize), paint);
+        }
+    }
+
+private:
+    static constexpr int kNumBranches = 6;
+    static constexpr int kSize = 512;
+
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::unique_ptr<const skcpu::Context> fContext;
+    std::unique_ptr<skcpu::Recorder> fRecorder;
+    sk_sp<SkSurface> fSurface;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterWideDAGBench(0);)
+DEF_BENCH(return new ImageFilterWideDAGBench(4);)
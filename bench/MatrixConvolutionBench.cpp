@@ -14,14 +14,21 @@
 
 #include "tools/ToolUtils.h"
 
+enum class KernelType {
+    kSmall,     // 3x3 that fits in shader uniforms
+    kBig,       // 9x9 that is stored in a texture
+    kSeparable, // 9x9 that is the outer product of two 1D kernels
+};
+
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
+    MatrixConvolutionBench(KernelType kernelType, SkTileMode tileMode, bool convolveAlpha)
         : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+                               kernelType == KernelType::kBig       ? "bigKernel_" :
+                               kernelType == KernelType::kSeparable ? "separableKernel_" : "",
                                ToolUtils::tilemode_name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
+        if (kernelType == KernelType::kBig) {
             SkISize kernelSize = SkISize::Make(9, 9);
             SkScalar kernel[81];
             for (int i = 0; i < 81; i++) {
@@ -33,6 +40,18 @@ public:
             fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
                                                         kernelOffset, tileMode, convolveAlpha,
                                                         nullptr);
+        } else if (kernelType == KernelType::kSeparable) {
+            SkISize kernelSize = SkISize::Make(9, 9);
+            const SkScalar binomial[9] = {1, 8, 28, 56, 70, 56, 28, 8, 1};
+            SkScalar kernel[81];
+            for (int i = 0; i < 81; i++) {
+                kernel[i] = binomial[i / 9] * binomial[i % 9];
+            }
+            SkScalar gain = 1.f / (256 * 256), bias = 0;
+            SkIPoint kernelOffset = SkIPoint::Make(4, 4);
+            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
+                                                        kernelOffset, tileMode, convolveAlpha,
+                                                        nullptr);
         } else {
             SkISize kernelSize = SkISize::Make(3, 3);
             SkScalar kernel[9] = {
@@ -74,14 +93,17 @@ private:
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kDecal, false); )
 
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSeparable, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSeparable, SkTileMode::kDecal, false); )
@@ -24,6 +24,7 @@
 #include "src/core/SkDraw.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkPathData.h"
+#include "src/core/SkScan.h"
 
 using namespace skia_private;
 
@@ -1476,3 +1477,65 @@ DEF_BENCH( return new PathIsRectBench("complex_norect", SkPathBuilder()
                                                     .conicTo(10, 20, 20, 20, .7f)
                                                     .close()
                                                     .detach()); )
+
+// Compares AAA against the sparse accumulation rasterizer on self-overlapping fills with many
+// edges crossing every scan line.
+class ComplexFillBench final : public Benchmark {
+public:
+    ComplexFillBench(SkAAFillAlgorithm algorithm, SkPathFillType fillType, int points, bool curves)
+            : fAlgorithm(algorithm) {
+        fName.printf("path_complex_fill_%s_%s_%d%s",
+                     algorithm == SkAAFillAlgorithm::kAnalytic ? "aaa" : "accum",
+                     fillType == SkPathFillType::kEvenOdd ? "evenodd" : "winding",
+                     points,
+                     curves ? "_quads" : "");
+
+        // A {points/k} star polygon: every edge spans most of the height, so every scan line
+        // crosses a large fraction of all edges.
+        SkPathBuilder builder(fillType);
+        const int step = points / 2 - 1;
+        for (int i = 0; i < points; ++i) {
+            float t = 2 * SK_FloatPI * i * step / points;
+            SkPoint p = {320 + 300 * std::cos(t), 320 + 300 * std::sin(t)};
+            if (i == 0) {
+                builder.moveTo(p);
+            } else if (curves) {
+                builder.quadTo({320, 320}, p);
+            } else {
+                builder.lineTo(p);
+            }
+        }
+        fPath = builder.detach();
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kRaster; }
+    const char* onGetName() override { return fName.c_str(); }
+    SkISize onGetSize() override { return {640, 640}; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkAutoAAFillAlgorithm autoAlgorithm(fAlgorithm);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    SkString fName;
+    SkPath fPath;
+    const SkAAFillAlgorithm fAlgorithm;
+};
+
+#define COMPLEX_FILL_BENCHES(...)                                                            \
+    DEF_BENCH( return new ComplexFillBench(SkAAFillAlgorithm::kAnalytic, __VA_ARGS__); )     \
+    DEF_BENCH( return new ComplexFillBench(SkAAFillAlgorithm::kSparseAccumulation, __VA_ARGS__); )
+
+COMPLEX_FILL_BENCHES(SkPathFillType::kWinding, 101, false)
+COMPLEX_FILL_BENCHES(SkPathFillType::kWinding, 1001, false)
+COMPLEX_FILL_BENCHES(SkPathFillType::kEvenOdd, 1001, false)
+COMPLEX_FILL_BENCHES(SkPathFillType::kWinding, 10001, false)
+COMPLEX_FILL_BENCHES(SkPathFillType::kWinding, 1001, true)
+
+#undef COMPLEX_FILL_BENCHES
@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkMasks.h"
 #include "src/core/SkSwizzlePriv.h"
 
 class SwizzleBench : public Benchmark {
@@ -14,21 +15,44 @@ public:
 
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u32 fn) : fName(name), fFn_u32(fn) {}
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u8  fn) : fName(name), fFn_u8 (fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_index fn)
+        : fName(name), fFn_index(fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_masked16 fn)
+        : fName(name), fFn_masked16(fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_masked32 fn)
+        : fName(name), fFn_masked32(fn) {}
 
     bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        // Sources with 16-bit channels use up to 8 bytes per pixel.
+        uint32_t dst[K], src[2*K], table[256];
+        for (int i = 0; i < 256; i++) {
+            table[i] = i * 0x01010101;
+        }
+        // An ARGB 1555 layout for 16-bit pixels, and ARGB 2:10:10:10 for 32-bit pixels.
+        const SkMasks::MaskInfo masks16[4] = {
+            {0x7C00, 10, 5}, {0x03E0, 5, 5}, {0x001F, 0, 5}, {0x8000, 15, 1},
+        };
+        const SkMasks::MaskInfo masks32[4] = {
+            {0x3FC00000, 22, 8}, {0x000FF000, 12, 8}, {0x000003FC, 2, 8}, {0xC0000000, 30, 2},
+        };
         while (loops --> 0) {
-            if (fFn_u32) { fFn_u32(dst,                 src, K); }
-            if (fFn_u8)  { fFn_u8 (dst, (const uint8_t*)src, K); }
+            if (fFn_u32)      { fFn_u32     (dst,                  src, K); }
+            if (fFn_u8)       { fFn_u8      (dst, (const uint8_t*) src, K); }
+            if (fFn_index)    { fFn_index   (dst, (const uint8_t*) src, K, table); }
+            if (fFn_masked16) { fFn_masked16(dst, (const uint16_t*)src, K, masks16); }
+            if (fFn_masked32) { fFn_masked32(dst,                  src, K, masks32); }
         }
     }
 private:
     const char* fName;
-    SkOpts::Swizzle_8888_u32 fFn_u32 = nullptr;
-    SkOpts::Swizzle_8888_u8  fFn_u8  = nullptr;
+    SkOpts::Swizzle_8888_u32      fFn_u32      = nullptr;
+    SkOpts::Swizzle_8888_u8       fFn_u8       = nullptr;
+    SkOpts::Swizzle_8888_index    fFn_index    = nullptr;
+    SkOpts::Swizzle_8888_masked16 fFn_masked16 = nullptr;
+    SkOpts::Swizzle_8888_masked32 fFn_masked32 = nullptr;
 };
 
 
@@ -42,3 +66,12 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA))
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1))
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1))
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1", SkOpts::RGB16_to_RGB1))
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1", SkOpts::RGB16_to_BGR1))
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA))
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA))
+DEF_BENCH(return new SwizzleBench("SkOpts::index_to_8888", SkOpts::index_to_8888))
+DEF_BENCH(return new SwizzleBench("SkOpts::masked16_to_RGBA", SkOpts::masked16_to_RGBA))
+DEF_BENCH(return new SwizzleBench("SkOpts::masked16_to_RGB1", SkOpts::masked16_to_RGB1))
+DEF_BENCH(return new SwizzleBench("SkOpts::masked32_to_RGBA", SkOpts::masked32_to_RGBA))
+DEF_BENCH(return new SwizzleBench("SkOpts::masked32_to_RGB1", SkOpts::masked32_to_RGB1))
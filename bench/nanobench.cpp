@@ -13,6 +13,7 @@
 #include "bench/Benchmark.h"
 #include "bench/CodecBench.h"
 #include "bench/CodecBenchPriv.h"
+#include "bench/CorpusCodecBench.h"
 #include "bench/GMBench.h"
 #include "bench/MSKPBench.h"
 #include "bench/RecordingBench.h"
@@ -188,6 +189,13 @@ static DEFINE_string(images,
                      "",
                      "List of images and/or directories to decode. A directory with no images"
                      " is treated as a fatal error.");
+static DEFINE_bool(encodeCorpus,
+                   false,
+                   "Sweep the encoders' settings over --images, timing both the encode and the "
+                   "decode of what each setting produces.");
+static DEFINE_string(encodeThreads,
+                     "0 4",
+                     "Thread counts to sweep with --encodeCorpus. 0 encodes and decodes serially.");
 static DEFINE_bool(simpleCodec,
                    false,
                    "Runs of a subset of the codec tests, always N32, Premul or Opaque");
@@ -860,6 +868,15 @@ public:
             exit(1);
         }
 
+        for (int i = 0; i < FLAGS_encodeThreads.size(); i++) {
+            if (1 != sscanf(FLAGS_encodeThreads[i], "%d", &fEncodeThreads.push_back()) ||
+                fEncodeThreads.back() < 0) {
+                SkDebugf("Can't parse %s from --encodeThreads as a thread count.\n",
+                         FLAGS_encodeThreads[i]);
+                exit(1);
+            }
+        }
+
         // Choose the candidate color types for image decoding
         fColorTypes.push_back(kN32_SkColorType);
         if (!FLAGS_simpleCodec) {
@@ -1202,6 +1219,40 @@ public:
             fCurrentSampleSize = 0;
         }
 
+        // Run the CorpusCodecBenches: every setting at every thread count, encoding and decoding.
+        const SkSpan<const CorpusCodecBench::Setting> settings = CorpusCodecBench::Settings();
+        const int corpusBenchCount = 2 * settings.size() * fEncodeThreads.size();
+        for (; FLAGS_encodeCorpus && fCurrentCorpusImage < fImages.size(); fCurrentCorpusImage++) {
+            fSourceType = "image";
+            fBenchType = "corpus";
+
+            const SkString& path = fImages[fCurrentCorpusImage];
+            if (CommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            if (fCurrentCorpusBench == 0 && !SkCodec::MakeFromData(encoded)) {
+                // Nothing to encode.
+                SkDebugf("Cannot find codec for %s\n", path.c_str());
+                continue;
+            }
+
+            if (fCurrentCorpusBench < corpusBenchCount) {
+                int index = fCurrentCorpusBench++;
+                const auto mode = index % 2 ? CorpusCodecBench::Mode::kDecode
+                                            : CorpusCodecBench::Mode::kEncode;
+                index /= 2;
+                const int threads = fEncodeThreads[index % fEncodeThreads.size()];
+                index /= fEncodeThreads.size();
+                return new CorpusCodecBench(SkOSPath::Basename(path.c_str()),
+                                            encoded.get(),
+                                            mode,
+                                            settings[index],
+                                            threads);
+            }
+            fCurrentCorpusBench = 0;
+        }
+
 #ifdef SK_ENABLE_ANDROID_UTILS
         // Run the BRDBenches
         // We intend to create benchmarks that model the use cases in
@@ -1342,6 +1393,7 @@ private:
     TArray<SkString> fSVGs;
     TArray<SkString> fTextBlobTraces;
     TArray<SkString> fImages;
+    TArray<int> fEncodeThreads;
     TArray<SkColorType, true> fColorTypes;
     SkScalar fZoomMax;
     double fZoomPeriodMs;
@@ -1359,6 +1411,8 @@ private:
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
     int fCurrentAndroidCodec = 0;
+    int fCurrentCorpusImage = 0;
+    int fCurrentCorpusBench = 0;
 #ifdef SK_ENABLE_ANDROID_UTILS
     int fCurrentBRDImage = 0;
     int fCurrentSubsetType = 0;
@@ -1629,6 +1683,10 @@ int main(int argc, char** argv) {
             const bool want_plot = false;  //! FLAGS_quiet && !FLAGS_ms;
 
             Stats stats(samples, want_plot);
+            TArray<SkString> metricKeys;
+            TArray<double> metricValues;
+            bench->getMetrics(stats.median, &metricKeys, &metricValues);
+            SkASSERT(metricKeys.size() == metricValues.size());
             log.beginObject(config);
 
             log.beginObject("options");
@@ -1652,6 +1710,9 @@ int main(int argc, char** argv) {
                     log.appendMetric(keys[j].c_str(), values[j]);
                 }
             }
+            for (int j = 0; j < metricKeys.size(); j++) {
+                log.appendMetric(metricKeys[j].c_str(), metricValues[j]);
+            }
 
             log.endObject();  // config
 
@@ -1710,6 +1771,12 @@ int main(int argc, char** argv) {
                          bench->getUniqueName());
             }
 
+            if (!metricKeys.empty() && !FLAGS_quiet && !FLAGS_csv) {
+                for (int j = 0; j < metricKeys.size(); j++) {
+                    SkDebugf("\t%s\t%g\n", metricKeys[j].c_str(), metricValues[j]);
+                }
+            }
+
             if (FLAGS_gpuStats && Benchmark::Backend::kGanesh == configs[i].backend) {
                 target->dumpStats();
             }
@@ -1,10 +1,12 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
@@ -60,7 +62,11 @@ bool RenderPictureToPng(const sk_sp<SkPicture>& picture, const std::string& outp
         return false;
     }
 
-    return SkPngEncoder::Encode(&stream, pixmap, {});
+    // Tall pictures take as long to encode as to render, so compress strips of rows in parallel.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool();
+    SkPngEncoder::Options options;
+    options.fExecutor = executor.get();
+    return SkPngEncoder::Encode(&stream, pixmap, options);
 }
 
 int main(int argc, char** argv) {
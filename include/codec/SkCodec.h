@@ -31,6 +31,7 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -341,14 +342,15 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
         /**
          *  If not NULL, represents a subset of the original image to decode.
          *  Must be within the bounds returned by getInfo().
-         *  If the EncodedFormat is SkEncodedImageFormat::kWEBP (the only one which
-         *  currently supports subsets), the top and left values must be even.
+         *  Only SkEncodedImageFormat::kWEBP and kPNG currently support subsets. For
+         *  kWEBP, the top and left values must be even.
          *
          *  In getPixels and incremental decode, we will attempt to decode the
          *  exact rectangular subset specified by fSubset.
@@ -384,6 +386,16 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into parts that run concurrently
+         *  on this executor. It still returns once the whole image has been decoded.
+         *
+         *  Only SkEncodedImageFormat::kJPEG currently uses this, for full size decodes
+         *  of baseline images in memory that have restart markers at the start of rows
+         *  of MCUs. Other images are decoded serially.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -898,6 +910,12 @@ protected:
         return false;
     }
 
+    /**
+     *  Subclasses should override if onGetPixels() can decode an fSubset to a smaller size,
+     *  which is then checked against the subset's dimensions rather than the image's.
+     */
+    virtual bool onSupportsScaledSubsets() const { return false; }
+
     /**
      *  If the stream was previously read, attempt to rewind.
      *
@@ -11,12 +11,27 @@
 
 #include <memory>
 
+class SkExecutor;
+
 namespace skcpu {
 class Recorder;
 
 class SK_API Context {
 public:
-    struct Options {};
+    struct Options {
+        /**
+         *  If set, raster drawing may split very large operations (e.g. filling paths with a huge
+         *  number of edges) into independent pieces and run them on this executor. The caller
+         *  must keep the executor alive for as long as the Context and its Recorders are in use.
+         *  The results are the same as drawing without an executor.
+         *
+         *  Aliased path fills are split whenever they are large enough. Anti-aliased path fills
+         *  are only split when they have many edges per row (so they use the sparse accumulation
+         *  rasterizer) and the clip is not anti-aliased; other anti-aliased fills are drawn on
+         *  the calling thread.
+         */
+        SkExecutor* fExecutor = nullptr;
+    };
 
     std::unique_ptr<Recorder> makeRecorder() const;
 
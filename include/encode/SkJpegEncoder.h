@@ -18,6 +18,7 @@
 class SkColorSpace;
 class SkData;
 class SkEncoder;
+class SkExecutor;
 class SkPixmap;
 class SkWStream;
 class SkImage;
@@ -80,6 +81,15 @@ struct Options {
     const SkData* xmpMetadata = nullptr;
 
     std::optional<SkEncodedOrigin> fOrigin;
+
+    /**
+     *  If non-null, Encode() splits tall pixmaps into strips of rows that are encoded
+     *  concurrently on this executor, and joined at restart markers. The result is a standard
+     *  JPEG with the same pixels as one encoded serially, although it is slightly larger, as the
+     *  strips must share the standard Huffman tables. SkYUVAPixmaps and encoders returned by Make()
+     *  ignore this and encode serially.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
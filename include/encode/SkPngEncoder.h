@@ -20,6 +20,7 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -44,11 +45,13 @@ struct Options {
     /**
      *  Selects which filtering strategies to use.
      *
-     *  If a single filter is chosen, libpng will use that filter for every row.
+     *  If a single filter is chosen, the encoder will use that filter for every row.
      *
-     *  If multiple filters are chosen, libpng will use a heuristic to guess which filter
+     *  If multiple filters are chosen, the encoder will use a heuristic to guess which filter
      *  will encode smallest, then apply that filter.  This happens on a per row basis,
-     *  different rows can use different filters.
+     *  different rows can use different filters.  At fZLibLevel 1 through 3, where filtering
+     *  costs about as much as compressing, only the first few rows are filtered this way, and
+     *  the filter chosen most often for them is used for the rest of the image.
      *
      *  Using a single filter (or less filters) is typically faster.  Trying all of the
      *  filters may help minimize the output file size.
@@ -90,6 +93,14 @@ struct Options {
      */
     const SkPixmap* fGainmap = nullptr;
     const SkGainmapInfo* fGainmapInfo = nullptr;
+
+    /**
+     *  If non-null, Encode() splits tall images into strips of rows that are filtered and
+     *  compressed concurrently on this executor. The strips are stitched into a single zlib
+     *  stream, so the result is still a standard PNG, although it may be slightly larger than
+     *  one encoded serially. Encoders returned by Make() ignore this and encode incrementally.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
@@ -13,6 +13,7 @@
 #include "include/encode/SkEncoder.h"
 #include "include/private/base/SkAPI.h"
 
+class SkExecutor;
 class SkPixmap;
 class SkWStream;
 class SkData;
@@ -42,6 +43,14 @@ struct SK_API Options {
      */
     Compression fCompression = Compression::kLossy;
     float fQuality = 100.0f;
+
+    /**
+     *  If non-null, pixels that must be converted before encoding are converted in strips of
+     *  rows concurrently on this executor, and libwebp is allowed to encode with more than one
+     *  thread. libwebp only uses threads that it creates itself, so those do not run on the
+     *  executor.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
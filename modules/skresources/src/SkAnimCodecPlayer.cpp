@@ -21,7 +21,9 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -29,7 +31,11 @@
 #include <utility>
 #include <vector>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec)
+        : SkAnimCodecPlayer(std::move(codec), Options()) {}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, const Options& options)
+        : fOptions(options), fCodec(std::move(codec)) {
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
@@ -48,10 +54,23 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
         fImages.clear();
         fImages.push_back(SkImages::DeferredFromGenerator(
                 SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        return;
+    }
+
+    if (fOptions.fMaxKeyFrames > 0) {
+        const int frameCount = SkToInt(fFrameInfos.size());
+        fKeyFrameInterval = std::max(1, (frameCount + fOptions.fMaxKeyFrames - 1) /
+                                        fOptions.fMaxKeyFrames);
+    }
+    if (fOptions.fExecutor) {
+        fDecodeAhead = std::make_unique<SkTaskGroup>(*fOptions.fExecutor);
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    // Wait for any frame being decoded ahead, which uses the codec and the decoded frames.
+    fDecodeAhead.reset();
+}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
     if (!fCodec) {
@@ -64,12 +83,87 @@ SkISize SkAnimCodecPlayer::dimensions() const {
     return { fImageInfo.width(), fImageInfo.height() };
 }
 
-sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
-    SkASSERT((unsigned)index < fFrameInfos.size());
-
+sk_sp<SkImage> SkAnimCodecPlayer::findFrame(int index) const {
     if (fImages[index]) {
         return fImages[index];
     }
+    if (fCurrent.fIndex == index) {
+        return fCurrent.fImage;
+    }
+    if (fNext.fIndex == index) {
+        return fNext.fImage;
+    }
+    return nullptr;
+}
+
+void SkAnimCodecPlayer::keepFrame(int index, const sk_sp<SkImage>& image) {
+    if (fOptions.fMaxKeyFrames <= 0) {
+        fImages[index] = image;
+        return;
+    }
+    if (index % fKeyFrameInterval != 0 || fImages[index]) {
+        return;
+    }
+    if (SkToInt(fKeyFrames.size()) == fOptions.fMaxKeyFrames) {
+        fImages[fKeyFrames.front()].reset();
+        fKeyFrames.pop_front();
+    }
+    fKeyFrames.push_back(index);
+    fImages[index] = image;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index, DecodedFrame* slot) {
+    SkASSERT((unsigned)index < fFrameInfos.size());
+
+    // Walk back through the frames this one requires to the nearest one that is decoded (or that
+    // requires no prior frame), then decode forward from there.
+    std::vector<int> chain;
+    int priorIndex = index;
+    sk_sp<SkImage> priorImage;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        if (auto image = this->findFrame(index)) {
+            *slot = {index, image};
+            return image;
+        }
+        do {
+            chain.push_back(priorIndex);
+            priorIndex = fFrameInfos[priorIndex].fRequiredFrame;
+        } while (priorIndex != SkCodec::kNoFrame && !(priorImage = this->findFrame(priorIndex)));
+    }
+
+    SkAutoMutexExclusive codecLock(fCodecMutex);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        sk_sp<SkImage> image;
+        {
+            // The other thread may have decoded this frame while this one waited for the codec.
+            SkAutoMutexExclusive lock(fMutex);
+            image = this->findFrame(*it);
+        }
+        if (!image) {
+            image = this->decodeFrame(*it, priorIndex, priorImage);
+            if (!image) {
+                return nullptr;
+            }
+        }
+
+        SkAutoMutexExclusive lock(fMutex);
+        this->keepFrame(*it, image);
+        if (*it == index) {
+            // Publish the frame before releasing the codec, so that a thread waiting for it finds
+            // this frame instead of decoding it again.
+            *slot = {index, image};
+        }
+        priorIndex = *it;
+        priorImage = std::move(image);
+    }
+    return priorImage;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index, int priorIndex,
+                                              const sk_sp<SkImage>& priorImage) {
+    SkASSERT(priorIndex == fFrameInfos[index].fRequiredFrame);
+    SkASSERT(priorIndex == SkCodec::kNoFrame || priorImage);
 
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
@@ -90,9 +184,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     if (fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType && imageInfo.isOpaque()) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
-    const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
+    if (priorImage) {
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
@@ -104,10 +196,11 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
             // kRestoreBGColor frames and Blend::kSrc.
             canvas->concat(*originMatrix.invert());
         }
-        canvas->drawImage(requiredImage, 0, 0, SkSamplingOptions(), &paint);
-        opts.fPriorFrame = requiredFrame;
+        canvas->drawImage(priorImage, 0, 0, SkSamplingOptions(), &paint);
+        opts.fPriorFrame = priorIndex;
     }
 
+    fDecodedFrameCount++;
     if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
         return nullptr;
     }
@@ -123,15 +216,25 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    return image;
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
     SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
 
-    return fTotalDuration > 0
-        ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+    if (!fTotalDuration) {
+        return fImages.front();
+    }
+
+    sk_sp<SkImage> image = this->getFrameAt(fCurrIndex, &fCurrent);
+
+    if (fDecodeAhead) {
+        const int next = (fCurrIndex + 1) % SkToInt(fFrameInfos.size());
+        fDecodeAhead->add([this, next] {
+            this->getFrameAt(next, &fNext);
+        });
+    }
+    return image;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
@@ -149,3 +252,8 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
     fCurrIndex = lower - fFrameInfos.begin();
     return fCurrIndex != prevIndex;
 }
+
+int SkAnimCodecPlayer::decodedFrameCount() const {
+    SkAutoMutexExclusive lock(fCodecMutex);
+    return fDecodedFrameCount;
+}
@@ -12,16 +12,37 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkMutex.h"
 
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <vector>
 
+class SkExecutor;
 class SkImage;
+class SkTaskGroup;
 
 class SkAnimCodecPlayer {
 public:
+    struct Options {
+        /**
+         *  If positive, at most this many key frames are kept decoded, in addition to the current
+         *  frame and the next one. Key frames are spread evenly through the animation, and a seek
+         *  only decodes the frames it requires (see SkCodec::FrameInfo::fRequiredFrame) back to
+         *  the nearest decoded one. If zero, every frame is kept once decoded.
+         */
+        int         fMaxKeyFrames = 0;
+
+        /**
+         *  If not null, the frame after the one returned by getFrame() is decoded ahead on this
+         *  executor. getFrame() only waits for that decode when it has to decode a frame itself.
+         */
+        SkExecutor* fExecutor = nullptr;
+    };
+
     explicit SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, const Options&);
     ~SkAnimCodecPlayer();
 
     /**
@@ -51,16 +72,48 @@ public:
      */
     bool seek(uint32_t msec);
 
+    /**
+     *  Returns the number of frames decoded so far, including those decoded ahead.
+     */
+    int decodedFrameCount() const;
 
 private:
+    struct DecodedFrame {
+        int            fIndex = SkCodec::kNoFrame;
+        sk_sp<SkImage> fImage;
+    };
+
+    const Options                   fOptions;
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
     int                             fCurrIndex = 0;
     uint32_t                        fTotalDuration;
 
-    sk_sp<SkImage> getFrameAt(int index);
+    // Serializes use of the codec between getFrame() and the task decoding the next frame ahead.
+    // Frames are decoded without holding fMutex, so that a frame that is already decoded can be
+    // returned while the other thread decodes. When both are needed, fCodecMutex is taken first.
+    mutable SkMutex                 fCodecMutex;
+    int                             fDecodedFrameCount = 0;
+
+    // Guards the decoded frames below, which are shared with the task decoding the next frame
+    // ahead.
+    mutable SkMutex                 fMutex;
+    // Indexed by frame. Holds every decoded frame if fOptions.fMaxKeyFrames is zero, and only
+    // the key frames in fKeyFrames otherwise.
+    std::vector<sk_sp<SkImage> >    fImages;
+    std::deque<int>                 fKeyFrames;
+    int                             fKeyFrameInterval = 1;
+    DecodedFrame                    fCurrent;
+    DecodedFrame                    fNext;
+
+    std::unique_ptr<SkTaskGroup>    fDecodeAhead;
+
+    sk_sp<SkImage> findFrame(int index) const;
+    void keepFrame(int index, const sk_sp<SkImage>&);
+    // Finds or decodes frame 'index', and stores it in 'slot' (fCurrent or fNext).
+    sk_sp<SkImage> getFrameAt(int index, DecodedFrame* slot);
+    sk_sp<SkImage> decodeFrame(int index, int priorIndex, const sk_sp<SkImage>& priorImage);
 };
 
 #endif
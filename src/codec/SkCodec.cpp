@@ -504,9 +504,13 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         return frameIndexResult;
     }
 
-    // FIXME: Support subsets somehow? Note that this works for SkWebpCodec
-    // because it supports arbitrary scaling/subset combinations.
-    if (!this->dimensionsSupported(info.dimensions())) {
+    // FIXME: Support scaled subsets somehow? Note that this works for SkWebpCodec
+    // because it supports arbitrary scaling/subset combinations. Codecs that scale
+    // subsets relative to their own size check that size when decoding.
+    const bool scaledSubset = options->fSubset && this->onSupportsScaledSubsets() &&
+                              info.width() <= options->fSubset->width() &&
+                              info.height() <= options->fSubset->height();
+    if (!scaledSubset && !this->dimensionsSupported(info.dimensions())) {
         return kInvalidScale;
     }
 
@@ -12,6 +12,7 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -20,23 +21,29 @@
 #include "include/core/SkYUVAInfo.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
+#include "src/base/SkAutoMalloc.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkJpegMetadataDecoderImpl.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegRestartStrips.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 using namespace skia_private;
 
@@ -490,6 +497,11 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (options.fExecutor && dstInfo.dimensions() == this->dimensions() &&
+        this->decodeConcurrently(dstInfo, dst, dstRowBytes, *options.fExecutor)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -567,6 +579,56 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+bool SkJpegCodec::decodeConcurrently(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                     SkExecutor& executor) {
+    SkStream* stream = this->stream();
+    if (!stream->getMemoryBase() || !stream->hasLength()) {
+        return false;
+    }
+    sk_sp<SkData> data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
+    const std::vector<SkJpegRestartStrips::Strip> strips = SkJpegRestartStrips::Split(
+            data.get(), SkJpegRestartStrips::MaxStripCount(dstInfo.height()));
+    if (strips.empty() || strips.back().fBottom != dstInfo.height()) {
+        return false;
+    }
+
+    std::atomic<bool> succeeded{true};
+    SkTaskGroup(executor).batch(SkToInt(strips.size()), [&](int i) {
+        const SkJpegRestartStrips::Strip& strip = strips[i];
+        Result result;
+        std::unique_ptr<SkCodec> codec =
+                SkJpegCodec::MakeFromStream(SkMemoryStream::Make(strip.fData), &result);
+        // Each strip has this image's header, so it has the same color profile unless this
+        // codec was given a default one.
+        if (!codec || codec->dimensions().width() != dstInfo.width() ||
+            !codec->getICCProfile() != !this->getICCProfile()) {
+            succeeded = false;
+            return;
+        }
+
+        const SkImageInfo info = dstInfo.makeDimensions(codec->dimensions());
+        if (kSuccess != codec->startScanlineDecode(info)) {
+            succeeded = false;
+            return;
+        }
+        // The rows above fTop are only decoded so that the chroma of the rows below them is
+        // upsampled exactly as in a serial decode.
+        SkAutoMalloc contextRow(info.minRowBytes());
+        for (int y = strip.fDecodeTop; y < strip.fTop; ++y) {
+            if (1 != codec->getScanlines(contextRow.get(), 1, info.minRowBytes())) {
+                succeeded = false;
+                return;
+            }
+        }
+        const int rows = strip.fBottom - strip.fTop;
+        if (rows != codec->getScanlines(SkTAddOffset<void>(dst, strip.fTop * rowBytes), rows,
+                                        rowBytes)) {
+            succeeded = false;
+        }
+    });
+    return succeeded;
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
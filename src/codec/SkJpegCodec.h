@@ -23,6 +23,7 @@
 #include <memory>
 
 class JpegDecoderMgr;
+class SkExecutor;
 class SkSampler;
 class SkStream;
 class SkSwizzler;
@@ -133,6 +134,14 @@ private:
     Result readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                   const Options&, int* rowsDecoded);
 
+    /*
+     * Decodes strips of a baseline image that has restart markers concurrently, each with its
+     * own decoder. Returns false if the image can't be split, or if any strip fails, in which
+     * case the caller should decode the image serially.
+     */
+    bool decodeConcurrently(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                            SkExecutor& executor);
+
     /*
      * Scanline decoding.
      */
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkJpegRestartStrips.h"
+
+#include "src/codec/SkJpegConstants.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace SkJpegRestartStrips {
+namespace {
+
+// The markers that may appear in the header of a JPEG that can be split. See section B.1.1.3,
+// Marker assignments.
+constexpr uint8_t kJpegMarkerStartOfFrameBaseline = 0xC0;
+constexpr uint8_t kJpegMarkerStartOfFrameExtended = 0xC1;
+constexpr uint8_t kJpegMarkerDefineHuffmanTables = 0xC4;
+constexpr uint8_t kJpegMarkerDefineQuantizationTables = 0xDB;
+constexpr uint8_t kJpegMarkerDefineRestartInterval = 0xDD;
+constexpr uint8_t kJpegMarkerAPP15 = 0xEF;
+constexpr uint8_t kJpegMarkerComment = 0xFE;
+
+// The restart markers are RST0 through RST7, used in turn.
+constexpr uint8_t kJpegMarkerRestart0 = 0xD0;
+constexpr uint8_t kJpegMarkerRestart7 = 0xD7;
+
+uint16_t read_u16(const uint8_t* data) { return (data[0] << 8) | data[1]; }
+
+struct Header {
+    // The size of the header, through the end of the StartOfScan segment.
+    size_t fSize = 0;
+    // The offset of the image height in the StartOfFrame segment.
+    size_t fHeightOffset = 0;
+    int    fWidth = 0;
+    int    fHeight = 0;
+    // The size in pixels of each MCU.
+    int    fMcuWidth = 0;
+    int    fMcuHeight = 0;
+    // The number of MCUs in each restart interval.
+    int    fRestartInterval = 0;
+};
+
+bool parse_header(const uint8_t* data, size_t size, Header* header) {
+    if (size < sizeof(kJpegSig) || memcmp(data, kJpegSig, sizeof(kJpegSig))) {
+        return false;
+    }
+
+    int componentCount = 0;
+    int maxH = 0, maxV = 0;
+    size_t offset = kJpegMarkerCodeSize;
+    while (true) {
+        // Skip any fill bytes before the marker.
+        while (offset + 1 < size && data[offset] == 0xFF && data[offset + 1] == 0xFF) {
+            offset++;
+        }
+        if (offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize > size ||
+            data[offset] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        const size_t length = read_u16(data + offset + kJpegMarkerCodeSize);
+        if (length < kJpegSegmentParameterLengthSize ||
+            offset + kJpegMarkerCodeSize + length > size) {
+            return false;
+        }
+        const uint8_t* params = data + offset + kJpegMarkerCodeSize +
+                                kJpegSegmentParameterLengthSize;
+        const size_t paramsSize = length - kJpegSegmentParameterLengthSize;
+
+        switch (marker) {
+            case kJpegMarkerStartOfFrameBaseline:
+            case kJpegMarkerStartOfFrameExtended: {
+                // Only 8 bit Huffman coded frames, which are the ones Skia decodes.
+                if (componentCount || paramsSize < 6 || params[0] != 8) {
+                    return false;
+                }
+                componentCount = params[5];
+                if (componentCount == 0 || paramsSize != 6 + 3u * componentCount) {
+                    return false;
+                }
+                header->fHeightOffset = params + 1 - data;
+                header->fHeight = read_u16(params + 1);
+                header->fWidth = read_u16(params + 3);
+                for (int i = 0; i < componentCount; ++i) {
+                    const uint8_t sampling = params[6 + 3 * i + 1];
+                    maxH = std::max(maxH, sampling >> 4);
+                    maxV = std::max(maxV, sampling & 0xF);
+                }
+                break;
+            }
+            case kJpegMarkerDefineRestartInterval:
+                if (paramsSize != 2) {
+                    return false;
+                }
+                header->fRestartInterval = read_u16(params);
+                break;
+            case kJpegMarkerStartOfScan:
+                // A single scan of all of the components. Images that are decoded in several
+                // scans could only be split within each scan.
+                if (!componentCount || paramsSize < 1 || params[0] != componentCount) {
+                    return false;
+                }
+                header->fSize = offset + kJpegMarkerCodeSize + length;
+                if (header->fWidth == 0 || header->fHeight == 0 ||
+                    header->fRestartInterval == 0 || maxH == 0 || maxV == 0) {
+                    return false;
+                }
+                // See section A.2: an MCU of a scan with a single component is one block.
+                header->fMcuWidth = componentCount == 1 ? 8 : 8 * maxH;
+                header->fMcuHeight = componentCount == 1 ? 8 : 8 * maxV;
+                return true;
+            case kJpegMarkerDefineHuffmanTables:
+            case kJpegMarkerDefineQuantizationTables:
+            case kJpegMarkerComment:
+                break;
+            default:
+                // Application segments hold metadata. Any other marker means the image is
+                // progressive, arithmetic coded or otherwise unusual.
+                if (marker < kJpegMarkerAPP0 || marker > kJpegMarkerAPP15) {
+                    return false;
+                }
+                break;
+        }
+        offset += kJpegMarkerCodeSize + length;
+    }
+}
+
+// Finds the restart markers in the entropy-coded data, which runs from the end of the header to
+// the EndOfImage marker. Returns false if the data is truncated or contains any other marker.
+bool find_restart_markers(const uint8_t* data, size_t size, size_t offset,
+                          std::vector<size_t>* restarts, size_t* endOfImage) {
+    while (offset < size) {
+        const void* sentinel = memchr(data + offset, 0xFF, size - offset);
+        if (!sentinel) {
+            return false;
+        }
+        offset = static_cast<const uint8_t*>(sentinel) - data;
+        if (offset + 1 >= size) {
+            return false;
+        }
+        const uint8_t next = data[offset + 1];
+        if (next == 0x00) {
+            // A stuffed 0xFF in the entropy-coded data.
+            offset += 2;
+        } else if (next == 0xFF) {
+            // A fill byte before a marker.
+            offset += 1;
+        } else if (next >= kJpegMarkerRestart0 && next <= kJpegMarkerRestart7) {
+            restarts->push_back(offset);
+            offset += kJpegMarkerCodeSize;
+        } else if (next == kJpegMarkerEndOfImage) {
+            *endOfImage = offset;
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+int MaxStripCount(int height) {
+    static constexpr int kMaxStrips = 16;
+    static constexpr int kMinStripRows = 64;
+    return std::min(kMaxStrips, height / kMinStripRows);
+}
+
+std::vector<Strip> Split(const SkData* jpeg, int maxStripCount) {
+    if (!jpeg || maxStripCount < 2) {
+        return {};
+    }
+    const uint8_t* data = jpeg->bytes();
+    const size_t size = jpeg->size();
+
+    Header header;
+    if (!parse_header(data, size, &header)) {
+        return {};
+    }
+    std::vector<size_t> restarts;
+    size_t endOfImage = 0;
+    if (!find_restart_markers(data, size, header.fSize, &restarts, &endOfImage)) {
+        return {};
+    }
+
+    const int64_t mcusPerRow = (header.fWidth + header.fMcuWidth - 1) / header.fMcuWidth;
+    const int64_t mcuRows = (header.fHeight + header.fMcuHeight - 1) / header.fMcuHeight;
+    const int64_t intervalCount =
+            (mcusPerRow * mcuRows + header.fRestartInterval - 1) / header.fRestartInterval;
+    if (restarts.size() + 1 != (size_t)intervalCount) {
+        return {};
+    }
+    auto intervalBegin = [&](int64_t k) {
+        return k == 0 ? header.fSize : restarts[k - 1] + kJpegMarkerCodeSize;
+    };
+    auto intervalEnd = [&](int64_t k) {
+        return k == intervalCount - 1 ? endOfImage : restarts[k];
+    };
+
+    // The places a strip may begin: the restart intervals that begin a row of MCUs. The last entry
+    // marks the end of the image.
+    struct Boundary {
+        int64_t fMcuRow;
+        int64_t fInterval;
+    };
+    std::vector<Boundary> boundaries;
+    for (int64_t k = 0; k < intervalCount; ++k) {
+        const int64_t firstMcu = k * header.fRestartInterval;
+        if (firstMcu % mcusPerRow == 0) {
+            boundaries.push_back({firstMcu / mcusPerRow, k});
+        }
+    }
+    boundaries.push_back({mcuRows, intervalCount});
+
+    // Choose the boundaries closest to dividing the rows evenly.
+    std::vector<size_t> chosen = {0};
+    for (int i = 1; i < maxStripCount; ++i) {
+        const int64_t target = i * mcuRows / maxStripCount;
+        size_t b = chosen.back() + 1;
+        while (b + 1 < boundaries.size() && boundaries[b].fMcuRow < target) {
+            b++;
+        }
+        if (b + 1 < boundaries.size()) {
+            chosen.push_back(b);
+        }
+    }
+    chosen.push_back(boundaries.size() - 1);
+    if (chosen.size() < 3) {
+        return {};
+    }
+
+    auto rowAt = [&](size_t b) {
+        return (int)std::min<int64_t>(boundaries[b].fMcuRow * header.fMcuHeight, header.fHeight);
+    };
+    std::vector<Strip> strips(chosen.size() - 1);
+    for (size_t i = 0; i < strips.size(); ++i) {
+        const size_t top = chosen[i];
+        const size_t bottom = chosen[i + 1];
+        const size_t decodeTop = top > 0 ? top - 1 : top;
+        const size_t decodeBottom = bottom + 1 < boundaries.size() ? bottom + 1 : bottom;
+
+        const int64_t firstInterval = boundaries[decodeTop].fInterval;
+        const int64_t lastInterval = boundaries[decodeBottom].fInterval - 1;
+        const size_t entropyBegin = intervalBegin(firstInterval);
+        const size_t entropySize = intervalEnd(lastInterval) - entropyBegin;
+
+        sk_sp<SkData> stripData = SkData::MakeUninitialized(
+                header.fSize + entropySize + kJpegMarkerCodeSize);
+        uint8_t* dst = static_cast<uint8_t*>(stripData->writable_data());
+        memcpy(dst, data, header.fSize);
+        const int height = rowAt(decodeBottom) - rowAt(decodeTop);
+        dst[header.fHeightOffset] = height >> 8;
+        dst[header.fHeightOffset + 1] = height & 0xFF;
+
+        memcpy(dst + header.fSize, data + entropyBegin, entropySize);
+        for (int64_t k = firstInterval; k < lastInterval; ++k) {
+            const size_t marker = header.fSize + restarts[k] - entropyBegin + 1;
+            dst[marker] = kJpegMarkerRestart0 + ((k - firstInterval) & 7);
+        }
+        dst[header.fSize + entropySize] = 0xFF;
+        dst[header.fSize + entropySize + 1] = kJpegMarkerEndOfImage;
+
+        strips[i].fData = std::move(stripData);
+        strips[i].fDecodeTop = rowAt(decodeTop);
+        strips[i].fTop = rowAt(top);
+        strips[i].fBottom = rowAt(bottom);
+    }
+    return strips;
+}
+
+}  // namespace SkJpegRestartStrips
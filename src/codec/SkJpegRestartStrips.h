@@ -0,0 +1,58 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegRestartStrips_codec_DEFINED
+#define SkJpegRestartStrips_codec_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+
+#include <vector>
+
+/*
+ * Splits a baseline JPEG whose restart intervals begin at the start of rows of MCUs into strips
+ * that can be decoded independently, and so concurrently.
+ *
+ * Each strip is rewritten as a complete JPEG: the original header with the height in the frame
+ * header reduced, the entropy-coded data of the restart intervals the strip needs with its
+ * restart markers renumbered, and an EndOfImage marker. The DC predictions are reset at every
+ * restart marker, so no state is carried between strips.
+ *
+ * Upsampling chroma uses the neighbouring rows, so a strip also decodes one group of restart
+ * intervals above and below the rows it is responsible for (where the image has them). This makes
+ * its rows identical to those of a serial decode.
+ */
+namespace SkJpegRestartStrips {
+
+struct Strip {
+    // A complete JPEG whose first row is row fDecodeTop of the image.
+    sk_sp<SkData> fData;
+    int           fDecodeTop = 0;
+
+    // The rows of the image that this strip provides, [fTop, fBottom). Rows of fData before fTop
+    // are only decoded to provide context.
+    int           fTop = 0;
+    int           fBottom = 0;
+};
+
+/*
+ * Returns the most strips that a concurrent decode splits an image of 'height' rows into: at most
+ * 16, each of at least 64 rows. Fewer than two means the image should be decoded serially.
+ */
+int MaxStripCount(int height);
+
+/*
+ * Returns at most maxStripCount strips that together cover every row of the image, in order, or an
+ * empty vector if the image can't be split into at least two of them. Images that are progressive,
+ * arithmetic coded, have more than one scan, are missing restart markers or are truncated are not
+ * split.
+ */
+std::vector<Strip> Split(const SkData* jpeg, int maxStripCount);
+
+}  // namespace SkJpegRestartStrips
+
+#endif
@@ -15,6 +15,7 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/core/SkColorData.h"
 #include "src/core/SkMasks.h"
+#include "src/core/SkSwizzlePriv.h"
 
 static void swizzle_mask16_to_rgba_opaque(
         void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
@@ -386,6 +387,56 @@ static void swizzle_mask32_to_565(
     }
 }
 
+// The fast procs extract the channels of many pixels at once with SkOpts. They do not support
+// sampling, which is already fast because it skips pixels.
+
+static void get_n32_channels(const SkMasks* masks, bool swapRB, SkMasks::MaskInfo channels[4]) {
+    channels[0] = swapRB ? masks->blueInfo() : masks->redInfo();
+    channels[1] = masks->greenInfo();
+    channels[2] = swapRB ? masks->redInfo() : masks->blueInfo();
+    channels[3] = masks->alphaInfo();
+}
+
+template <bool kSwapRB, SkAlphaType kAlphaType>
+static void fast_swizzle_mask16_to_n32(
+        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
+        uint32_t startX, uint32_t sampleX) {
+    SkASSERT(1 == sampleX);
+
+    SkMasks::MaskInfo channels[4];
+    get_n32_channels(masks, kSwapRB, channels);
+    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
+    uint32_t* dstPtr = (uint32_t*) dstRow;
+    if (kOpaque_SkAlphaType == kAlphaType) {
+        SkOpts::masked16_to_RGB1(dstPtr, srcPtr, width, channels);
+    } else {
+        SkOpts::masked16_to_RGBA(dstPtr, srcPtr, width, channels);
+    }
+    if (kPremul_SkAlphaType == kAlphaType) {
+        SkOpts::RGBA_to_rgbA(dstPtr, dstPtr, width);
+    }
+}
+
+template <bool kSwapRB, SkAlphaType kAlphaType>
+static void fast_swizzle_mask32_to_n32(
+        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
+        uint32_t startX, uint32_t sampleX) {
+    SkASSERT(1 == sampleX);
+
+    SkMasks::MaskInfo channels[4];
+    get_n32_channels(masks, kSwapRB, channels);
+    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
+    uint32_t* dstPtr = (uint32_t*) dstRow;
+    if (kOpaque_SkAlphaType == kAlphaType) {
+        SkOpts::masked32_to_RGB1(dstPtr, srcPtr, width, channels);
+    } else {
+        SkOpts::masked32_to_RGBA(dstPtr, srcPtr, width, channels);
+    }
+    if (kPremul_SkAlphaType == kAlphaType) {
+        SkOpts::RGBA_to_rgbA(dstPtr, dstPtr, width);
+    }
+}
+
 /*
  *
  * Create a new mask swizzler
@@ -396,6 +447,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
         const SkCodec::Options& options) {
 
     // Choose the appropriate row procedure
+    RowProc fastProc = nullptr;
     RowProc proc = nullptr;
     switch (bitsPerPixel) {
         case 16:
@@ -403,13 +455,17 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask16_to_rgba_opaque;
+                        fastProc = &fast_swizzle_mask16_to_n32<false, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_rgba_unpremul;
+                                fastProc = &fast_swizzle_mask16_to_n32<false,
+                                                                       kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_rgba_premul;
+                                fastProc = &fast_swizzle_mask16_to_n32<false, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -419,13 +475,16 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask16_to_bgra_opaque;
+                        fastProc = &fast_swizzle_mask16_to_n32<true, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_bgra_unpremul;
+                                fastProc = &fast_swizzle_mask16_to_n32<true, kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_bgra_premul;
+                                fastProc = &fast_swizzle_mask16_to_n32<true, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -485,13 +544,17 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask32_to_rgba_opaque;
+                        fastProc = &fast_swizzle_mask32_to_n32<false, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_rgba_unpremul;
+                                fastProc = &fast_swizzle_mask32_to_n32<false,
+                                                                       kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_rgba_premul;
+                                fastProc = &fast_swizzle_mask32_to_n32<false, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -501,13 +564,16 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask32_to_bgra_opaque;
+                        fastProc = &fast_swizzle_mask32_to_n32<true, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_bgra_unpremul;
+                                fastProc = &fast_swizzle_mask32_to_n32<true, kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_bgra_premul;
+                                fastProc = &fast_swizzle_mask32_to_n32<true, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -533,7 +599,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
         srcWidth = options.fSubset->width();
     }
 
-    return new SkMaskSwizzler(masks, proc, srcOffset, srcWidth);
+    return new SkMaskSwizzler(masks, fastProc, proc, srcOffset, srcWidth);
 }
 
 /*
@@ -541,9 +607,12 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
  * Constructor for mask swizzler
  *
  */
-SkMaskSwizzler::SkMaskSwizzler(SkMasks* masks, RowProc proc, int srcOffset, int subsetWidth)
+SkMaskSwizzler::SkMaskSwizzler(SkMasks* masks, RowProc fastProc, RowProc proc, int srcOffset,
+                               int subsetWidth)
     : fMasks(masks)
-    , fRowProc(proc)
+    , fFastProc(fastProc)
+    , fSlowProc(proc)
+    , fActualProc(fFastProc ? fFastProc : fSlowProc)
     , fSubsetWidth(subsetWidth)
     , fDstWidth(subsetWidth)
     , fSampleX(1)
@@ -561,6 +630,8 @@ int SkMaskSwizzler::onSetSampleX(int sampleX) {
 
     // check that fX0 is valid
     SkASSERT(fX0 >= 0);
+
+    fActualProc = (1 == fSampleX && fFastProc) ? fFastProc : fSlowProc;
     return fDstWidth;
 }
 
@@ -571,5 +642,5 @@ int SkMaskSwizzler::onSetSampleX(int sampleX) {
  */
 void SkMaskSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
-    fRowProc(dst, src, fDstWidth, fMasks, fX0, fSampleX);
+    fActualProc(dst, src, fDstWidth, fMasks, fX0, fSampleX);
 }
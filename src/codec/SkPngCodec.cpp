@@ -26,6 +26,7 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkPngCompositeChunkReader.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/codec/SkSampler.h"
 #include "src/codec/SkSwizzler.h"
 
 #include <csetjmp>
@@ -543,6 +544,8 @@ public:
             , fFirstRow(0)
             , fLastRow(0)
             , fLinesDecoded(0)
+            , fSampleY(1)
+            , fBufferedRows(0)
             , fInterlacedComplete(false)
             , fPng_rowbytes(0) {}
 
@@ -558,6 +561,11 @@ private:
     void*                   fDst;
     size_t                  fRowBytes;
     int                     fLinesDecoded;
+
+    // Only every fSampleY'th row of the range, starting at
+    // SkCodecPriv::GetStartCoord(fSampleY), is kept in fInterlaceBuffer.
+    int                     fSampleY;
+    int                     fBufferedRows;
     bool                    fInterlacedComplete;
     size_t                  fPng_rowbytes;
     std::unique_ptr<png_byte, SkOverloadedFunctionObject<void(void*), sk_free>> fInterlaceBuffer;
@@ -571,8 +579,11 @@ private:
             return;
         }
 
-        png_bytep oldRow = fInterlaceBuffer.get() + (rowNum - fFirstRow) * fPng_rowbytes;
-        png_progressive_combine_row(this->png_ptr(), oldRow, row);
+        const int offset = rowNum - fFirstRow - SkCodecPriv::GetStartCoord(fSampleY);
+        if (offset >= 0 && offset % fSampleY == 0 && offset / fSampleY < fBufferedRows) {
+            png_bytep oldRow = fInterlaceBuffer.get() + (offset / fSampleY) * fPng_rowbytes;
+            png_progressive_combine_row(this->png_ptr(), oldRow, row);
+        }
 
         if (0 == pass) {
             // The first pass initializes all rows.
@@ -598,6 +609,8 @@ private:
 
     Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) override {
         const int height = this->dimensions().height();
+        fSampleY = 1;
+        fBufferedRows = height;
         Result res = this->setUpInterlaceBuffer(height);
         if (res != kSuccess) {
           return res;
@@ -629,11 +642,10 @@ private:
     }
 
     Result setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
-        // FIXME: We could skip rows in the interlace buffer that we won't put in the output.
-        Result res = this->setUpInterlaceBuffer(lastRow - firstRow + 1);
-        if (res != kSuccess) {
-          return res;
-        }
+        // The interlace buffer is allocated by the first call to decode(), since the
+        // sample size may not be known yet.
+        fInterlaceBuffer.reset();
+        fBufferedRows = 0;
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, InterlacedRowCallback, nullptr);
         fFirstRow = firstRow;
         fLastRow = lastRow;
@@ -644,6 +656,18 @@ private:
     }
 
     Result decode(int* rowsDecoded) override {
+        if (!fBufferedRows) {
+            // Only buffer the rows that will be written to the output, so that a sampled
+            // decode of an interlaced image doesn't need a full size buffer.
+            fSampleY = this->swizzler() ? this->swizzler()->sampleY() : 1;
+            fBufferedRows = SkCodecPriv::GetSampledDimension(fLastRow - fFirstRow + 1, fSampleY);
+            Result res = this->setUpInterlaceBuffer(fBufferedRows);
+            if (res != kSuccess) {
+                fBufferedRows = 0;
+                return res;
+            }
+        }
+
         const bool success = this->processData();
 
         // Now apply Xforms on all the rows that were decoded.
@@ -654,24 +678,22 @@ private:
             return log_and_return_error(success);
         }
 
-        const int sampleY = this->swizzler() ? this->swizzler()->sampleY() : 1;
-        const int rowsNeeded = SkCodecPriv::GetSampledDimension(fLastRow - fFirstRow + 1, sampleY);
-
         // FIXME: For resuming interlace, we may swizzle a row that hasn't changed. But it
         // may be too tricky/expensive to handle that correctly.
 
-        // Offset srcRow by SkCodecPriv::GetStartCoord rows. We do not need to account for
-        // fFirstRow, since the first row in fInterlaceBuffer corresponds to fFirstRow.
-        int srcRow = SkCodecPriv::GetStartCoord(sampleY);
+        // Buffered row i holds row GetStartCoord(fSampleY) + i * fSampleY of the range, which
+        // has been initialized once the first pass has reached it.
+        int srcRow = SkCodecPriv::GetStartCoord(fSampleY);
         void* dst = fDst;
         int rowsWrittenToOutput = 0;
-        while (rowsWrittenToOutput < rowsNeeded && srcRow < fLinesDecoded) {
-            png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * srcRow);
+        while (rowsWrittenToOutput < fBufferedRows && srcRow < fLinesDecoded) {
+            png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(),
+                                                   fPng_rowbytes * rowsWrittenToOutput);
             this->applyXformRow(dst, src);
             dst = SkTAddOffset<void>(dst, fRowBytes);
 
             rowsWrittenToOutput++;
-            srcRow += sampleY;
+            srcRow += fSampleY;
         }
 
         if (success && fInterlacedComplete) {
@@ -1001,24 +1023,95 @@ bool SkPngCodec::onRewind() {
     return true;
 }
 
+// Finds the sample sizes that reduce `src` to exactly `dst`, computed the same way as
+// SkSampledCodec computes them.
+static bool get_sample_sizes(const SkISize& src, const SkISize& dst, int* sampleX, int* sampleY) {
+    if (dst.isEmpty() || dst.width() > src.width() || dst.height() > src.height()) {
+        return false;
+    }
+    *sampleX = src.width() / dst.width();
+    *sampleY = src.height() / dst.height();
+    return SkCodecPriv::GetSampledDimension(src.width(), *sampleX) == dst.width() &&
+           SkCodecPriv::GetSampledDimension(src.height(), *sampleY) == dst.height();
+}
+
+SkISize SkPngCodec::onGetScaledDimensions(float desiredScale) const {
+    // Pick the largest sample size whose scale is no smaller than desiredScale.
+    const SkISize dims = this->dimensions();
+    const float maxSampleSize = std::max(dims.width(), dims.height());
+    const int sampleSize = std::max(1, (int)std::min(1.0f / desiredScale, maxSampleSize));
+    return {SkCodecPriv::GetSampledDimension(dims.width(), sampleSize),
+            SkCodecPriv::GetSampledDimension(dims.height(), sampleSize)};
+}
+
+bool SkPngCodec::onDimensionsSupported(const SkISize& dims) {
+    int sampleX, sampleY;
+    return get_sample_sizes(this->dimensions(), dims, &sampleX, &sampleY);
+}
+
+bool SkPngCodec::onGetValidSubset(SkIRect* desiredSubset) const {
+    return desiredSubset && !desiredSubset->isEmpty() &&
+           this->bounds().contains(*desiredSubset);
+}
+
 SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
                                         size_t rowBytes, const Options& options,
                                         int* rowsDecoded) {
-    Result result = this->initializeXforms(dstInfo, options);
+    const SkIRect region = options.fSubset ? *options.fSubset : this->bounds();
+    int sampleX, sampleY;
+    if (!get_sample_sizes(region.size(), dstInfo.dimensions(), &sampleX, &sampleY)) {
+        return kInvalidScale;
+    }
+    const bool sampled = sampleX > 1 || sampleY > 1;
+
+    if (!options.fSubset && !sampled) {
+        Result result = this->initializeXforms(dstInfo, options);
+        if (kSuccess != result) {
+            return result;
+        }
+
+        this->initializeXformParams();
+        return this->decodeAllRows(dst, rowBytes, rowsDecoded);
+    }
+
+    // Decode a subset or a smaller image in a single pass, without a full-size intermediate.
+    // Like an incremental decode, this only converts the rows and columns that are needed, and
+    // stops reading once the last row that is needed has been decoded. As in
+    // SkSampledCodec::sampledDecode(), the swizzler is set up for the full width and then told
+    // which columns to skip.
+    const SkImageInfo fullInfo = dstInfo.makeDimensions(this->dimensions());
+    Result result = this->initializeXforms(fullInfo, options);
     if (kSuccess != result) {
         return result;
     }
 
-    if (options.fSubset) {
-        return kUnimplemented;
+    if (sampled) {
+        SkSampler* sampler = this->makeSampler(fullInfo, options);
+        if (!sampler) {
+            return kUnimplemented;
+        }
+        if (sampler->setSampleX(sampleX) != dstInfo.width()) {
+            return kInvalidScale;
+        }
+        sampler->setSampleY(sampleY);
+    }
+
+    result = this->setRange(region.top(), region.bottom() - 1, dst, rowBytes);
+    if (kSuccess != result) {
+        return result;
     }
 
     this->initializeXformParams();
-    return this->decodeAllRows(dst, rowBytes, rowsDecoded);
+    return this->decode(rowsDecoded);
 }
 
 SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
         void* dst, size_t rowBytes, const SkCodec::Options& options) {
+    // Incremental decodes are scaled by SkSampledCodec, which samples a full size decode.
+    if (dstInfo.dimensions() != this->dimensions()) {
+        return kInvalidScale;
+    }
+
     Result result = this->initializeXforms(dstInfo, options);
     if (kSuccess != result) {
         return result;
@@ -22,6 +22,8 @@ class SkPngChunkReader;
 class SkPngCompositeChunkReader;
 class SkStream;
 struct SkEncodedInfo;
+struct SkIRect;
+struct SkISize;
 struct SkImageInfo;
 
 class SkPngCodec : public SkPngCodecBase {
@@ -67,6 +69,13 @@ protected:
             override;
     bool onRewind() override;
 
+    // Scaled decodes sample rows and columns with the swizzler as they are decoded, so
+    // the supported sizes are the ones SkSampledCodec can produce from the full image.
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+    bool onDimensionsSupported(const SkISize&) override;
+    bool onGetValidSubset(SkIRect* desiredSubset) const override;
+    bool onSupportsScaledSubsets() const override { return true; }
+
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
 
@@ -251,12 +251,18 @@ SkSampler* SkPngCodecBase::getSampler(bool createIfNecessary) {
     if (fSwizzler || !createIfNecessary) {
         return fSwizzler.get();
     }
+    return this->makeSampler(this->dstInfo(), this->options());
+}
+
+SkSampler* SkPngCodecBase::makeSampler(const SkImageInfo& dstInfo, const Options& options) {
+    if (fSwizzler) {
+        return fSwizzler.get();
+    }
 
     // Ok to ignore `initializeSwizzler`'s result, because if it fails, then
     // `fSwizzler` will be `nullptr` and we want to return `nullptr` upon
     // failure.
-    std::ignore = this->initializeSwizzler(
-            this->dstInfo(), this->options(), true, this->dstInfo().width());
+    std::ignore = this->initializeSwizzler(dstInfo, options, true, dstInfo.width());
 
     return fSwizzler.get();
 }
@@ -50,6 +50,11 @@ protected:
     // Needs to be called *after* (i.e. outside of) `onStartIncrementalDecode`.
     void initializeXformParams();
 
+    // Like `getSampler(true)`, but creates the swizzler for `dstInfo` and
+    // `options` rather than for the codec's current `dstInfo()`. This lets
+    // `onGetPixels` sample a full-size `dstInfo` into a smaller destination.
+    SkSampler* makeSampler(const SkImageInfo& dstInfo, const Options& options);
+
     // Transforms a decoded row into the `dstInfo` format that was earlier
     // passed to `initializeXforms`.
     //
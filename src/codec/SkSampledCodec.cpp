@@ -90,9 +90,22 @@ SkCodec::Result SkSampledCodec::onGetAndroidPixels(const SkImageInfo& info, void
 
     // We are performing a subset decode.
     int sampleSize = options.fSampleSize;
+    if (sampleSize > 1 && this->codec()->onSupportsScaledSubsets()) {
+        // The codec samples the subset while decoding it, in a single pass.
+        const SkCodec::Result result = this->codec()->getPixels(info, pixels, rowBytes, &options);
+        if (result != SkCodec::kUnimplemented && result != SkCodec::kInvalidScale) {
+            return result;
+        }
+    }
     SkISize scaledSize = this->getSampledDimensions(sampleSize);
-    if (!this->codec()->dimensionsSupported(scaledSize)) {
-        // If the native codec does not support the requested scale, scale by sampling.
+    int remainingSampleSize = sampleSize;
+    if (sampleSize > 1) {
+        this->accountForNativeScaling(&remainingSampleSize);
+    }
+    if (remainingSampleSize != 1 || !this->codec()->dimensionsSupported(scaledSize)) {
+        // If the native codec does not support the requested scale, scale by sampling. Codecs
+        // whose getPixels() samples, rather than scaling as it decodes, only support the scale
+        // for the whole image, so they are sampled here too.
         return this->sampledDecode(info, pixels, rowBytes, options);
     }
 
@@ -17,7 +17,9 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkMath.h"
 #include "include/private/base/SkTDArray.h"
+#include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkColorData.h"
 #include "src/core/SkMask.h"
@@ -282,6 +284,8 @@ public:
 private:
     using AlphaProc = U8CPU (*)(U8CPU alphaA, U8CPU alphaB);
     void operateX(int lastY, RowIter& iterA, RowIter& iterB, AlphaProc proc);
+    void operateXScanline(int lastY, const uint8_t* rowA, const SkIRect& boundsA,
+                          const uint8_t* rowB, const SkIRect& boundsB, SkClipOp op);
     void operateY(const SkAAClip& A, const SkAAClip& B, SkClipOp op);
 
     void addRun(int x, int y, U8CPU alpha, int count) {
@@ -601,6 +605,88 @@ void SkAAClip::Builder::operateX(int lastY, RowIter& iterA, RowIter& iterB, Alph
     }
 }
 
+// Rows whose runs average fewer than this many pixels are combined by expanding both rows to
+// scanlines, rather than by walking their runs.
+static constexpr int kMinAverageRunForRunWalk = 8;
+
+// Returns the number of runs needed to cover width pixels of row.
+static int count_runs(const uint8_t* row, int width) {
+    int runs = 0;
+    while (width > 0) {
+        width -= row[0];
+        row += 2;
+        runs += 1;
+    }
+    return runs;
+}
+
+// Writes the alpha of each pixel of row (which covers [rowLeft, rowRight)) that falls within
+// [left, left + width) to dst, and 0 for the pixels outside of the row.
+static void expand_row(uint8_t dst[], int left, int width,
+                       const uint8_t* row, int rowLeft, int rowRight) {
+    const int right = left + width;
+    int x = left;
+    if (rowLeft > x) {
+        int n = std::min(rowLeft, right) - x;
+        memset(dst, 0, n);
+        x += n;
+    }
+    for (int runLeft = rowLeft; x < right && runLeft < rowRight; row += 2) {
+        int runRight = runLeft + row[0];
+        if (runRight > x) {
+            int n = std::min(runRight, right) - x;
+            memset(dst + (x - left), row[1], n);
+            x += n;
+        }
+        runLeft = runRight;
+    }
+    if (x < right) {
+        memset(dst + (x - left), 0, right - x);
+    }
+}
+
+void SkAAClip::Builder::operateXScanline(int lastY, const uint8_t* rowA, const SkIRect& boundsA,
+                                         const uint8_t* rowB, const SkIRect& boundsB,
+                                         SkClipOp op) {
+    using U8 = skvx::Vec<16, uint8_t>;
+
+    const int left = fBounds.fLeft,
+              width = fBounds.width();
+    skia_private::AutoSTMalloc<512, uint8_t> storage(2 * width);
+    uint8_t* a = storage.get();
+    uint8_t* b = a + width;
+    expand_row(a, left, width, rowA, boundsA.fLeft, boundsA.fRight);
+    expand_row(b, left, width, rowB, boundsB.fLeft, boundsB.fRight);
+
+    // Combine the scanlines in place, with the same rounding as SkMulDiv255Round().
+    const bool difference = op == SkClipOp::kDifference;
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        U8 vb = U8::Load(b + x);
+        if (difference) {
+            vb = 0xFF - vb;
+        }
+        skvx::div255(skvx::cast<uint16_t>(U8::Load(a + x)) * skvx::cast<uint16_t>(vb)).store(a + x);
+    }
+    for (; x < width; ++x) {
+        a[x] = SkMulDiv255Round(a[x], difference ? 0xFF - b[x] : b[x]);
+    }
+
+    // Re-encode the scanline as runs, skipping 16 equal pixels at a time where we can.
+    for (x = 0; x < width;) {
+        const uint8_t alpha = a[x];
+        int end = x + 1;
+        while (end + 16 <= width && all(U8::Load(a + end) == alpha)) {
+            end += 16;
+        }
+        while (end < width && a[end] == alpha) {
+            end += 1;
+        }
+        this->addRun(left + x, lastY, alpha, end - x);
+        x = end;
+    }
+}
+
 void SkAAClip::Builder::operateY(const SkAAClip& A, const SkAAClip& B, SkClipOp op) {
     static const AlphaProc kDiff = [](U8CPU a, U8CPU b) { return SkMulDiv255Round(a, 0xFF - b); };
     static const AlphaProc kIntersect = [](U8CPU a, U8CPU b) { return SkMulDiv255Round(a, b); };
@@ -673,9 +759,18 @@ void SkAAClip::Builder::operateY(const SkAAClip& A, const SkAAClip& B, SkClipOp
             this->addRun(fBounds.fLeft, bot - 1, 0, fBounds.width());
         } else if (top >= fBounds.fTop) {
             SkASSERT(bot <= fBounds.fBottom);
-            RowIter rowIterA(rowA, rowA ? A.getBounds() : fBounds);
-            RowIter rowIterB(rowB, rowB ? B.getBounds() : fBounds);
-            this->operateX(bot - 1, rowIterA, rowIterB, proc);
+            // Rows broken into many short runs (e.g. from a complex AA path) are cheaper to combine
+            // a scanline at a time than by stepping through both sets of runs.
+            if (rowA && rowB &&
+                kMinAverageRunForRunWalk * (count_runs(rowA, A.getBounds().width()) +
+                                            count_runs(rowB, B.getBounds().width())) >
+                        fBounds.width()) {
+                this->operateXScanline(bot - 1, rowA, A.getBounds(), rowB, B.getBounds(), op);
+            } else {
+                RowIter rowIterA(rowA, rowA ? A.getBounds() : fBounds);
+                RowIter rowIterB(rowB, rowB ? B.getBounds() : fBounds);
+                this->operateX(bot - 1, rowIterA, rowIterB, proc);
+            }
         }
 
         advanceIter(iterA, topA, botA, bot);
@@ -1458,6 +1553,14 @@ bool SkAAClip::op(const SkAAClip& other, SkClipOp op) {
     SkASSERT(SkIRect::Intersects(bounds, fBounds));
     SkASSERT(SkIRect::Intersects(bounds, other.fBounds));
 
+    // Intersecting a hard-edged rect with another clip just crops that clip, which op(SkIRect)
+    // can often do without rebuilding its rows.
+    if (op == SkClipOp::kIntersect && this->isRect()) {
+        const SkIRect rect = fBounds;
+        *this = other;  // Shares other's runs until they need to change.
+        return this->op(rect, op);
+    }
+
     Builder builder(bounds);
     return builder.applyClipOp(this, other, op);
 }
@@ -1546,6 +1649,13 @@ bool SkAAClip::translate(int dx, int dy, SkAAClip* dst) const {
     return true;
 }
 
+size_t SkAAClip::approximateBytesUsed() const {
+    if (!fRunHead) {
+        return 0;
+    }
+    return sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) + fRunHead->fDataSize;
+}
+
 void SkAAClip::freeRuns() {
     if (fRunHead) {
         SkASSERT(fRunHead->fRefCnt.load() >= 1);
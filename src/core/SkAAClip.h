@@ -13,6 +13,7 @@
 #include "include/private/base/SkAssert.h"
 #include "src/base/SkAutoMalloc.h"
 #include "src/core/SkBlitter.h"
+#include <cstddef>
 #include <cstdint>
 #include "include/private/base/SkDebug.h"
 
@@ -48,6 +49,9 @@ public:
 
     bool translate(int dx, int dy, SkAAClip* dst) const;
 
+    // Returns the size of the run data, which is shared between copies of this clip.
+    size_t approximateBytesUsed() const;
+
     /**
      *  Allocates a mask the size of the aaclip, and expands its data into
      *  the mask, using kA8_Format. Used for tests and visualization purposes.
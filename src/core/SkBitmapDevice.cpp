@@ -29,8 +29,10 @@
 #include "include/core/SkTileMode.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkCPUContextImpl.h"
 #include "src/core/SkCPURecorderImpl.h"
 #include "src/core/SkDraw.h"
+#include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImagePriv.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixPriv.h"
@@ -368,6 +370,13 @@ void SkBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
     LOOP_TILER( drawRect(r, paint), Bounder(r, paint))
 }
 
+void SkBitmapDevice::drawEdgeAAQuadSet(SkSpan<const SkRect> rects,
+                                       SkSpan<const SkColor4f> colors,
+                                       SkCanvas::QuadAAFlags aa,
+                                       SkBlendMode mode) {
+    LOOP_TILER( drawRectSet(rects, colors, mode, aa == SkCanvas::kAll_QuadAAFlags), nullptr)
+}
+
 void SkBitmapDevice::drawOval(const SkRect& oval, const SkPaint& paint) {
     LOOP_TILER( drawOval(oval, paint), Bounder(oval, paint))
 }
@@ -638,6 +647,12 @@ sk_sp<SkSurface> SkBitmapDevice::makeSurface(const SkImageInfo& info, const SkSu
     return SkSurfaces::Raster(info, &props);
 }
 
+sk_sp<skif::Backend> SkBitmapDevice::createImageFilteringBackend(const SkSurfaceProps& surfaceProps,
+                                                                 SkColorType colorType) const {
+    SkExecutor* executor = fRecorder && fRecorder->ctx() ? fRecorder->ctx()->executor() : nullptr;
+    return skif::MakeRasterBackend(surfaceProps, colorType, executor);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void SkBitmapDevice::pushClipStack() {
@@ -76,6 +76,8 @@ public:
     void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
 
     void drawPath(const SkPath&, const SkPaint&) override;
+    void drawEdgeAAQuadSet(SkSpan<const SkRect>, SkSpan<const SkColor4f>, SkCanvas::QuadAAFlags,
+                           SkBlendMode) override;
 
     void drawImageRect(const SkImage*, const SkRect* src, const SkRect& dst,
                        const SkSamplingOptions&, const SkPaint&,
@@ -130,6 +132,10 @@ private:
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
 
+    // Passes the recorder's executor on to the image filtering backend.
+    sk_sp<skif::Backend> createImageFilteringBackend(const SkSurfaceProps& surfaceProps,
+                                                     SkColorType colorType) const override;
+
     class BDDraw;
 
     // Used to change the backend's pixels (and possibly config/rowbytes) but cannot change the
@@ -10,14 +10,17 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h" // IWYU pragma: keep
 #include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSamplingOptions.h"
@@ -25,6 +28,7 @@
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTileMode.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkFeatures.h"
 #include "include/private/base/SkMalloc.h"
@@ -35,16 +39,26 @@
 #include "src/core/SkBitmapDevice.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkKnownRuntimeEffects.h"
+#include "src/core/SkMipmap.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <memory>
 #include <utility>
 
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE1
     #include <xmmintrin.h>
     #define SK_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
@@ -153,6 +167,106 @@ private:
     const float fSigma;
 };
 
+// The vertical pass transposes bands of this many columns into contiguous scratch rows, blurs
+// them like the horizontal pass, and transposes the results back into place.
+static constexpr int kColumnsPerBand = 16;
+static constexpr int kRowsPerBand = 32;
+// Blurs producing fewer pixels than this are not worth splitting across threads.
+static constexpr int64_t kMinPixelsToThread = 256 * 256;
+
+// Transposes an 8x8 block of 32-bit pixels.
+static void transpose_8x8(const uint32_t* src, size_t srcStride, uint32_t* dst, size_t dstStride) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    __m256i r[8];
+    for (int i = 0; i < 8; ++i) {
+        r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i*srcStride));
+    }
+    // Interleave pairs of rows, then pairs of pairs, leaving each 128-bit lane holding four
+    // values of one column. The last step stitches together the lanes from rows 0-3 and 4-7.
+    __m256i t[8], u[8];
+    for (int i = 0; i < 8; i += 4) {
+        t[i+0] = _mm256_unpacklo_epi32(r[i+0], r[i+1]);
+        t[i+1] = _mm256_unpackhi_epi32(r[i+0], r[i+1]);
+        t[i+2] = _mm256_unpacklo_epi32(r[i+2], r[i+3]);
+        t[i+3] = _mm256_unpackhi_epi32(r[i+2], r[i+3]);
+        u[i+0] = _mm256_unpacklo_epi64(t[i+0], t[i+2]);
+        u[i+1] = _mm256_unpackhi_epi64(t[i+0], t[i+2]);
+        u[i+2] = _mm256_unpacklo_epi64(t[i+1], t[i+3]);
+        u[i+3] = _mm256_unpackhi_epi64(t[i+1], t[i+3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i*dstStride),
+                            _mm256_permute2x128_si256(u[i], u[i+4], 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (i+4)*dstStride),
+                            _mm256_permute2x128_si256(u[i], u[i+4], 0x31));
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    for (int y = 0; y < 8; y += 4) {
+        for (int x = 0; x < 8; x += 4) {
+            const uint32_t* s = src + y*srcStride + x;
+            __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 0*srcStride)),
+                    r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 1*srcStride)),
+                    r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 2*srcStride)),
+                    r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 3*srcStride));
+            __m128i t0 = _mm_unpacklo_epi32(r0, r1),
+                    t1 = _mm_unpacklo_epi32(r2, r3),
+                    t2 = _mm_unpackhi_epi32(r0, r1),
+                    t3 = _mm_unpackhi_epi32(r2, r3);
+            uint32_t* d = dst + x*dstStride + y;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 0*dstStride), _mm_unpacklo_epi64(t0, t1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 1*dstStride), _mm_unpackhi_epi64(t0, t1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2*dstStride), _mm_unpacklo_epi64(t2, t3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 3*dstStride), _mm_unpackhi_epi64(t2, t3));
+        }
+    }
+#else
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            dst[x*dstStride + y] = src[y*srcStride + x];
+        }
+    }
+#endif
+}
+
+// Writes the transpose of the w x h block at src to dst, so dst holds h x w pixels. The block is
+// walked in 8x8 tiles so that both the reads and the writes stay within a few cache lines.
+template <typename T>
+static void transpose(const T* src, size_t srcStride, T* dst, size_t dstStride, int w, int h) {
+    static constexpr int kTile = 8;
+    for (int y = 0; y < h; y += kTile) {
+        for (int x = 0; x < w; x += kTile) {
+            const T* s = src + y*srcStride + x;
+            T* d = dst + x*dstStride + y;
+            const int tileW = std::min(kTile, w - x),
+                      tileH = std::min(kTile, h - y);
+            if constexpr (sizeof(T) == sizeof(uint32_t)) {
+                if (tileW == kTile && tileH == kTile) {
+                    transpose_8x8(reinterpret_cast<const uint32_t*>(s), srcStride,
+                                  reinterpret_cast<uint32_t*>(d), dstStride);
+                    continue;
+                }
+            }
+            for (int ty = 0; ty < tileH; ++ty) {
+                for (int tx = 0; tx < tileW; ++tx) {
+                    d[tx*dstStride + ty] = s[ty*srcStride + tx];
+                }
+            }
+        }
+    }
+}
+
+// Calls fn for each band in [0, bandCount), spreading them across the default executor when
+// 'threaded' is true. Bands must write disjoint pixels.
+static void for_each_band(int bandCount, bool threaded, const std::function<void(int)>& fn) {
+    if (threaded && bandCount > 1) {
+        SkTaskGroup().batch(bandCount, fn);
+    } else {
+        for (int band = 0; band < bandCount; ++band) {
+            fn(band);
+        }
+    }
+}
+
 // T is type of the pixel format for the color type.
 // This should only be used for 8bit color channels.
 template <typename T>
@@ -182,9 +296,15 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
     }
     dst.eraseColor(SK_ColorTRANSPARENT);
 
-    auto buffer = alloc->makeBytesAlignedTo(std::max(makerX->bufferSizeBytes(),
-                                            makerY->bufferSizeBytes()),
-                                            alignof(skvx::Vec<N, uint32_t>));
+    // Each band of rows (X pass) or columns (Y pass) gets its own Pass and scratch memory so
+    // that bands can be blurred on separate threads.
+    const bool threaded =
+            SkToS64(dstBounds.width()) * dstBounds.height() >= kMinPixelsToThread;
+    auto make_pass = [](const PassMaker* maker, SkArenaAlloc* bandAlloc) {
+        void* buffer = bandAlloc->makeBytesAlignedTo(maker->bufferSizeBytes(),
+                                                     alignof(skvx::Vec<N, uint32_t>));
+        return maker->makePass(buffer, bandAlloc);
+    };
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -203,20 +323,26 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
         loopStart = std::max(srcBounds.top(),    dstBounds.top());
         loopEnd   = std::min(srcBounds.bottom(), dstBounds.bottom());
 
-        auto srcAddr = reinterpret_cast<T*>(src.getAddr(0, loopStart - srcBounds.top()));
-        auto dstAddr = reinterpret_cast<T*>(dst.getAddr(0, loopStart - dstBounds.top()));
-
         // Iterate over each row to calculate 1D blur along X.
-        Pass* pass = makerX->makePass(buffer, alloc);
-        for (int y = loopStart; y < loopEnd; ++y) {
-            pass->blur<T>(srcBounds.left()  - dstBounds.left(),
-                          srcBounds.right() - dstBounds.left(),
-                          dstBounds.width(),
-                          srcAddr, 1,
-                          dstAddr, 1);
-            srcAddr += src.rowBytesAsPixels();
-            dstAddr += dst.rowBytesAsPixels();
-        }
+        const int rows = std::max(loopEnd - loopStart, 0);
+        for_each_band((rows + kRowsPerBand - 1) / kRowsPerBand, threaded, [&](int band) {
+            SkSTArenaAlloc<1024> bandAlloc;
+            Pass* pass = make_pass(makerX, &bandAlloc);
+
+            const int y0 = loopStart + band * kRowsPerBand,
+                      y1 = std::min(y0 + kRowsPerBand, loopEnd);
+            auto srcAddr = reinterpret_cast<T*>(src.getAddr(0, y0 - srcBounds.top()));
+            auto dstAddr = reinterpret_cast<T*>(dst.getAddr(0, y0 - dstBounds.top()));
+            for (int y = y0; y < y1; ++y) {
+                pass->blur<T>(srcBounds.left()  - dstBounds.left(),
+                              srcBounds.right() - dstBounds.left(),
+                              dstBounds.width(),
+                              srcAddr, 1,
+                              dstAddr, 1);
+                srcAddr += src.rowBytesAsPixels();
+                dstAddr += dst.rowBytesAsPixels();
+            }
+        });
 
         // Set up the Y pass to blur from the full dst into the non-outset portion of dst
         src = dst;
@@ -233,21 +359,35 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
 
     // Iterate over each column to calculate 1D blur along Y. This is either blurring from src
     // into dst for a 1D blur; or it's blurring from dst into dst for the second pass of a 2D
-    // blur.
+    // blur. Walking a column directly touches a new cache line for every pixel, so instead each
+    // band of columns is transposed into contiguous rows, blurred, and transposed back. A band
+    // reads all of its source pixels before writing any, so this is still safe in place.
     if (makerY->window() > 1) {
-        auto srcAddr = reinterpret_cast<T*>(src.getAddr(loopStart - srcBounds.left(), 0));
+        const int srcHeight = srcBounds.height(),
+                  dstHeight = dstBounds.height();
+        auto srcAddr = reinterpret_cast<const T*>(src.getAddr(loopStart - srcBounds.left(), 0));
         auto dstAddr = reinterpret_cast<T*>(dst.getAddr(loopStart - dstBounds.left(), dstYOffset));
 
-        Pass* pass = makerY->makePass(buffer, alloc);
-        for (int x = loopStart; x < loopEnd; ++x) {
-            pass->blur<T>(srcBounds.top()    - dstBounds.top(),
-                          srcBounds.bottom() - dstBounds.top(),
-                          dstBounds.height(),
-                          srcAddr, src.rowBytesAsPixels(),
-                          dstAddr, dst.rowBytesAsPixels());
-            srcAddr += 1;
-            dstAddr += 1;
-        }
+        const int columns = std::max(loopEnd - loopStart, 0);
+        for_each_band((columns + kColumnsPerBand - 1) / kColumnsPerBand, threaded, [&](int band) {
+            SkSTArenaAlloc<1024> bandAlloc;
+            Pass* pass = make_pass(makerY, &bandAlloc);
+
+            const int x0 = band * kColumnsPerBand,
+                      w  = std::min(kColumnsPerBand, columns - x0);
+            T* srcRows = bandAlloc.makeArrayDefault<T>(w * srcHeight);
+            T* dstRows = bandAlloc.makeArrayDefault<T>(w * dstHeight);
+
+            transpose(srcAddr + x0, src.rowBytesAsPixels(), srcRows, srcHeight, w, srcHeight);
+            for (int x = 0; x < w; ++x) {
+                pass->blur<T>(srcBounds.top()    - dstBounds.top(),
+                              srcBounds.bottom() - dstBounds.top(),
+                              dstHeight,
+                              srcRows + x * srcHeight, 1,
+                              dstRows + x * dstHeight, 1);
+            }
+            transpose(dstRows, dstHeight, dstAddr + x0, dst.rowBytesAsPixels(), dstHeight, w);
+        });
     }
 
 #if defined(SK_AVOID_SLOW_RASTER_PIPELINE_BLURS)
@@ -263,6 +403,123 @@ static sk_sp<SkSpecialImage> eval_blur_passes(PassMaker* makerX, PassMaker* make
     return SkSpecialImages::MakeFromRaster(dstBounds, dst, SkSurfaceProps{});
 }
 
+// Blurs with a sigma of at least kMinPyramidSigma along both axes are evaluated on a copy of the
+// source that has been 2x2 box filtered 'levels' times, choosing the most levels that still leave
+// a sigma of kMinPyramidLevelSigma to blur at the reduced size. The blurred copy is then
+// bilinearly upsampled into the destination. Compared to the full resolution box passes, this
+// differs by at most 4/255 per channel, mostly because the box windows are rounded to whole
+// pixels at a different scale.
+static constexpr float kMinPyramidSigma = 32.f;
+static constexpr float kMinPyramidLevelSigma = 16.f;
+
+// Set by SkAutoDisableBlurPyramid.
+static thread_local bool sDisableBlurPyramid = false;
+
+static int pyramid_levels(SkSize sigma) {
+    const float minSigma = std::min(sigma.width(), sigma.height());
+    if (sDisableBlurPyramid || minSigma < kMinPyramidSigma) {
+        return 0;
+    }
+    return std::max(1, (int) std::floor(std::log2(minSigma / kMinPyramidLevelSigma)));
+}
+
+// Both the box downsampling and the bilinear upsampling blur the image a little themselves, so
+// 'sigma' is reduced by their combined variance of about scale^2/4 in full resolution pixels.
+static float pyramid_sigma(float sigma, int scale) {
+    const float scaled = sigma / scale;
+    return std::sqrt(std::max(scaled * scaled - 0.25f, 0.f));
+}
+
+// MakeMaker returns the PassMaker for a sigma, just like the blur algorithms use to call
+// eval_blur_passes() directly. The reduced pixels average blocks of 'scale' pixels that start at
+// multiples of 'scale' in the grid 'srcOrigin' is given in, so that every tile of a blur averages
+// the same blocks.
+template <typename T, typename MakeMaker>
+static sk_sp<SkSpecialImage> eval_pyramid_blur(const MakeMaker& makeMaker,
+                                               int levels,
+                                               SkSize sigma,
+                                               const SkBitmap& src,
+                                               const SkIRect& srcBounds,
+                                               const SkIRect& dstBounds,
+                                               SkIPoint srcOrigin,
+                                               SkArenaAlloc* alloc) {
+    SkASSERT(levels > 0);
+    const int scale = 1 << levels;
+
+    // The first block that srcBounds touches, relative to src. 'scale' is a power of two, so the
+    // mask rounds negative grid positions down as well.
+    const SkIPoint blockOrigin = {
+            srcBounds.left() - ((srcBounds.left() + srcOrigin.x()) & (scale - 1)),
+            srcBounds.top()  - ((srcBounds.top()  + srcOrigin.y()) & (scale - 1))};
+
+    // Pad the source with transparent pixels, matching the decal tiling, out to whole blocks so
+    // that every level is exactly half the size of the one above it.
+    SkBitmap level;
+    if (!level.tryAllocPixels(
+                src.info().makeWH(SkAlignTo(srcBounds.right()  - blockOrigin.x(), scale),
+                                  SkAlignTo(srcBounds.bottom() - blockOrigin.y(), scale)))) {
+        return nullptr;
+    }
+    level.eraseColor(SK_ColorTRANSPARENT);
+    SkPixmap srcPixels;
+    if (!src.pixmap().extractSubset(&srcPixels, srcBounds) ||
+        !level.writePixels(srcPixels,
+                           srcBounds.left() - blockOrigin.x(),
+                           srcBounds.top()  - blockOrigin.y())) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkMipmapDownSampler> downsampler = SkMipmap::MakeDownSampler(level.pixmap());
+    if (!downsampler) {
+        return nullptr;
+    }
+    for (int i = 0; i < levels; ++i) {
+        SkBitmap next;
+        if (!next.tryAllocPixels(level.info().makeWH(level.width() / 2, level.height() / 2))) {
+            return nullptr;
+        }
+        downsampler->buildLevel(next.pixmap(), level.pixmap());
+        level = std::move(next);
+    }
+
+    // Pixel i of the reduced image was averaged from [i*scale, (i+1)*scale) relative to
+    // blockOrigin. Blur enough of it to cover dstBounds, plus one pixel on each side for the
+    // bilinear upsample.
+    const SkIRect relativeDstBounds = dstBounds.makeOffset(-blockOrigin);
+    const SkIRect smallDstBounds = SkRect::MakeLTRB(relativeDstBounds.left()   / (float) scale,
+                                                    relativeDstBounds.top()    / (float) scale,
+                                                    relativeDstBounds.right()  / (float) scale,
+                                                    relativeDstBounds.bottom() / (float) scale)
+                                           .roundOut()
+                                           .makeOutset(1, 1);
+    sk_sp<SkSpecialImage> blurred =
+            eval_blur_passes<T>(makeMaker(pyramid_sigma(sigma.width(), scale)),
+                                makeMaker(pyramid_sigma(sigma.height(), scale)),
+                                level, SkIRect::MakeSize(level.dimensions()), smallDstBounds,
+                                alloc);
+    SkBitmap blurredPixels;
+    if (!SkSpecialImages::AsBitmap(blurred.get(), &blurredPixels)) {
+        return nullptr;
+    }
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(src.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return nullptr;
+    }
+    dst.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas{dst};
+    canvas.translate(blockOrigin.x() - dstBounds.left(), blockOrigin.y() - dstBounds.top());
+    canvas.scale(scale, scale);
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    canvas.drawImage(blurredPixels.asImage(), smallDstBounds.left(), smallDstBounds.top(),
+                     SkSamplingOptions{SkFilterMode::kLinear}, &paint);
+
+    return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()), dst,
+                                           SkSurfaceProps{});
+}
+
 // Implement a scanline processor for a true 1D Gaussian kernel.
 // T is type of the pixel format for the color type.
 // This should only be used for 8bit color channels.
@@ -1165,7 +1422,8 @@ public:
                                sk_sp<SkSpecialImage> input,
                                const SkIRect& originalSrcBounds,
                                SkTileMode tileMode,
-                               const SkIRect& originalDstBounds) const override {
+                               const SkIRect& originalDstBounds,
+                               SkIPoint srcOrigin) const override {
         SkASSERT(tileMode == SkTileMode::kDecal);
         SkASSERT(SkIRect::MakeSize(input->dimensions()).contains(originalSrcBounds));
 
@@ -1189,6 +1447,11 @@ public:
             SK_ABORT("Sigma is out of range.");
         };
 
+        if (int levels = pyramid_levels(sigma); levels > 0) {
+            return eval_pyramid_blur<uint8_t>(makeMaker, levels, sigma, src, originalSrcBounds,
+                                              originalDstBounds, srcOrigin, &alloc);
+        }
+
         PassMaker* makerX = makeMaker(sigma.width());
         PassMaker* makerY = makeMaker(sigma.height());
 
@@ -1224,7 +1487,8 @@ public:
                                sk_sp<SkSpecialImage> input,
                                const SkIRect& originalSrcBounds,
                                SkTileMode tileMode,
-                               const SkIRect& originalDstBounds) const override {
+                               const SkIRect& originalDstBounds,
+                               SkIPoint srcOrigin) const override {
         // TODO: Enable this assert when the TentPass is no longer used for legacy blurs
         // (which supports blur sigmas larger than what's reported in maxSigma()).
         // SkASSERT(sigma.width() <= this->maxSigma() && sigma.height() <= this->maxSigma());
@@ -1257,6 +1521,11 @@ public:
             SK_ABORT("Sigma is out of range.");
       };
 
+        if (int levels = pyramid_levels(sigma); levels > 0) {
+            return eval_pyramid_blur<uint32_t>(makeMaker, levels, sigma, src, originalSrcBounds,
+                                               originalDstBounds, srcOrigin, &alloc);
+        }
+
         PassMaker* makerX = makeMaker(sigma.width());
         PassMaker* makerY = makeMaker(sigma.height());
 
@@ -1313,6 +1582,12 @@ const SkBlurEngine* SkBlurEngine::GetRasterBlurEngine() {
     return &kInstance;
 }
 
+SkAutoDisableBlurPyramid::SkAutoDisableBlurPyramid() : fPrev(sDisableBlurPyramid) {
+    sDisableBlurPyramid = true;
+}
+
+SkAutoDisableBlurPyramid::~SkAutoDisableBlurPyramid() { sDisableBlurPyramid = fPrev; }
+
 // SkShaderBlurAlgorithm
 // ----------------------------------------------------------------------------
 
@@ -1666,7 +1941,8 @@ sk_sp<SkSpecialImage> SkShaderBlurAlgorithm::blur(SkSize sigma,
                                                   sk_sp<SkSpecialImage> src,
                                                   const SkIRect& srcRect,
                                                   SkTileMode tileMode,
-                                                  const SkIRect& dstRect) const {
+                                                  const SkIRect& dstRect,
+                                                  SkIPoint /*srcOrigin*/) const {
     SkASSERT(sigma.width() <= kMaxLinearSigma &&  sigma.height() <= kMaxLinearSigma);
 
     int radiusX = SkBlurEngine::SigmaToRadius(sigma.width());
@@ -13,6 +13,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkSpan.h"
 #include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkNoncopyable.h"
 
 #include <algorithm>
 #include <array>
@@ -114,6 +115,11 @@ public:
     //
     // 'srcRect' and 'dstRect' may be different sizes and even be disjoint.
     //
+    // 'srcOrigin' is the position of 'src's top-left pixel in a pixel grid shared by every blur of
+    // the same content, e.g. the layer when an image filter is evaluated in tiles. Algorithms that
+    // resample the image internally align their sampling to that grid, so that the tiles of a blur
+    // match blurring the whole image at once.
+    //
     // The returned SkImage will have the same color type and colorspace as the input image. It will
     // be an SkImage type matching the underlying Skia backend. If the 'src' SkImage is not a
     // compatible SkImage type, null is returned.
@@ -123,7 +129,8 @@ public:
                                        sk_sp<SkSpecialImage> src,
                                        const SkIRect& srcRect,
                                        SkTileMode tileMode,
-                                       const SkIRect& dstRect) const = 0;
+                                       const SkIRect& dstRect,
+                                       SkIPoint srcOrigin) const = 0;
 };
 
 /**
@@ -140,7 +147,8 @@ public:
                                sk_sp<SkSpecialImage> src,
                                const SkIRect& srcRect,
                                SkTileMode tileMode,
-                               const SkIRect& dstRect) const override;
+                               const SkIRect& dstRect,
+                               SkIPoint srcOrigin) const override;
 
 private:
     // Create a new surface, which can be approx-fit and have undefined contents.
@@ -282,4 +290,16 @@ public:
 
 };
 
+// While in scope, makes the raster blur algorithms evaluate large sigmas on the calling thread at
+// full resolution instead of on a downsampled copy, so tests can compare the two. Blurs on other
+// threads are not affected. Drawing code must not use this.
+class [[nodiscard]] SkAutoDisableBlurPyramid : SkNoncopyable {
+public:
+    SkAutoDisableBlurPyramid();
+    ~SkAutoDisableBlurPyramid();
+
+private:
+    bool fPrev;
+};
+
 #endif // SkBlurEngine_DEFINED
@@ -13,7 +13,7 @@
 namespace skcpu {
 
 std::unique_ptr<const Context> Context::Make(const Context::Options& opts) {
-    return std::make_unique<ContextImpl>();
+    return std::make_unique<ContextImpl>(opts);
 }
 
 std::unique_ptr<const Context> Context::Make() {
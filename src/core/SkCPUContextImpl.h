@@ -11,12 +11,21 @@
 #include "include/core/SkSurfaceProps.h"
 #include "src/core/SkResourceCache.h"
 
+class SkExecutor;
+
 namespace skcpu {
 class ContextImpl final : public Context {
 public:
     ContextImpl() = default;
+    explicit ContextImpl(const Options& opts) : fExecutor(opts.fExecutor) {}
 
     static const ContextImpl* TODO();
+
+    // Optional; when null all raster work happens on the calling thread.
+    SkExecutor* executor() const { return fExecutor; }
+
+private:
+    SkExecutor* const fExecutor = nullptr;
 };
 }  // namespace skcpu
 
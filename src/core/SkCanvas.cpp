@@ -45,6 +45,7 @@
 #include "src/base/SkEnumBitMask.h"
 #include "src/base/SkMSAN.h"
 #include "src/core/SkBlenderBase.h"
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkBlurMaskFilterImpl.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkDevice.h"
@@ -65,6 +66,7 @@
 #include "src/utils/SkPatchUtils.h"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <new>
 #include <optional>
@@ -697,6 +699,70 @@ static skif::FilterResult apply_alpha_and_colorfilter(const skif::Context& ctx,
     return result;
 }
 
+// Filtered draws whose output covers more pixels than this are evaluated one output tile at a
+// time. Each tile only requests the inputs it needs from the filter DAG, so the intermediate
+// images at every node are bounded by the tile size plus the filters' margins instead of by the
+// size of the whole output.
+static constexpr int64_t kMaxUntiledFilterOutputPixels = 4096 * 4096;
+static constexpr int kFilterOutputTileSize = 2048;
+
+// Returns true if evaluating 'filter' blurs with a sigma larger than the backend's blur engine
+// supports directly, in which case FilterResult::rescale() downsamples relative to the bounds
+// that are requested from it.
+static bool filter_blur_rescales(const skif::Context& ctx, const SkImageFilter* filter) {
+    const float sigma = filter ? as_IFB(filter)->getMaxLayerBlurSigma(ctx.mapping()) : 0.f;
+    const SkBlurEngine* blurEngine = ctx.backend()->getBlurEngine();
+    if (sigma <= 0.f || !blurEngine) {
+        return false;
+    }
+    const SkBlurEngine::Algorithm* algorithm =
+            blurEngine->findAlgorithm(SkSize{sigma, sigma}, ctx.backend()->colorType());
+    return algorithm && sigma > algorithm->maxSigma();
+}
+
+// Calls drawTile(tileCtx, tiled) either once with 'ctx', or once per tile with contexts whose
+// desired outputs partition ctx.desiredOutput(). The caller must restrict what it draws for each
+// tile to that tile's desired output. Tiling is skipped when the blend would touch pixels outside
+// of what is drawn, or when layer pixels don't map 1:1 onto device pixels so tiles could overlap.
+// It is also skipped when 'filter' rescales its input for a large blur, since the reduced
+// resolution grid follows each tile's requested bounds and would leave seams between tiles.
+// Only raster devices are tiled; GPU devices are bounded by their own texture limits instead.
+static void for_each_filter_output_tile(
+        const skif::Context& ctx,
+        SkDevice* dst,
+        const SkImageFilter* filter,
+        const SkBlender* blender,
+        const std::function<void(const skif::Context&, bool tiled)>& drawTile) {
+    const SkIRect output = SkIRect(ctx.desiredOutput());
+    if (sk_64_mul(output.width(), output.height()) <= kMaxUntiledFilterOutputPixels) {
+        drawTile(ctx, /*tiled=*/false);
+        return;
+    }
+
+    SkPixmap dstPixels;
+    const SkMatrix layerToDevice = ctx.mapping().layerToDevice().asM33();
+    const bool canTile = dst->peekPixels(&dstPixels) &&
+                         (!blender || !as_BB(blender)->affectsTransparentBlack()) &&
+                         layerToDevice.isTranslate() &&
+                         SkScalarIsInt(layerToDevice.getTranslateX()) &&
+                         SkScalarIsInt(layerToDevice.getTranslateY()) &&
+                         !filter_blur_rescales(ctx, filter);
+    if (!canTile) {
+        drawTile(ctx, /*tiled=*/false);
+        return;
+    }
+
+    for (int y = output.fTop; y < output.fBottom; y += kFilterOutputTileSize) {
+        for (int x = output.fLeft; x < output.fRight; x += kFilterOutputTileSize) {
+            const SkIRect tile = SkIRect::MakeLTRB(
+                    x, y,
+                    (int) std::min<int64_t>((int64_t) x + kFilterOutputTileSize, output.fRight),
+                    (int) std::min<int64_t>((int64_t) y + kFilterOutputTileSize, output.fBottom));
+            drawTile(ctx.withNewDesiredOutput(skif::LayerSpace<SkIRect>(tile)), /*tiled=*/true);
+        }
+    }
+}
+
 void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
                                             SkDevice* dst,
                                             FilterSpan filters,
@@ -853,9 +919,8 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
     FilterSpan filtersOrNull = filters.empty() ? FilterSpan{&nullFilter, 1} : filters;
 
     for (const sk_sp<SkImageFilter>& filter : filtersOrNull) {
-        auto result = filter ? as_IFB(filter)->filterImage(ctx) : source;
-
         if (srcIsCoverageLayer) {
+            auto result = filter ? as_IFB(filter)->filterImage(ctx) : source;
             SkASSERT(dst->useDrawCoverageMaskForMaskFilters());
             // TODO: Can FilterResult optimize this in any meaningful way if it still has to go
             // through drawCoverageMask that requires an image (vs a coverage shader)?
@@ -868,8 +933,18 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
                         result.sampling(), paint);
             }
         } else {
-            result = apply_alpha_and_colorfilter(ctx, result, paint);
-            result.draw(ctx, dst, paint.getBlender());
+            for_each_filter_output_tile(ctx, dst, filter.get(), paint.getBlender(),
+                                        [&](const skif::Context& tileCtx, bool tiled) {
+                auto result = filter ? as_IFB(filter)->filterImage(tileCtx) : source;
+                result = apply_alpha_and_colorfilter(tileCtx, result, paint);
+                if (tiled) {
+                    // Color filters can fill transparent black, so this crops after applying them
+                    // to keep each tile's draw from overlapping its neighbors.
+                    result = result.applyCrop(tileCtx, tileCtx.desiredOutput(),
+                                              SkTileMode::kDecal);
+                }
+                result.draw(tileCtx, dst, paint.getBlender());
+            });
         }
     }
 
@@ -2336,8 +2411,15 @@ void SkCanvas::onDrawImageRect2(const SkImage* image, const SkRect& src, const S
         // and a desired output matching the device clip bounds.
         ctx = ctx.withNewDesiredOutput(mapping.deviceToLayer(outputBounds))
                  .withNewSource(source);
-        auto result = as_IFB(realPaint.getImageFilter())->filterImage(ctx);
-        result.draw(ctx, device, realPaint.getBlender());
+        for_each_filter_output_tile(ctx, device, realPaint.getImageFilter(),
+                                    realPaint.getBlender(),
+                                    [&](const skif::Context& tileCtx, bool tiled) {
+            auto result = as_IFB(realPaint.getImageFilter())->filterImage(tileCtx);
+            if (tiled) {
+                result = result.applyCrop(tileCtx, tileCtx.desiredOutput(), SkTileMode::kDecal);
+            }
+            result.draw(tileCtx, device, realPaint.getBlender());
+        });
         stats.reportStats();
         return;
     }
@@ -13,6 +13,7 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkShader.h"
@@ -20,11 +21,13 @@
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkAutoMalloc.h"
+#include "src/core/SkDevice.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/core/SkWriter32.h"
 
+#include <algorithm>
 #include <utility>
 #include <cstdint>
 
@@ -159,6 +162,39 @@ bool SkCanvasPriv::ImageToColorFilter(SkPaint* paint) {
     return true;
 }
 
+void SkCanvasPriv::DrawEdgeAAQuadSet(SkCanvas* canvas, SkSpan<const SkRect> rects,
+                                     SkSpan<const SkColor4f> colors, SkCanvas::QuadAAFlags aa,
+                                     SkBlendMode mode) {
+    SkASSERT(rects.size() == colors.size());
+
+    // Like onDrawEdgeAAQuad(), skip the draw when none of it can be seen. Whether a color draws
+    // anything depends on the blend mode, so use the paint of the first entry that does; the
+    // bounds of a solid fill don't depend on its color.
+    const SkColor4f* visibleColor = std::find_if(colors.begin(), colors.end(),
+                                                 [mode](const SkColor4f& color) {
+        SkPaint paint{color};
+        paint.setBlendMode(mode);
+        return !paint.nothingToDraw();
+    });
+    if (visibleColor == colors.end()) {
+        return;
+    }
+    SkRect bounds = SkRect::MakeEmpty();
+    for (const SkRect& rect : rects) {
+        SkASSERT(rect.isSorted());
+        bounds.join(rect);
+    }
+    SkPaint paint{*visibleColor};
+    paint.setBlendMode(mode);
+    if (canvas->internalQuickReject(bounds, paint)) {
+        return;
+    }
+
+    if (canvas->predrawNotify()) {
+        canvas->topDevice()->drawEdgeAAQuadSet(rects, colors, aa, mode);
+    }
+}
+
 AutoLayerForImageFilter::AutoLayerForImageFilter(SkCanvas* canvas,
                                                  const SkPaint& paint,
                                                  const SkRect* rawBounds,
@@ -9,15 +9,18 @@
 #define SkCanvasPriv_DEFINED
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTileMode.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkNoncopyable.h"
 
 #include <cstddef>
 
+enum class SkBlendMode;
 class SkDevice;
 class SkImageFilter;
 class SkMatrix;
@@ -62,6 +65,18 @@ public:
         return canvas->topDevice();
     }
 
+    // Fills each rect with the matching color, like calling experimental_DrawEdgeAAQuad() for each
+    // without a clip quad, but hands the whole batch to the top device at once. This goes straight
+    // to the device, so it skips SkCanvas subclass overrides and is only meaningful for canvases
+    // that draw into their own device (e.g. raster surfaces). The batch is skipped when the union
+    // of the rects is clipped out, but individual rects are not culled here.
+    //
+    // This is private to Skia (benches and tests). SkCanvas has no public batched entry point, so
+    // clients calling experimental_DrawEdgeAAQuad() still draw one rect per call.
+    static void DrawEdgeAAQuadSet(SkCanvas*, SkSpan<const SkRect> rects,
+                                  SkSpan<const SkColor4f> colors, SkCanvas::QuadAAFlags,
+                                  SkBlendMode);
+
     // The experimental_DrawEdgeAAImageSet API accepts separate dstClips and preViewMatrices arrays,
     // where entries refer into them, but no explicit size is provided. Given a set of entries,
     // computes the minimum length for these arrays that would provide index access errors.
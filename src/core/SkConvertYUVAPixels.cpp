@@ -0,0 +1,198 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkConvertYUVAPixels.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/core/SkYUVAPixmaps.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTemplates.h"
+#include "modules/skcms/skcms.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkYUVAInfoLocation.h"
+#include "src/core/SkYUVMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+
+namespace {
+
+// One of the Y, U, V and A channels of the planes, and how it is upsampled to the full image.
+class Channel {
+public:
+    Channel(const SkPixmap& plane, SkColorChannel channel, int factorX, int factorY, int width)
+            : fPlane(plane)
+            , fBytesPerPixel(plane.info().bytesPerPixel())
+            // A single channel plane stores the channel in its only byte, whatever it is called.
+            , fOffset(fBytesPerPixel == 1 ? 0 : static_cast<int>(channel))
+            , fFactorY(factorY)
+            , fPlaneRow(factorX == 1 ? 0 : plane.width())
+            , fLeft(factorX == 1 ? 0 : width)
+            , fRight(factorX == 1 ? 0 : width)
+            , fRightWeight(factorX == 1 ? 0 : width) {
+        // The chroma samples are at the centers of their blocks, so destination x samples the
+        // plane at (x + 0.5) / factorX - 0.5. With a factor of 2 that weights the nearer sample
+        // 3/4 and the farther 1/4, like libjpeg's "fancy" upsampling.
+        if (factorX > 1) {
+            const int lastX = plane.width() - 1;
+            for (int x = 0; x < width; ++x) {
+                const float px = (x + 0.5f) / factorX - 0.5f;
+                const float left = std::floor(px);
+                fLeft[x] = std::clamp(static_cast<int>(left), 0, lastX);
+                fRight[x] = std::clamp(static_cast<int>(left) + 1, 0, lastX);
+                fRightWeight[x] = px - left;
+            }
+        }
+    }
+
+    // Writes the channel's values in row y of the full image to row, normalized to [0, 1].
+    void readRow(int y, float row[], int width) {
+        // Horizontally subsampled planes are first interpolated vertically into fPlaneRow.
+        float* src = fPlaneRow.get() ? fPlaneRow.get() : row;
+        const int planeWidth = fPlaneRow.get() ? fPlane.width() : width;
+        const float py = (y + 0.5f) / fFactorY - 0.5f;
+        const float top = std::floor(py);
+        const int lastY = fPlane.height() - 1;
+        const uint8_t* row0 = this->planeRow(std::clamp(static_cast<int>(top), 0, lastY));
+        const uint8_t* row1 = this->planeRow(std::clamp(static_cast<int>(top) + 1, 0, lastY));
+        const float w1 = fFactorY == 1 ? 0.f : py - top;
+        const float w0 = 1.f - w1;
+        for (int i = 0; i < planeWidth; ++i) {
+            src[i] = (w0 * row0[i * fBytesPerPixel] + w1 * row1[i * fBytesPerPixel]) *
+                     (1 / 255.f);
+        }
+
+        if (fPlaneRow.get()) {
+            for (int x = 0; x < width; ++x) {
+                const float l = src[fLeft[x]],
+                            r = src[fRight[x]];
+                row[x] = l + (r - l) * fRightWeight[x];
+            }
+        }
+    }
+
+private:
+    const uint8_t* planeRow(int y) const {
+        return static_cast<const uint8_t*>(fPlane.addr(0, y)) + fOffset;
+    }
+
+    const SkPixmap& fPlane;
+    const int fBytesPerPixel;
+    const int fOffset;
+    const int fFactorY;
+    // Only used for horizontally subsampled planes.
+    skia_private::AutoTMalloc<float> fPlaneRow;
+    skia_private::AutoTMalloc<int>   fLeft;
+    skia_private::AutoTMalloc<int>   fRight;
+    skia_private::AutoTMalloc<float> fRightWeight;
+};
+
+bool dst_format(SkColorType colorType, skcms_PixelFormat* format) {
+    switch (colorType) {
+        case kRGBA_8888_SkColorType: *format = skcms_PixelFormat_RGBA_8888; return true;
+        case kBGRA_8888_SkColorType: *format = skcms_PixelFormat_BGRA_8888; return true;
+        case kRGBA_F16_SkColorType:  *format = skcms_PixelFormat_RGBA_hhhh; return true;
+        default:                     return false;
+    }
+}
+
+void to_profile(const SkColorSpace* colorSpace, skcms_ICCProfile* profile) {
+    if (colorSpace) {
+        colorSpace->toProfile(profile);
+    } else {
+        *profile = *skcms_sRGB_profile();
+    }
+}
+
+}  // namespace
+
+bool SkConvertYUVAPixels(const SkPixmap& dst,
+                         const SkYUVAPixmaps& src,
+                         const SkColorSpace* srcColorSpace) {
+    if (!src.isValid() || src.dataType() != SkYUVAPixmaps::DataType::kUnorm8) {
+        return false;
+    }
+    skcms_PixelFormat dstFormat;
+    if (!dst.addr() || !dst_format(dst.colorType(), &dstFormat) ||
+        dst.alphaType() == kUnknown_SkAlphaType) {
+        return false;
+    }
+
+    const SkYUVAInfo& yuvaInfo = src.yuvaInfo();
+    const SkYUVAInfo::YUVALocations locations = src.toYUVALocations();
+    const SkPixmap& yPlane = src.plane(locations[SkYUVAInfo::kY].fPlane);
+    if (dst.dimensions() != yPlane.dimensions()) {
+        return false;
+    }
+    const int width = dst.width();
+
+    skia_private::STArray<4, Channel> channels;
+    for (int i = 0; i < SkYUVAInfo::kYUVAChannelCount; ++i) {
+        const int plane = locations[i].fPlane;
+        if (plane < 0) {
+            // Only alpha may be missing.
+            continue;
+        }
+        auto [factorX, factorY] = yuvaInfo.planeSubsamplingFactors(plane);
+        channels.emplace_back(src.plane(plane), locations[i].fChannel, factorX, factorY, width);
+    }
+    const bool hasAlpha = channels.size() == SkYUVAInfo::kYUVAChannelCount;
+
+    float yuvToRGB[20];
+    SkColorMatrix_YUV2RGB(yuvaInfo.yuvColorSpace(), yuvToRGB);
+    using F4 = skvx::float4;
+    const F4 fromY{yuvToRGB[0], yuvToRGB[5], yuvToRGB[10], 0},
+             fromU{yuvToRGB[1], yuvToRGB[6], yuvToRGB[11], 0},
+             fromV{yuvToRGB[2], yuvToRGB[7], yuvToRGB[12], 0},
+             fromA{0, 0, 0, 1},
+             bias {yuvToRGB[4], yuvToRGB[9], yuvToRGB[14], 0};
+
+    skcms_ICCProfile srcProfile, dstProfile;
+    to_profile(srcColorSpace, &srcProfile);
+    to_profile(dst.colorSpace(), &dstProfile);
+    skcms_AlphaFormat dstAlphaFormat = skcms_AlphaFormat_Unpremul;
+    if (!hasAlpha || dst.alphaType() == kOpaque_SkAlphaType) {
+        dstAlphaFormat = skcms_AlphaFormat_Opaque;
+    } else if (dst.alphaType() == kPremul_SkAlphaType) {
+        dstAlphaFormat = skcms_AlphaFormat_PremulAsEncoded;
+    }
+
+    // Each row is upsampled into a row of floats per channel, converted to a row of RGBA floats,
+    // and then converted by skcms straight into dst. These rows stay in cache.
+    skia_private::AutoTMalloc<float> rows(4 * width),
+                                     rgba(4 * width);
+    float* yuva[4] = {rows.get(), rows.get() + width, rows.get() + 2 * width,
+                      rows.get() + 3 * width};
+    if (!hasAlpha) {
+        std::fill_n(yuva[SkYUVAInfo::kA], width, 1.f);
+    }
+
+    for (int y = 0; y < dst.height(); ++y) {
+        for (int i = 0; i < channels.size(); ++i) {
+            channels[i].readRow(y, yuva[i], width);
+        }
+        for (int x = 0; x < width; ++x) {
+            const F4 px = fromY * yuva[0][x] + fromU * yuva[1][x] + fromV * yuva[2][x] +
+                          fromA * yuva[3][x] + bias;
+            skvx::pin(px, F4(0), F4(1)).store(rgba.get() + 4 * x);
+        }
+        if (!skcms_Transform(rgba.get(), skcms_PixelFormat_RGBA_ffff, skcms_AlphaFormat_Unpremul,
+                             &srcProfile, dst.writable_addr(0, y), dstFormat, dstAlphaFormat,
+                             &dstProfile, width)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConvertYUVAPixels_DEFINED
+#define SkConvertYUVAPixels_DEFINED
+
+class SkColorSpace;
+class SkPixmap;
+class SkYUVAPixmaps;
+
+/**
+ *  Converts 8 bit YUVA planes, e.g. from SkCodec::getYUVAPlanes(), to RGBA on the CPU in a single
+ *  pass over each row: the chroma planes are upsampled (bilinearly, about the centered chroma
+ *  siting, which matches libjpeg's "fancy" upsampling), the YUV to RGB matrix of the planes'
+ *  SkYUVColorSpace is applied, and the result is converted from srcColorSpace to the color space
+ *  and alpha type of dst.
+ *
+ *  dst must be kRGBA_8888, kBGRA_8888 or kRGBA_F16, and have the dimensions of the Y plane; the
+ *  planes' origin is not applied. A null color space is treated as sRGB.
+ *
+ *  Returns false if the planes or dst are not supported.
+ */
+[[nodiscard]] bool SkConvertYUVAPixels(const SkPixmap& dst,
+                                       const SkYUVAPixmaps& src,
+                                       const SkColorSpace* srcColorSpace);
+
+#endif
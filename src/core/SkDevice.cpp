@@ -251,6 +251,14 @@ void SkDevice::drawEdgeAAQuad(const SkRect& r, const SkPoint clip[4], SkCanvas::
     }
 }
 
+void SkDevice::drawEdgeAAQuadSet(SkSpan<const SkRect> rects, SkSpan<const SkColor4f> colors,
+                                 SkCanvas::QuadAAFlags aa, SkBlendMode mode) {
+    SkASSERT(rects.size() == colors.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        this->drawEdgeAAQuad(rects[i], nullptr, aa, colors[i], mode);
+    }
+}
+
 void SkDevice::drawEdgeAAImageSet(const SkCanvas::ImageSetEntry images[], int count,
                                   const SkPoint dstClips[], const SkMatrix preViewMatrices[],
                                   const SkSamplingOptions& sampling, const SkPaint& paint,
@@ -279,6 +287,7 @@ void SkDevice::drawEdgeAAImageSet(const SkCanvas::ImageSetEntry images[], int co
             // Since drawImageRect requires a srcRect, the dst clip is implemented as a true clip
             this->pushClipStack();
             SkPath clipPath = SkPath::Polygon({dstClips + clipIndex, 4}, true);
+            clipPath.setIsVolatile(true);
             this->clipPath(clipPath, SkClipOp::kIntersect, entryPaint.isAntiAlias());
             clipIndex += 4;
         }
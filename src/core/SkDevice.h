@@ -403,6 +403,10 @@ public:
     virtual void drawEdgeAAQuad(const SkRect& rect, const SkPoint clip[4],
                                 SkCanvas::QuadAAFlags aaFlags, const SkColor4f& color,
                                 SkBlendMode mode);
+    // Fills each rect with the matching color, as a batch of drawEdgeAAQuad() calls without clip
+    // quads. Default impl calls drawEdgeAAQuad() per entry.
+    virtual void drawEdgeAAQuadSet(SkSpan<const SkRect> rects, SkSpan<const SkColor4f> colors,
+                                   SkCanvas::QuadAAFlags aaFlags, SkBlendMode mode);
     // Default impl uses drawImageRect per entry, being anti-aliased only when an entry's edge flags
     // are all set. If there's a clip region, it will be applied using clipPath().
     virtual void drawEdgeAAImageSet(const SkCanvas::ImageSetEntry[], int count,
@@ -40,6 +40,7 @@
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkBlitter_A8.h"
+#include "src/core/SkCPUContextImpl.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkDrawProcs.h"
 #include "src/core/SkDrawTypes.h"
@@ -48,14 +49,18 @@
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixUtils.h"
+#include "src/core/SkMemset.h"
 #include "src/core/SkPathData.h"
 #include "src/core/SkPathEffectBase.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkScan.h"
+#include "src/core/SkScanPriv.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -790,6 +795,107 @@ void Draw::drawRect(const SkRect& prePaintRect,
     }
 }
 
+// Returns the N32 pixel that a solid fill of color with mode would memset, if it is just a memset.
+// This matches what SkRasterPipelineBlitter computes for constant colors on sRGB-or-untagged 8888.
+static std::optional<uint32_t> memset_color(const SkColor4f& color, SkBlendMode mode) {
+    if (!(mode == SkBlendMode::kSrc || (mode == SkBlendMode::kSrcOver && color.fA == 1)) ||
+        !color.fitsInBytes()) {
+        return std::nullopt;
+    }
+    const SkPMColor4f pm = color.premul();
+    auto to_byte = [](float c) { return (U8CPU)(c * 255 + 0.5f); };
+    return SkPackARGB32(to_byte(pm.fA), to_byte(pm.fR), to_byte(pm.fG), to_byte(pm.fB));
+}
+
+static bool is_integral(const SkRect& r) {
+    return std::floor(r.fLeft) == r.fLeft && std::floor(r.fTop) == r.fTop &&
+           std::floor(r.fRight) == r.fRight && std::floor(r.fBottom) == r.fBottom;
+}
+
+void Draw::drawRectSet(SkSpan<const SkRect> rects,
+                       SkSpan<const SkColor4f> colors,
+                       SkBlendMode mode,
+                       bool antiAlias) const {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT(rects.size() == colors.size());
+
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    SkPaint paint;
+    paint.setBlendMode(mode);
+    paint.setAntiAlias(antiAlias);
+
+    if (!fCTM->rectStaysRect()) {
+        for (size_t i = 0; i < rects.size(); ++i) {
+            paint.setColor(colors[i]);
+            this->drawRect(rects[i], paint);
+        }
+        return;
+    }
+
+    const bool canMemset = fDst.colorType() == kN32_SkColorType &&
+                           (!fDst.colorSpace() || fDst.colorSpace()->isSRGB()) &&
+                           fRC->isRect() && !fRC->clipShader();
+    const SkIRect& clip = fRC->getBounds();
+
+    // Rects that can't be memset reuse the previous blitter while their color doesn't change.
+    std::optional<SkAutoBlitterChoose> blitter;
+    SkColor4f blitterColor;
+
+    constexpr size_t kChunk = 256;
+    SkRect devRects[kChunk];
+    for (size_t start = 0; start < rects.size(); start += kChunk) {
+        const size_t count = std::min(kChunk, rects.size() - start);
+        fCTM->mapPoints({reinterpret_cast<SkPoint*>(devRects), 2 * count},
+                        {reinterpret_cast<const SkPoint*>(rects.data() + start), 2 * count});
+
+        for (size_t i = 0; i < count; ++i) {
+            const SkColor4f& color = colors[start + i];
+            SkRect& devRect = devRects[i];
+            // The matrix may have flipped the rect.
+            devRect.sort();
+
+            if (SkPathPriv::TooBigForMath(devRect) || !SkRectPriv::FitsInFixed(devRect)) {
+                paint.setColor(color);
+                this->drawRect(rects[start + i], paint);
+                continue;
+            }
+
+            // Non-AA rects round their edges to pixel centers; AA rects only get memset when their
+            // edges are already integral, so there's no partial coverage to blend.
+            std::optional<uint32_t> pixel;
+            if (canMemset && (!antiAlias || is_integral(devRect))) {
+                pixel = memset_color(color, mode);
+            }
+            if (pixel) {
+                SkIRect ir = devRect.round();
+                if (ir.intersect(clip)) {
+                    SkOpts::rect_memset32(fDst.writable_addr32(ir.fLeft, ir.fTop), *pixel,
+                                          ir.width(), fDst.rowBytes(), ir.height());
+                }
+                continue;
+            }
+
+            if (fRC->quickReject(devRect.roundOut())) {
+                continue;
+            }
+            if (!blitter || color != blitterColor) {
+                blitter.reset();
+                paint.setColor(color);
+                blitter.emplace(*this, nullptr, paint, SkRect::Make(clip));
+                blitterColor = color;
+            }
+            if (antiAlias) {
+                SkScan::AntiFillRect(devRect, *fRC, blitter->get());
+            } else {
+                SkScan::FillRect(devRect, *fRC, blitter->get());
+            }
+        }
+    }
+}
+
 static SkScalar fast_len(const SkVector& vec) {
     SkScalar x = SkScalarAbs(vec.fX);
     SkScalar y = SkScalarAbs(vec.fY);
@@ -887,6 +993,68 @@ bool Draw::drawRRectNinePatch(const SkRRect& rrect, const SkPaint& paint) const
     return false;
 }
 
+// Fills with more edges than this, covering at least kMinBandedFillHeight device rows, are split
+// into horizontal bands that are scan converted concurrently when an executor is available.
+static constexpr size_t kMinBandedFillPoints = 4096;
+static constexpr int kMinBandedFillHeight = 256;
+// Bands are never shorter than this, so that stepping the edges to each band's first row stays a
+// small fraction of the work, and there are never more than kMaxFillBands of them.
+static constexpr int kMinFillBandHeight = 64;
+static constexpr int kMaxFillBands = 32;
+
+// The band layout only depends on the clipped path bounds, never on the executor's thread count.
+static int fill_band_height(int height) {
+    int bandHeight = std::max(kMinFillBandHeight, (height + kMaxFillBands - 1) / kMaxFillBands);
+    return SkAlign4(bandHeight);
+}
+
+bool Draw::fillDevPathInBands(const SkPathRaw& raw,
+                              const SkPaint& paint,
+                              SkDrawCoverage drawCoverage) const {
+    // Aliased bands step shared edges to their first row, and anti-aliased bands are runs of the
+    // sparse accumulation rasterizer's independent strips, so both reproduce the serial fill
+    // exactly. AAA sets its edges up against the clip and keeps them sorted from row to row, so
+    // the fills it handles (and every fill under an anti-aliased clip) stay serial.
+    SkExecutor* executor = fCtx ? fCtx->executor() : nullptr;
+    if (!executor || raw.points().size() < kMinBandedFillPoints) {
+        return false;
+    }
+    const bool aa = paint.isAntiAlias();
+    if (aa ? !SkBandedAntiFillPath::CanBand(raw, *fRC) : !SkBandedFillPath::CanBand(raw)) {
+        return false;
+    }
+
+    SkIRect devBounds;
+    if (!devBounds.intersect(raw.bounds().roundOut(), fRC->getBounds()) ||
+        devBounds.height() < kMinBandedFillHeight) {
+        return false;
+    }
+
+    // Blitters carry per-draw scratch state, so every band chooses its own, just as the serial
+    // fill would. Bands cover disjoint rows of fDst, so they never write the same pixels.
+    auto fillBands = [&](const auto& fill) {
+        SkTaskGroup group(*executor);
+        group.batch(fill.bandCount(), [&](int i) {
+            SkBlitterSizedArena alloc;
+            SkBlitter* blitter = fBlitterChooser(fDst, *fCTM, paint, &alloc, drawCoverage,
+                                                 fRC->clipShader(),
+                                                 SkSurfacePropsCopyOrDefault(fProps),
+                                                 raw.bounds());
+            if (blitter) {
+                fill.fillBand(i, blitter);
+            }
+        });
+        group.wait();
+    };
+    const int bandHeight = fill_band_height(devBounds.height());
+    if (aa) {
+        fillBands(SkBandedAntiFillPath(raw, *fRC, bandHeight));
+    } else {
+        fillBands(SkBandedFillPath(raw, *fRC, bandHeight));
+    }
+    return true;
+}
+
 void Draw::drawDevPath(const SkPathRaw& raw,
                        const SkPaint& paint,
                        SkDrawCoverage drawCoverage,
@@ -896,6 +1064,11 @@ void Draw::drawDevPath(const SkPathRaw& raw,
         return;
     }
 
+    if (doFill && !customBlitter && !paint.getMaskFilter() &&
+        this->fillDevPathInBands(raw, paint, drawCoverage)) {
+        return;
+    }
+
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
@@ -114,6 +114,16 @@ public:
     void drawRect(const SkRect& rect, const SkPaint& paint) const {
         this->drawRect(rect, paint, nullptr, nullptr);
     }
+    /**
+     *  Fills each rect with the matching solid color, as if drawRect() were called for each with a
+     *  fill paint of that color, the blend mode, and anti-aliasing. Rects that land on whole pixels
+     *  of an 8888 destination are memset directly; the rest share one blitter per run of equal
+     *  colors.
+     */
+    void drawRectSet(SkSpan<const SkRect> rects,
+                     SkSpan<const SkColor4f> colors,
+                     SkBlendMode,
+                     bool antiAlias) const;
     void drawOval(const SkRect&, const SkPaint&) const;
     void drawRRect(const SkRRect&, const SkPaint&) const;
     // Specialized draw for RRect that only draws if it is nine-patchable.
@@ -219,6 +229,14 @@ private:
                      SkDrawCoverage drawCoverage,
                      SkBlitter* customBlitter,
                      bool doFill) const;
+    /**
+     *  Fills a large device-space path by scan converting horizontal bands of it concurrently on
+     *  the context's executor, producing the same pixels as the serial fill. Returns false, having
+     *  drawn nothing, if there is no executor, or the fill is inverse, convex, or too small to be
+     *  worth splitting. Anti-aliased fills are only banded when they would use the sparse
+     *  accumulation rasterizer under a non-anti-aliased clip.
+     */
+    bool fillDevPathInBands(const SkPathRaw&, const SkPaint&, SkDrawCoverage) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -16,6 +16,8 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkTime.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -253,10 +255,12 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
         return result;
     }
 
-    result = this->onFilterImage(context);
-
     if (context.backend()->cache()) {
-        context.backend()->cache()->set(key, this, result);
+        const double start = SkTime::GetNSecs();
+        result = this->onFilterImage(context);
+        context.backend()->cache()->set(key, this, result, SkTime::GetNSecs() - start);
+    } else {
+        result = this->onFilterImage(context);
     }
 
     return result;
@@ -380,11 +384,50 @@ std::optional<skif::LayerSpace<SkIRect>> SkImageFilter_Base::getChildOutputLayer
                        : contentBounds;
 }
 
+float SkImageFilter_Base::getChildMaxLayerBlurSigma(int index,
+                                                    const skif::Mapping& mapping) const {
+    const SkImageFilter* childFilter = this->getInput(index);
+    return childFilter ? as_IFB(childFilter)->onGetMaxLayerBlurSigma(mapping) : 0.f;
+}
+
+float SkImageFilter_Base::onGetMaxLayerBlurSigma(const skif::Mapping& mapping) const {
+    float maxSigma = 0.f;
+    for (int i = 0; i < this->countInputs(); ++i) {
+        maxSigma = std::max(maxSigma, this->getChildMaxLayerBlurSigma(i, mapping));
+    }
+    return maxSigma;
+}
+
 skif::FilterResult SkImageFilter_Base::getChildOutput(int index, const skif::Context& ctx) const {
     const SkImageFilter* input = this->getInput(index);
     return input ? as_IFB(input)->filterImage(ctx) : ctx.source();
 }
 
+void SkImageFilter_Base::getChildOutputs(SkSpan<const skif::Context> contexts,
+                                         SkSpan<skif::FilterResult> outputs) const {
+    SkASSERT(contexts.size() == outputs.size());
+    SkASSERT(SkToInt(contexts.size()) <= this->countInputs());
+
+    int filterCount = 0;
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        filterCount += this->getInput(SkToInt(i)) ? 1 : 0;
+    }
+    if (filterCount < 2) {
+        // Null children just return the source, so there is nothing to overlap.
+        for (size_t i = 0; i < contexts.size(); ++i) {
+            outputs[i] = this->getChildOutput(SkToInt(i), contexts[i]);
+        }
+        return;
+    }
+
+    // Each task writes a distinct element of 'outputs'. The shared image filter cache is safe to
+    // use concurrently, so identical subgraphs reached from several children can still be reused,
+    // although two tasks reaching one at the same time may both compute it.
+    skif::Context::ForEach(contexts, [&](int i, const skif::Context& ctx) {
+        outputs[i] = this->getChildOutput(i, ctx);
+    });
+}
+
 void SkImageFilter_Base::PurgeCache() {
     auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo);
     if (cache) {
@@ -9,13 +9,15 @@
 
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkOnce.h"
-#include "src/base/SkTInternalLList.h"
+#include "src/base/SkTDPQueue.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkTDynamicHash.h"
 #include "src/core/SkTHash.h"
 
+#include <algorithm>
+#include <atomic>
 #include <vector>
 
 using namespace skia_private;
@@ -28,103 +30,213 @@ using namespace skia_private;
 
 namespace {
 
+// Results are spread over this many independently locked shards by the hash of their key, so that
+// threads filtering different content rarely wait on each other.
+static constexpr int kShardCount = 8;
+
+// Results are purged by GreedyDual-Size: each has a priority of the cache's "inflation" plus what
+// it cost to produce per byte, and the result with the lowest priority is purged first. Purging a
+// result raises the inflation to its priority, and each hit moves a result's priority up to the
+// current inflation, so results that are not used age out however expensive they were. Results
+// with the same priority (e.g. with no recorded cost) are purged least recently used first. The
+// inflation and the use count are shared by all the shards, so priorities compare across them.
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes) { }
     ~CacheImpl() override {
-        fLookup.foreach([&](Value* v) { delete v; });
+        for (Shard& shard : fShards) {
+            shard.fLookup.foreach([&](Value* v) { delete v; });
+        }
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult& image,
-              const SkImageFilter* filter)
-            : fKey(key), fImage(image), fFilter(filter) {}
+              const SkImageFilter* filter, double recomputeNanos)
+            : fKey(key), fImage(image), fFilter(filter), fRecomputeNanos(recomputeNanos)
+            , fBytes(image.image() ? image.image()->getSize() : 0) {}
 
         Key fKey;
         skif::FilterResult fImage;
         const SkImageFilter* fFilter;
+        const double fRecomputeNanos;
+        const size_t fBytes;
+        double fPriority = 0;
+        uint64_t fLastUse = 0;
+        int fQueueIndex = -1;
+
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
         static uint32_t Hash(const Key& key) {
             return SkChecksum::Hash32(&key, sizeof(Key));
         }
-        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
+        static bool Less(Value* const& a, Value* const& b) {
+            return a->fPriority < b->fPriority ||
+                   (a->fPriority == b->fPriority && a->fLastUse < b->fLastUse);
+        }
+        static int* QueueIndex(Value* const& v) { return &v->fQueueIndex; }
     };
 
     bool get(const Key& key, skif::FilterResult* result) const override {
         SkASSERT(result);
 
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
-            }
+        Shard& shard = this->shardFor(key);
+        SkAutoMutexExclusive mutex(shard.fMutex);
+        if (Value* v = shard.fLookup.find(key)) {
+            this->use(v);
+            shard.fQueue.priorityDidChange(v);
 
+            shard.fStats.fHits += 1;
+            shard.fStats.fBytesSaved += v->fBytes;
+            shard.fStats.fRecomputeNanosSaved += v->fRecomputeNanos;
             *result = v->fImage;
             return true;
         }
+        shard.fStats.fMisses += 1;
         return false;
     }
 
+    using SkImageFilterCache::set;
     void set(const Key& key, const SkImageFilter* filter,
-             const skif::FilterResult& result) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            this->removeInternal(v);
-        }
-        Value* v = new Value(key, result, filter);
-        fLookup.add(v);
-        fLRU.addToHead(v);
-        fCurrentBytes += result.image() ? result.image()->getSize() : 0;
-        if (auto* values = fImageFilterValues.find(filter)) {
-            values->push_back(v);
-        } else {
-            fImageFilterValues.set(filter, {v});
-        }
-
-        while (fCurrentBytes > fMaxBytes) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            if (tail == v) {
+             const skif::FilterResult& result, double recomputeNanos) override {
+        Shard& shard = this->shardFor(key);
+        Value* v = new Value(key, result, filter, recomputeNanos);
+        {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (Value* existing = shard.fLookup.find(key)) {
+                this->removeInternal(&shard, existing);
+            }
+            this->use(v);
+            shard.fLookup.add(v);
+            shard.fQueue.insert(v);
+            fCurrentBytes.fetch_add(v->fBytes, std::memory_order_relaxed);
+            if (auto* values = shard.fImageFilterValues.find(filter)) {
+                values->push_back(v);
+            } else {
+                shard.fImageFilterValues.set(filter, {v});
+            }
+        }
+
+        // Purge until we fit, but keep the result that was just added. Once the shard is unlocked
+        // another thread may replace or purge 'v', so it is only known by its key from here on.
+        while (fCurrentBytes.load(std::memory_order_relaxed) > fMaxBytes) {
+            if (!this->purgeLowestPriority(key)) {
                 break;
             }
-            this->removeInternal(tail);
         }
     }
 
     void purge() override {
-        SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            while (shard.fQueue.count() > 0) {
+                this->removeInternal(&shard, shard.fQueue.peek());
+            }
         }
     }
 
     void purgeByImageFilter(const SkImageFilter* filter) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        auto* values = fImageFilterValues.find(filter);
-        if (!values) {
-            return;
-        }
-        for (Value* v : *values) {
-            // We set the filter to be null so that removeInternal() won't delete from values while
-            // we're iterating over it.
-            v->fFilter = nullptr;
-            this->removeInternal(v);
-        }
-        fImageFilterValues.remove(filter);
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            auto* values = shard.fImageFilterValues.find(filter);
+            if (!values) {
+                continue;
+            }
+            for (Value* v : *values) {
+                // We set the filter to be null so that removeInternal() won't delete from values
+                // while we're iterating over it.
+                v->fFilter = nullptr;
+                this->removeInternal(&shard, v);
+            }
+            shard.fImageFilterValues.remove(filter);
+        }
+    }
+
+    SkDEBUGCODE(int count() const override {
+        int count = 0;
+        for (const Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            count += shard.fLookup.count();
+        }
+        return count;
+    })
+
+    Stats stats() const override {
+        Stats stats;
+        for (const Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            stats.fHits += shard.fStats.fHits;
+            stats.fMisses += shard.fStats.fMisses;
+            stats.fBytesSaved += shard.fStats.fBytesSaved;
+            stats.fRecomputeNanosSaved += shard.fStats.fRecomputeNanosSaved;
+        }
+        return stats;
     }
 
-    SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
-    void removeInternal(Value* v) {
+    struct Shard {
+        mutable SkMutex                                     fMutex;
+        SkTDynamicHash<Value, Key>                          fLookup;
+        SkTDPQueue<Value*, Value::Less, Value::QueueIndex>  fQueue;
+        // Value* always points to an item in fLookup.
+        THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+        Stats                                               fStats;
+    };
+
+    Shard& shardFor(const Key& key) const {
+        return fShards[((uint64_t)Value::Hash(key) * kShardCount) >> 32];
+    }
+
+    // Gives 'v' the highest priority its cost allows. Its shard must be locked.
+    void use(Value* v) const {
+        v->fPriority = fInflation.load(std::memory_order_relaxed) +
+                       v->fRecomputeNanos / std::max<size_t>(v->fBytes, 1);
+        v->fLastUse = fUseCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Purges the result with the lowest priority of all the shards' lowest, other than the one
+    // for 'keep'. Returns false if there was nothing to purge.
+    bool purgeLowestPriority(const Key& keep) {
+        Shard* lowestShard = nullptr;
+        double lowestPriority = 0;
+        uint64_t lowestLastUse = 0;
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (shard.fQueue.count() == 0 || shard.fQueue.peek()->fKey == keep) {
+                continue;
+            }
+            const Value* v = shard.fQueue.peek();
+            if (!lowestShard || v->fPriority < lowestPriority ||
+                (v->fPriority == lowestPriority && v->fLastUse < lowestLastUse)) {
+                lowestShard = &shard;
+                lowestPriority = v->fPriority;
+                lowestLastUse = v->fLastUse;
+            }
+        }
+        if (!lowestShard) {
+            return false;
+        }
+
+        // The shard may have changed since we looked, but its lowest is still a fine choice.
+        SkAutoMutexExclusive mutex(lowestShard->fMutex);
+        if (lowestShard->fQueue.count() == 0 || lowestShard->fQueue.peek()->fKey == keep) {
+            return true;
+        }
+        Value* v = lowestShard->fQueue.peek();
+        double inflation = fInflation.load(std::memory_order_relaxed);
+        while (inflation < v->fPriority &&
+               !fInflation.compare_exchange_weak(inflation, v->fPriority,
+                                                 std::memory_order_relaxed)) {
+        }
+        this->removeInternal(lowestShard, v);
+        return true;
+    }
+
+    void removeInternal(Shard* shard, Value* v) {
         if (v->fFilter) {
-            if (auto* values = fImageFilterValues.find(v->fFilter)) {
+            if (auto* values = shard->fImageFilterValues.find(v->fFilter)) {
                 if (values->size() == 1 && (*values)[0] == v) {
-                    fImageFilterValues.remove(v->fFilter);
+                    shard->fImageFilterValues.remove(v->fFilter);
                 } else {
                     for (auto it = values->begin(); it != values->end(); ++it) {
                         if (*it == v) {
@@ -135,19 +247,18 @@ private:
                 }
             }
         }
-        fCurrentBytes -= v->fImage.image() ? v->fImage.image()->getSize() : 0;
-        fLRU.remove(v);
-        fLookup.remove(v->fKey);
+        fCurrentBytes.fetch_sub(v->fBytes, std::memory_order_relaxed);
+        shard->fQueue.remove(v);
+        shard->fLookup.remove(v->fKey);
         delete v;
     }
+
 private:
-    SkTDynamicHash<Value, Key>                          fLookup;
-    mutable SkTInternalLList<Value>                     fLRU;
-    // Value* always points to an item in fLookup.
-    THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
-    size_t                                              fMaxBytes;
-    size_t                                              fCurrentBytes;
-    mutable SkMutex                                     fMutex;
+    mutable Shard                                       fShards[kShardCount];
+    const size_t                                        fMaxBytes;
+    std::atomic<size_t>                                 fCurrentBytes{0};
+    std::atomic<double>                                 fInflation{0};
+    mutable std::atomic<uint64_t>                       fUseCount{0};
 };
 
 } // namespace
@@ -70,12 +70,32 @@ public:
     virtual bool get(const SkImageFilterCacheKey& key,
                      skif::FilterResult* result) const = 0;
     // 'filter' is included in the caching to allow the purging of all of an image filter's cached
-    // results when it is destroyed.
+    // results when it is destroyed. 'recomputeNanos' is how long it took to produce 'result'; when
+    // the cache is full, results that are cheap to recompute for their size are purged first.
     virtual void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
-                     const skif::FilterResult& result) = 0;
+                     const skif::FilterResult& result, double recomputeNanos) = 0;
+    void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
+             const skif::FilterResult& result) {
+        this->set(key, filter, result, /*recomputeNanos=*/0);
+    }
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
+
+    struct Stats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        // The size of the results returned by hits, and the time it took to produce them.
+        uint64_t fBytesSaved = 0;
+        double   fRecomputeNanosSaved = 0;
+
+        double hitRate() const {
+            uint64_t lookups = fHits + fMisses;
+            return lookups ? (double)fHits / lookups : 0;
+        }
+    };
+    // Totals over every get() since the cache was created.
+    virtual Stats stats() const = 0;
 };
 
 #endif
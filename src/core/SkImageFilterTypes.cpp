@@ -13,6 +13,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
@@ -35,6 +36,7 @@
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
@@ -183,8 +185,8 @@ std::optional<LayerSpace<SkMatrix>> periodic_axis_transform(
 class RasterBackend : public Backend {
 public:
 
-    RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType)
-            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType) {}
+    RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType, SkExecutor* executor)
+            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType, executor) {}
 
     sk_sp<SkDevice> makeDevice(SkISize size,
                                sk_sp<SkColorSpace> colorSpace,
@@ -215,15 +217,70 @@ public:
 
 Backend::Backend(sk_sp<SkImageFilterCache> cache,
                  const SkSurfaceProps& surfaceProps,
-                 const SkColorType colorType)
+                 const SkColorType colorType,
+                 SkExecutor* executor)
         : fCache(std::move(cache))
         , fSurfaceProps(surfaceProps)
-        , fColorType(colorType) {}
+        , fColorType(colorType)
+        , fExecutor(executor) {}
 
 Backend::~Backend() = default;
 
-sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType) {
-    return sk_make_sp<RasterBackend>(surfaceProps, colorType);
+sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps,
+                                 SkColorType colorType,
+                                 SkExecutor* executor) {
+    return sk_make_sp<RasterBackend>(surfaceProps, colorType, executor);
+}
+
+void Context::ForEach(SkSpan<const Context> contexts,
+                      const std::function<void(int, const Context&)>& fn) {
+    SkExecutor* executor = contexts.empty() ? nullptr : contexts[0].executor();
+    if (!executor || contexts.size() < 2) {
+        for (size_t i = 0; i < contexts.size(); ++i) {
+            fn(SkToInt(i), contexts[i]);
+        }
+        return;
+    }
+
+    // Stats are plain counters, so each task records into its own copy.
+    skia_private::TArray<Stats> taskStats;
+    taskStats.push_back_n(SkToInt(contexts.size()));
+    {
+        SkTaskGroup group(*executor);
+        group.batch(SkToInt(contexts.size()), [&](int i) {
+            SkASSERT(contexts[i].executor() == executor);
+            Context taskContext = contexts[i];
+            taskContext.fStats = contexts[i].fStats ? &taskStats[i] : nullptr;
+            fn(i, taskContext);
+        });
+    }
+
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        if (Stats* stats = contexts[i].fStats) {
+            stats->fNumVisitedImageFilters += taskStats[i].fNumVisitedImageFilters;
+            stats->fNumCacheHits += taskStats[i].fNumCacheHits;
+            stats->fNumOffscreenSurfaces += taskStats[i].fNumOffscreenSurfaces;
+            stats->fNumShaderClampedDraws += taskStats[i].fNumShaderClampedDraws;
+            stats->fNumShaderBasedTilingDraws += taskStats[i].fNumShaderBasedTilingDraws;
+        }
+    }
+}
+
+void Context::forEachRowBand(int top, int bottom, const std::function<void(int, int)>& fn) const {
+    static constexpr int kRowsPerBand = 32;
+
+    const int bandCount = std::max(bottom - top + kRowsPerBand - 1, 0) / kRowsPerBand;
+    auto band = [&](int i) {
+        const int bandTop = top + i * kRowsPerBand;
+        fn(bandTop, std::min(bandTop + kRowsPerBand, bottom));
+    };
+    if (SkExecutor* executor = this->executor(); executor && bandCount > 1) {
+        SkTaskGroup(*executor).batch(bandCount, band);
+    } else {
+        for (int i = 0; i < bandCount; ++i) {
+            band(i);
+        }
+    }
 }
 
 void Stats::dumpStats() const {
@@ -2196,6 +2253,13 @@ FilterResult FilterResult::Builder::blur(const LayerSpace<SkSize>& sigma) {
         srcRelativeOutput.outset(PixelSpace<SkISize>({1, 1}));
     }
 
+    // The low-res image is layer space scaled by (1/invScaleX, 1/invScaleY) and translated, so
+    // its pixels sit on a grid anchored at the layer origin. Blurs that resample align to that
+    // grid, which keeps tiles of the same layer consistent with each other.
+    SkIPoint srcOrigin = {
+            sk_float_round2int(lowResImage.fTransform.rc(0,2) * invScaleX),
+            sk_float_round2int(lowResImage.fTransform.rc(1,2) * invScaleY)};
+
     sk_sp<SkSpecialImage> lowResBlur = lowResImage.refImage();
     SkIRect blurOutputBounds = SkIRect(srcRelativeOutput);
     SkTileMode tileMode = lowResImage.tileMode();
@@ -2207,6 +2271,7 @@ FilterResult FilterResult::Builder::blur(const LayerSpace<SkSize>& sigma) {
         // earlier modification of `srcRelativeOutput`. This offset is to align the SkBlurAlgorithm
         // output bounds with the adjusted source image.
         blurOutputBounds.offset(1, 1);
+        srcOrigin -= {1, 1};
         tileMode = SkTileMode::kClamp;
     }
 
@@ -2214,7 +2279,8 @@ FilterResult FilterResult::Builder::blur(const LayerSpace<SkSize>& sigma) {
                                  lowResBlur,
                                  SkIRect::MakeSize(lowResBlur->dimensions()),
                                  tileMode,
-                                 blurOutputBounds);
+                                 blurOutputBounds,
+                                 srcOrigin);
     if (!lowResBlur) {
         // The blur output bounds may exceed max texture size even if the source image did not.
         // TODO(b/377932106): Can we handle this more gracefully by rendering a smaller image and
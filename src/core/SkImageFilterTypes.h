@@ -30,6 +30,7 @@
 #include "src/core/SkSpecialImage.h"
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <utility>
 
@@ -38,6 +39,7 @@ class SkBitmap;
 class SkBlender;
 class SkBlurEngine;
 class SkDevice;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageFilterCache;
@@ -1123,18 +1125,27 @@ public:
 
     SkImageFilterCache* cache() const { return fCache.get(); }
 
+    // If not null, independent branches of the filter DAG may be evaluated concurrently on this
+    // executor. Only backends whose devices, images, and cache can be used from several threads
+    // at once should provide one.
+    SkExecutor* executor() const { return fExecutor; }
+
 protected:
     Backend(sk_sp<SkImageFilterCache> cache,
             const SkSurfaceProps& surfaceProps,
-            const SkColorType colorType);
+            const SkColorType colorType,
+            SkExecutor* executor = nullptr);
 
 private:
     sk_sp<SkImageFilterCache> fCache;
     SkSurfaceProps fSurfaceProps;
     SkColorType fColorType;
+    SkExecutor* fExecutor;
 };
 
-sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType);
+sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps,
+                                 SkColorType colorType,
+                                 SkExecutor* executor = nullptr);
 
 // Stats for a single image filter evaluation
 struct Stats {
@@ -1198,6 +1209,20 @@ public:
     // the output of the inner DAG as the "source" for the outer DAG.
     const FilterResult& source() const { return fSource; }
 
+    // The backend's executor for evaluating independent inputs concurrently, or null if the DAG
+    // is evaluated serially on the calling thread.
+    SkExecutor* executor() const { return fBackend->executor(); }
+
+    // Calls fn(i, contexts[i]) for each context, concurrently on the executor of the contexts'
+    // backend when there is one. Every call is given a copy of its context that records into
+    // separate Stats, which are added to the original context's Stats before this returns.
+    static void ForEach(SkSpan<const Context> contexts,
+                        const std::function<void(int, const Context&)>& fn);
+
+    // Calls fn(top, bottom) for consecutive bands of rows that together cover [top, bottom),
+    // concurrently on the backend's executor when there is one. Bands must write disjoint pixels
+    // and must not depend on the order in which they are processed.
+    void forEachRowBand(int top, int bottom, const std::function<void(int, int)>& fn) const;
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
@@ -11,6 +11,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 
@@ -127,6 +128,14 @@ public:
     using MatrixCapability = skif::MatrixCapability;
     MatrixCapability getCTMCapability() const;
 
+    /**
+     *  Returns the largest blur sigma, in the layer space defined by 'mapping', that any filter in
+     *  this graph applies along either axis. This is 0 when the graph does not blur.
+     */
+    float getMaxLayerBlurSigma(const skif::Mapping& mapping) const {
+        return this->onGetMaxLayerBlurSigma(mapping);
+    }
+
     uint32_t uniqueID() const { return fUniqueID; }
 
     static SkFlattenable::Type GetFlattenableType() {
@@ -189,6 +198,9 @@ protected:
             int index,
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const;
+    // Helper function to calculate getMaxLayerBlurSigma() of a specific child filter, returning 0
+    // if the child filter is null.
+    float getChildMaxLayerBlurSigma(int index, const skif::Mapping& mapping) const;
 
     // Helper function for recursing through the filter DAG. It automatically evaluates the input
     // image filter at 'index' using the given context. If the input image filter is null, it
@@ -199,6 +211,12 @@ protected:
     // `withNewDesiredOutput`.
     skif::FilterResult getChildOutput(int index, const skif::Context& ctx) const;
 
+    // Evaluates getChildOutput(i, contexts[i]) into outputs[i] for the first contexts.size()
+    // children. When the contexts have an executor and at least two of those children are
+    // non-null filters, the children are evaluated concurrently.
+    void getChildOutputs(SkSpan<const skif::Context> contexts,
+                         SkSpan<skif::FilterResult> outputs) const;
+
 private:
     friend class SkImageFilter;
     // For PurgeCache()
@@ -299,6 +317,13 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const = 0;
 
+    /**
+     *  Return the largest layer-space blur sigma applied by this filter or by any of its inputs.
+     *  The default returns the maximum over the inputs, evaluated with the same 'mapping'. Filters
+     *  that blur, or that change the mapping seen by their inputs, must override this.
+     */
+    virtual float onGetMaxLayerBlurSigma(const skif::Mapping& mapping) const;
+
     skia_private::AutoSTArray<2, sk_sp<SkImageFilter>> fInputs;
 
     bool fUsesSrcInput;
@@ -76,6 +76,10 @@ std::optional<skif::LayerSpace<SkIRect>> SkLocalMatrixImageFilter::onGetOutputLa
     return this->getChildOutputLayerBounds(0, this->localMapping(mapping), contentBounds);
 }
 
+float SkLocalMatrixImageFilter::onGetMaxLayerBlurSigma(const skif::Mapping& mapping) const {
+    return this->getChildMaxLayerBlurSigma(0, this->localMapping(mapping));
+}
+
 SkRect SkLocalMatrixImageFilter::computeFastBounds(const SkRect& bounds) const {
     // In onGet[Input|Output]LayerBounds, there is a Mapping that can be adjusted by the
     // local matrix, so their layer-space parameters do not need to be modified. Since
@@ -57,6 +57,8 @@ private:
             const skif::Mapping&,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    float onGetMaxLayerBlurSigma(const skif::Mapping&) const override;
+
     skif::Mapping localMapping(const skif::Mapping&) const;
 
     // NOTE: This is not a ParameterSpace<SkMatrix> like that of SkMatrixTransformImageFilter.
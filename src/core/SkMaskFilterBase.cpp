@@ -228,7 +228,8 @@ bool SkMaskFilterBase::filterRRect(const SkRRect& devRRect,
     if (!patch.has_value()) {
         return false;
     }
-    draw_nine(patch->fMask, patch->fOuterRect, patch->fCenter, true, clip, blitter);
+    draw_nine(patch->fMask, patch->fOuterRect, patch->fCenter, patch->centerIsCovered(), clip,
+              blitter);
     return true;
 }
 
@@ -247,8 +248,8 @@ SkMaskFilterBase::FilterReturn SkMaskFilterBase::filterRects(SkSpan<const SkRect
             break;
 
         case FilterReturn::kTrue:
-            draw_nine(patch->fMask, patch->fOuterRect, patch->fCenter, 1 == devRects.size(), clip,
-                      blitter);
+            draw_nine(patch->fMask, patch->fOuterRect, patch->fCenter,
+                      1 == devRects.size() && patch->centerIsCovered(), clip, blitter);
             break;
 
         case FilterReturn::kUnimplemented:
@@ -134,6 +134,10 @@ protected:
         NinePatch(NinePatch&&) = delete;  // the transfer of fCache makes this not work
         ~NinePatch();
 
+        // Whether the area stretched from the center row and column needs to be filled. Outer
+        // blurs leave the interior of the shape uncovered, while other styles cover it fully.
+        bool centerIsCovered() const { return *fMask.getAddr8(fCenter.x(), fCenter.y()) != 0; }
+
         SkMask      fMask;      // fBounds must have [0,0] in its top-left
         SkIRect     fOuterRect; // width/height must be >= fMask.fBounds'
         SkIPoint    fCenter;    // identifies center row/col for stretching
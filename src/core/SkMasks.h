@@ -47,6 +47,12 @@ public:
     // The alpha mask may be used in other decoding modes
     uint32_t getAlphaMask() const { return fAlpha.mask; }
 
+    // Getters for each component's mask, to extract components from many pixels at once
+    const MaskInfo& redInfo() const { return fRed; }
+    const MaskInfo& greenInfo() const { return fGreen; }
+    const MaskInfo& blueInfo() const { return fBlue; }
+    const MaskInfo& alphaInfo() const { return fAlpha; }
+
 private:
     const MaskInfo fRed;
     const MaskInfo fGreen;
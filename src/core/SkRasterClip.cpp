@@ -9,11 +9,21 @@
 
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkClipOp.h"
+#include "include/core/SkFourByteTag.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
+#include "include/private/SkIDChangeListener.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkMutex.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkRegionPriv.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkTHash.h"
+
+#include <cstdint>
 
 class SkBlitter;
 
@@ -154,7 +164,7 @@ bool SkRasterClip::op(const SkRect& localRect, const SkMatrix& matrix, SkClipOp
 
     const bool isScaleTrans = matrix.isScaleTranslate();
     if (!isScaleTrans) {
-        return this->op(SkPath::Rect(localRect), matrix, op, doAA);
+        return this->opPath(SkPath::Rect(localRect), matrix, op, doAA, /*cacheAA=*/false);
     }
 
     SkRect devRect = matrix.mapRect(localRect);
@@ -179,13 +189,125 @@ bool SkRasterClip::op(const SkRect& localRect, const SkMatrix& matrix, SkClipOp
 }
 
 bool SkRasterClip::op(const SkRRect& rrect, const SkMatrix& matrix, SkClipOp op, bool doAA) {
-    return this->op(SkPath::RRect(rrect), matrix, op, doAA);
+    return this->opPath(SkPath::RRect(rrect), matrix, op, doAA, /*cacheAA=*/false);
+}
+
+uint64_t SkMakeResourceCacheSharedIDForAAClipPath(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('a', 'a', 'c', 'p');
+    return (sharedID << 32) | pathGenID;
+}
+
+namespace {
+static unsigned gAAClipPathKeyNamespaceLabel;
+
+// Identifies the anti-aliased clip built from a path, drawn with a matrix, within some bounds.
+struct AAClipPathKey : public SkResourceCache::Key {
+public:
+    AAClipPathKey(const SkPath& path, const SkMatrix& matrix, const SkIRect& bounds)
+            : fGenID(path.getGenerationID())
+            , fFillType(static_cast<int32_t>(path.getFillType()))
+            , fScaleX(matrix.getScaleX()), fSkewX(matrix.getSkewX()), fTransX(matrix.getTranslateX())
+            , fSkewY(matrix.getSkewY()), fScaleY(matrix.getScaleY()), fTransY(matrix.getTranslateY())
+            , fBounds(bounds) {
+        this->init(&gAAClipPathKeyNamespaceLabel, SkMakeResourceCacheSharedIDForAAClipPath(fGenID),
+                   sizeof(fGenID) + sizeof(fFillType) + 6 * sizeof(SkScalar) + sizeof(fBounds));
+    }
+
+    uint32_t fGenID;
+    int32_t  fFillType;
+    SkScalar fScaleX, fSkewX, fTransX,
+             fSkewY, fScaleY, fTransY;
+    SkIRect  fBounds;
+};
+
+struct AAClipPathRec : public SkResourceCache::Rec {
+    AAClipPathRec(const AAClipPathKey& key, const SkAAClip& clip) : fKey(key), fClip(clip) {}
+
+    AAClipPathKey fKey;
+    SkAAClip      fClip;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fClip.approximateBytesUsed(); }
+    const char* getCategory() const override { return "aaclip-path"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextClip) {
+        const AAClipPathRec& rec = static_cast<const AAClipPathRec&>(baseRec);
+        // The clip's runs are ref-counted, so this just shares them with the cache.
+        *static_cast<SkAAClip*>(contextClip) = rec.fClip;
+        return true;
+    }
+};
+
+// The generation IDs of the paths that have an AAClipPathInvalidator, so that a path clipped at
+// many matrices or bounds gets one listener rather than one per cached clip.
+static SkMutex& listened_gen_ids_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
+}
+
+static skia_private::THashSet<uint32_t>& listened_gen_ids() {
+    static auto& genIDs = *(new skia_private::THashSet<uint32_t>);
+    return genIDs;
+}
+
+// Purges every clip cached for a path once that path changes or is deleted.
+class AAClipPathInvalidator : public SkIDChangeListener {
+public:
+    explicit AAClipPathInvalidator(uint32_t pathGenID) : fPathGenID(pathGenID) {}
+
+private:
+    void changed() override {
+        {
+            SkAutoMutexExclusive lock(listened_gen_ids_mutex());
+            listened_gen_ids().remove(fPathGenID);
+        }
+        SkResourceCache::PostPurgeSharedID(SkMakeResourceCacheSharedIDForAAClipPath(fPathGenID));
+    }
+
+    uint32_t fPathGenID;
+};
+}  // namespace
+
+// Sets clip to the anti-aliased coverage of path drawn with matrix, limited to bounds. Clipping to
+// the same path at the same matrix is common (e.g. every frame of an animation that doesn't move
+// its clip), so if cacheAA is set the result is cached and shared rather than scan-converted again.
+static bool set_aa_path(SkAAClip* clip, const SkPath& path, const SkMatrix& matrix,
+                        const SkIRect& bounds, bool cacheAA) {
+    if (cacheAA && !path.isVolatile() && !path.isEmpty() && !matrix.hasPerspective() &&
+        !bounds.isEmpty()) {
+        AAClipPathKey key(path, matrix, bounds);
+        if (SkResourceCache::Find(key, AAClipPathRec::Visitor, clip)) {
+            return !clip->isEmpty();
+        }
+        clip->setPath(path.makeTransform(matrix), bounds, /*doAA=*/true);
+        bool needsListener;
+        {
+            SkAutoMutexExclusive lock(listened_gen_ids_mutex());
+            needsListener = !listened_gen_ids().contains(key.fGenID);
+            if (needsListener) {
+                listened_gen_ids().add(key.fGenID);
+            }
+        }
+        if (needsListener) {
+            SkPathPriv::AddGenIDChangeListener(path,
+                                               sk_make_sp<AAClipPathInvalidator>(key.fGenID));
+        }
+        SkResourceCache::Add(new AAClipPathRec(key, *clip));
+        return !clip->isEmpty();
+    }
+    return clip->setPath(path.makeTransform(matrix), bounds, /*doAA=*/true);
 }
 
 bool SkRasterClip::op(const SkPath& path, const SkMatrix& matrix, SkClipOp op, bool doAA) {
-    AUTO_RASTERCLIP_VALIDATE(*this);
+    return this->opPath(path, matrix, op, doAA, /*cacheAA=*/true);
+}
 
-    SkPath devPath = path.makeTransform(matrix);
+// Paths made up just for this op (e.g. for a rotated rect or an rrect) are never seen again, so
+// they pass cacheAA = false rather than add a cache entry and a listener that only get purged.
+bool SkRasterClip::opPath(const SkPath& path, const SkMatrix& matrix, SkClipOp op, bool doAA,
+                          bool cacheAA) {
+    AUTO_RASTERCLIP_VALIDATE(*this);
 
     // Since op is either intersect or difference, the clip is always shrinking; that means we can
     // always use our current bounds as the limiting factor for region/aaclip operations.
@@ -197,13 +319,23 @@ bool SkRasterClip::op(const SkPath& path, const SkMatrix& matrix, SkClipOp op, b
             this->convertToAA();
         }
         if (fIsBW) {
-            fBW.setPath(devPath, SkRegion(this->getBounds()));
+            fBW.setPath(path.makeTransform(matrix), SkRegion(this->getBounds()));
+        } else if (doAA) {
+            set_aa_path(&fAA, path, matrix, this->getBounds(), cacheAA);
         } else {
-            fAA.setPath(devPath, this->getBounds(), doAA);
+            fAA.setPath(path.makeTransform(matrix), this->getBounds(), doAA);
         }
         return this->updateCacheAndReturnNonEmpty();
+    } else if (doAA) {
+        // Like the unanti-aliased case, combine with a whole SkRasterClip, so a BW clip only
+        // becomes anti-aliased if the path's coverage isn't just a hard-edged rect.
+        SkRasterClip clip;
+        clip.fIsBW = false;
+        set_aa_path(&clip.fAA, path, matrix, this->getBounds(), cacheAA);
+        (void)clip.updateCacheAndReturnNonEmpty();
+        return this->op(clip, op);
     } else {
-        return this->op(SkRasterClip(devPath, this->getBounds(), doAA), op);
+        return this->op(SkRasterClip(path.makeTransform(matrix), this->getBounds(), doAA), op);
     }
 }
 
@@ -17,12 +17,20 @@
 #include "include/private/base/SkNoncopyable.h"
 #include "src/core/SkAAClip.h"
 
+#include <cstdint>
+
 class SkBlitter;
 class SkMatrix;
 class SkPath;
 class SkRRect;
 enum class SkClipOp;
 
+/**
+ *  Anti-aliased clips built from a path are cached with this shared ID, and purged when the path
+ *  with this generation ID changes or is deleted.
+ */
+uint64_t SkMakeResourceCacheSharedIDForAAClipPath(uint32_t pathGenID);
+
 /**
  *  Wraps a SkRegion and SkAAClip, so we have a single object that can represent either our
  *  BW or antialiased clips.
@@ -68,6 +76,8 @@ public:
     bool op(const SkRegion&, SkClipOp);
     bool op(const SkRect&, const SkMatrix& matrix, SkClipOp, bool doAA);
     bool op(const SkRRect&, const SkMatrix& matrix, SkClipOp, bool doAA);
+    // The path is one the caller keeps, e.g. from SkCanvas::clipPath(), so unless it is volatile
+    // its anti-aliased coverage is cached for clipping to it again.
     bool op(const SkPath&, const SkMatrix& matrix, SkClipOp, bool doAA);
     bool op(sk_sp<SkShader>);
 
@@ -129,6 +139,7 @@ private:
     void convertToAA();
 
     bool op(const SkRasterClip&, SkClipOp);
+    bool opPath(const SkPath&, const SkMatrix&, SkClipOp, bool doAA, bool cacheAA);
 };
 
 class [[nodiscard]] SkAutoRasterClipValidate : SkNoncopyable {
@@ -19,7 +19,7 @@
 #include "src/core/SkCachedData.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkMessageBus.h"
-#include "src/core/SkSynchronizedResourceCache.h"
+#include "src/core/SkShardedResourceCache.h"
 #include "src/core/SkTHash.h"
 
 #if defined(SK_USE_DISCARDABLE_SCALEDIMAGECACHE)
@@ -27,6 +27,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 
 using namespace skia_private;
 
@@ -140,6 +141,20 @@ bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     return false;
 }
 
+SkResourceCache::Rec* SkResourceCache::findShared(const Key& key) const {
+    Rec* const* found = fHash->find(key);
+    if (!found) {
+        return nullptr;
+    }
+    Rec* rec = *found;
+    // Avoid writing to the Rec (and so sharing its cache line between threads) when it is already
+    // marked.
+    if (!rec->fRecentlyUsed.load(std::memory_order_relaxed)) {
+        rec->fRecentlyUsed.store(true, std::memory_order_relaxed);
+    }
+    return rec;
+}
+
 static void make_size_str(size_t size, SkString* str) {
     const char suffix[] = { 'b', 'k', 'm', 'g', 't', 0 };
     int i = 0;
@@ -210,26 +225,41 @@ void SkResourceCache::remove(Rec* rec) {
     delete rec;
 }
 
+void SkResourceCache::GetPurgeLimits(bool discardable, size_t totalByteLimit,
+                                     size_t* byteLimit, int* countLimit) {
+    if (discardable) {
+        *countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        *byteLimit = UINT32_MAX;  // no limit based on bytes
+    } else {
+        *countLimit = SK_MaxS32; // no limit based on count
+        *byteLimit = totalByteLimit;
+    }
+}
+
 void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     size_t byteLimit;
     int    countLimit;
+    GetPurgeLimits(fDiscardableFactory != nullptr, fTotalByteLimit, &byteLimit, &countLimit);
 
-    if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
-        byteLimit = UINT32_MAX;  // no limit based on bytes
-    } else {
-        countLimit = SK_MaxS32; // no limit based on count
-        byteLimit = fTotalByteLimit;
+    if (forcePurge) {
+        byteLimit = 0;
+        countLimit = 0;
     }
+    this->purgeUntilUnder(byteLimit, countLimit);
+}
 
+void SkResourceCache::purgeUntilUnder(size_t byteLimit, int countLimit) {
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (fTotalBytesUsed < byteLimit && fCount < countLimit) {
             break;
         }
 
         Rec* prev = rec->fPrev;
-        if (rec->canBePurged()) {
+        if (rec->fRecentlyUsed.load(std::memory_order_relaxed)) {
+            // Found by findShared() since it was last moved, so it is not really this old.
+            this->moveToHead(rec);
+        } else if (rec->canBePurged()) {
             this->remove(rec);
         }
         rec = prev;
@@ -335,6 +365,7 @@ void SkResourceCache::release(Rec* rec) {
 }
 
 void SkResourceCache::moveToHead(Rec* rec) {
+    rec->fRecentlyUsed.store(false, std::memory_order_relaxed);
     if (fHead == rec) {
         return;
     }
@@ -461,16 +492,14 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-/** Must hold resource_cache_mutex() when calling. */
-static SkSynchronizedResourceCache* get_cache() {
-    static SkSynchronizedResourceCache* gResourceCache = nullptr;
-    if (nullptr == gResourceCache) {
+static SkShardedResourceCache* get_cache() {
 #if defined(SK_USE_DISCARDABLE_SCALEDIMAGECACHE)
-        gResourceCache = new SkSynchronizedResourceCache(SkDiscardableMemory::Create);
+    static SkShardedResourceCache* gResourceCache =
+            new SkShardedResourceCache(SkDiscardableMemory::Create);
 #else
-        gResourceCache = new SkSynchronizedResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+    static SkShardedResourceCache* gResourceCache =
+            new SkShardedResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
-    }
     return gResourceCache;
 }
 
@@ -11,6 +11,7 @@
 #include "include/private/base/SkDebug.h"
 #include "src/core/SkMessageBus.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -107,6 +108,9 @@ public:
     private:
         Rec*    fNext;
         Rec*    fPrev;
+        // Set when findShared() finds this Rec, since it cannot move it to the head of the list.
+        // Purging gives such a Rec a second chance instead of removing it.
+        std::atomic<bool> fRecentlyUsed{false};
 
         friend class SkResourceCache;
     };
@@ -277,6 +281,18 @@ private:
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    // Purges least recently used Recs (that can be purged) until fewer than byteLimit bytes and
+    // countLimit Recs remain.
+    void purgeUntilUnder(size_t byteLimit, int countLimit);
+    // The limits purgeAsNeeded() enforces on a cache that uses discardable memory or has a budget
+    // of totalByteLimit.
+    static void GetPurgeLimits(bool discardable, size_t totalByteLimit,
+                               size_t* byteLimit, int* countLimit);
+
+    // Looks up 'key' without changing the cache, so it may run concurrently with other calls to
+    // findShared(). It does not reorder the LRU list or check for purge messages; a hit marks the
+    // Rec as recently used instead.
+    Rec* findShared(const Key& key) const;
 
     // linklist management
     void moveToHead(Rec*);
@@ -291,5 +307,8 @@ private:
 #else
     void validate() const {}
 #endif
+
+    // Each shard of the global cache is an SkResourceCache.
+    friend class SkShardedResourceCache;
 };
 #endif
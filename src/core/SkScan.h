@@ -12,6 +12,7 @@
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/private/base/SkFixed.h"
+#include "include/private/base/SkNoncopyable.h"
 
 class SkBlitter;
 class SkPath;
@@ -19,6 +20,26 @@ struct SkPathRaw;
 class SkRasterClip;
 class SkRegion;
 
+/** Selects the rasterizer SkScan::AntiFillPath uses for non-inverse fills. */
+enum class SkAAFillAlgorithm {
+    kHeuristic,
+    kAnalytic,
+    kSparseAccumulation,
+};
+
+/** While in scope, overrides the default heuristic for fills drawn on the calling thread, so tests
+    and benches can compare the two rasterizers. Fills on other threads are not affected. Drawing
+    code must not use this.
+*/
+class [[nodiscard]] SkAutoAAFillAlgorithm : SkNoncopyable {
+public:
+    explicit SkAutoAAFillAlgorithm(SkAAFillAlgorithm);
+    ~SkAutoAAFillAlgorithm();
+
+private:
+    SkAAFillAlgorithm fPrev;
+};
+
 /** Defines a fixed-point rectangle, identical to the integer SkIRect, but its
     coordinates are treated as SkFixed rather than int32_t.
 */
@@ -73,6 +94,7 @@ public:
 
 private:
     friend class SkAAClip;
+    friend class SkBandedAntiFillPath;
     friend class SkRegion;
 
     static void FillIRect(const SkIRect&, const SkRegion* clip, SkBlitter*);
@@ -89,6 +111,12 @@ private:
     static void AntiHairLineRgn(SkSpan<const SkPoint>, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPathRaw&, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+
+    // Sparse accumulation rasterizer (see SkScan_AccumPath.cpp). It is faster than AAA for paths
+    // with very many edges per scan line, e.g. heavily self-overlapping winding fills.
+    static bool ShouldAccumulateFill(const SkPathRaw&, const SkIRect& pathIR, bool forceRLE);
+    static void AccumulateFillPath(const SkPathRaw&, SkBlitter* blitter, const SkIRect& pathIR,
+                                   const SkIRect& clipBounds);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -9,9 +9,19 @@
 #define SkScanPriv_DEFINED
 
 #include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRegion.h"
+#include "include/private/base/SkTArray.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkEdgeBuilder.h"
 #include "src/core/SkScan.h"
 
+class SkEdge;
+class SkRasterClip;
+struct SkPathRaw;
+
 // controls how much we super-sample (when we use that scan convertion)
 #define SK_SUPERSAMPLE_SHIFT    2
 
@@ -33,6 +43,101 @@ private:
     const SkIRect*      fClipRect;
 };
 
+/**
+ *  Scan converts an aliased fill in horizontal bands of rows, which may be filled concurrently.
+ *  The edges are built once, as SkScan::FillPath() builds them, and binned by band up front. Each
+ *  band then steps its edges to its first row, so together the bands blit exactly the pixels
+ *  SkScan::FillPath() does.
+ */
+class SkBandedFillPath {
+public:
+    // Inverse and known convex fills are walked differently, and are not banded.
+    static bool CanBand(const SkPathRaw&);
+
+    SkBandedFillPath(const SkPathRaw&, const SkRasterClip&, int bandHeight);
+
+    int bandCount() const { return fBandStarts.size() - 1; }
+
+    // Blits the rows of band i. Concurrent calls must use different blitters.
+    void fillBand(int i, SkBlitter*) const;
+
+private:
+    const SkRasterClip& fRasterClip;
+    SkRegion            fClip;
+    SkBasicEdgeBuilder  fBuilder;
+    SkIRect             fIR;
+    bool                fIRPreClipped = false;
+    SkPathFillType      fFillType;
+    int                 fBandHeight;
+    int                 fTop = 0;
+    int                 fBottom = 0;
+
+    // The edges touching band i are fBandEdges[fBandStarts[i]] up to fBandEdges[fBandStarts[i+1]].
+    skia_private::TArray<int>     fBandStarts;
+    skia_private::TArray<SkEdge*> fBandEdges;
+};
+
+/**
+ *  The sparse accumulation rasterizer's setup for one fill (see SkScan_AccumPath.cpp): the path
+ *  flattened into lines relative to the drawn bounds, binned into strips of kStripHeight rows.
+ *  Each strip is accumulated from its own lines only, so strips may be filled concurrently.
+ */
+class SkSparseAccumulation {
+public:
+    static constexpr int kStripHeight = 16;
+
+    struct Line {
+        SkPoint fP0, fP1;
+    };
+
+    SkSparseAccumulation(const SkPathRaw&, const SkIRect& pathIR, const SkIRect& clipBounds);
+
+    int stripCount() const { return fStripStarts.size() - 1; }
+
+    // Blits the rows of strips [first, first + count). Concurrent calls must use different
+    // blitters.
+    void fillStrips(int first, int count, SkBlitter*) const;
+
+private:
+    SkIRect                    fDrawBounds = SkIRect::MakeEmpty();
+    bool                       fEvenOdd;
+    skia_private::TArray<Line> fLines;
+
+    // The lines touching strip s are fLines[fBinned[i]] for i in [fStripStarts[s],
+    // fStripStarts[s+1]).
+    skia_private::TArray<int> fStripStarts;
+    skia_private::TArray<int> fBinned;
+};
+
+/**
+ *  Scan converts an anti-aliased fill in horizontal bands of rows, which may be filled
+ *  concurrently. Only fills that SkScan::AntiFillPath() gives to the sparse accumulation
+ *  rasterizer are banded. Each band is a run of its strips, so together the bands blit exactly the
+ *  pixels SkScan::AntiFillPath() does.
+ */
+class SkBandedAntiFillPath {
+public:
+    // Whether SkScan::AntiFillPath() would use the sparse accumulation rasterizer for the path,
+    // given the calling thread's SkAAFillAlgorithm. Anti-aliased clips are always filled by AAA.
+    static bool CanBand(const SkPathRaw&, const SkRasterClip&);
+
+    // bandHeight is rounded up to whole strips.
+    SkBandedAntiFillPath(const SkPathRaw&, const SkRasterClip&, int bandHeight);
+
+    int bandCount() const {
+        return (fAccumulation.stripCount() + fBandStrips - 1) / fBandStrips;
+    }
+
+    // Blits the rows of band i. Concurrent calls must use different blitters.
+    void fillBand(int i, SkBlitter*) const;
+
+private:
+    SkRegion             fClip;
+    SkIRect              fIR;
+    SkSparseAccumulation fAccumulation;
+    int                  fBandStrips;
+};
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
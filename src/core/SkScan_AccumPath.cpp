@@ -0,0 +1,466 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkScalar.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkPathRaw.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkScanPriv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/*
+
+Sparse accumulation rasterizer.
+
+AAA (SkScan_AAAPath.cpp) walks a sorted list of active edges from scan line to scan line. Its cost
+grows with the number of edges crossing each scan line times the number of scan lines, plus the
+cost of keeping the active list sorted. Paths with heavy self-overlap (dense stars, GIS outlines,
+hatching built from one path) can have thousands of active edges on every row.
+
+This rasterizer instead flattens the path into line segments and lets every segment deposit its
+signed area contribution into an accumulation buffer, one float per pixel. A prefix sum along each
+row then yields the signed coverage (the winding number, with fractional values where edges pass
+through a pixel), which the fill rule turns into an alpha. No sorting is involved, and the cost of a
+segment only depends on the pixels it touches.
+
+The path is processed in horizontal strips of kStripHeight rows so the accumulation buffer stays in
+cache. Segments are binned into the strips they overlap, and only the span of each row that some
+segment touched is scanned, so empty parts of a strip cost nothing. Each finished row is handed to
+the blitter as alpha runs through blitAntiH(). Strips share nothing but the binned lines, so
+SkBandedAntiFillPath fills runs of them concurrently with the same result.
+
+Where two edges cross inside the same pixel the summed area differs slightly from the exact
+coverage of the fill rule, which is the usual trade-off of accumulation rasterizers.
+
+*/
+
+namespace {
+
+constexpr int kStripHeight = SkSparseAccumulation::kStripHeight;
+
+// Maximum distance, in pixels, between a flattened curve and its line segments. This keeps the
+// coverage error of flattening within about 16/255.
+constexpr float kFlattenTolerance = 1.0f / 16;
+constexpr int kMaxCurveSegments = 1 << 10;
+
+using Line = SkSparseAccumulation::Line;
+
+// Collects the lines relative to the top left of the drawn bounds. Lines that are entirely above,
+// below or right of the drawn bounds can't change any drawn pixel and are dropped. Lines entirely
+// left of them only add to the winding of the rows they cross, so they are moved onto the left
+// edge, where they deposit it all in column 0.
+class LineCollector {
+public:
+    explicit LineCollector(const SkIRect& drawBounds)
+            : fOffset(SkPoint::Make(drawBounds.fLeft, drawBounds.fTop))
+            , fMaxX(drawBounds.width())
+            , fMaxY(drawBounds.height()) {}
+
+    void addLine(SkPoint p0, SkPoint p1) {
+        p0 -= fOffset;
+        p1 -= fOffset;
+        if (p0.fY == p1.fY || std::max(p0.fY, p1.fY) <= 0 || std::min(p0.fY, p1.fY) >= fMaxY ||
+            std::min(p0.fX, p1.fX) >= fMaxX) {
+            return;
+        }
+        if (std::max(p0.fX, p1.fX) <= 0) {
+            p0.fX = p1.fX = 0;
+        }
+        fLines.push_back({p0, p1});
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        // The deviation of an n-segment flattening is bounded by |P0 - 2P1 + P2| / (4n^2).
+        SkVector dd = pts[0] - pts[1] * 2 + pts[2];
+        int n = segment_count(dd.length() / (4 * kFlattenTolerance));
+        SkQuadCoeff quad(pts);
+        this->addFlattened(pts[0], pts[2], n, [&](float t) { return to_point(quad.eval(t)); });
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        // The deviation of an n-segment flattening is bounded by 3/4 * max|second difference|/n^2.
+        SkVector dd0 = pts[0] - pts[1] * 2 + pts[2],
+                 dd1 = pts[1] - pts[2] * 2 + pts[3];
+        float dd = std::max(dd0.length(), dd1.length());
+        int n = segment_count(0.75f * dd / kFlattenTolerance);
+        SkCubicCoeff cubic(pts);
+        this->addFlattened(pts[0], pts[3], n, [&](float t) { return to_point(cubic.eval(t)); });
+    }
+
+    skia_private::TArray<Line>& lines() { return fLines; }
+
+private:
+    static int segment_count(float nSquared) {
+        if (!(nSquared > 1)) {  // also catches NaN
+            return 1;
+        }
+        return std::min(SkScalarCeilToInt(std::sqrt(nSquared)), kMaxCurveSegments);
+    }
+
+    template <typename EvalFn>
+    void addFlattened(SkPoint start, SkPoint end, int n, EvalFn&& eval) {
+        const float dt = 1.0f / n;
+        SkPoint prev = start;
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = eval(i * dt);
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, end);
+    }
+
+    const SkPoint fOffset;
+    const float fMaxX;
+    const float fMaxY;
+    skia_private::TArray<Line> fLines;
+};
+
+void collect_lines(const SkPathRaw& path, LineCollector* collector) {
+    SkPathEdgeIter iter(path);
+    SkAutoConicToQuads quadder;
+    while (auto e = iter.next()) {
+        switch (e.fEdge) {
+            case SkPathEdgeIter::Edge::kLine:
+                collector->addLine(e.fPts[0], e.fPts[1]);
+                break;
+            case SkPathEdgeIter::Edge::kQuad:
+                collector->addQuad(e.fPts);
+                break;
+            case SkPathEdgeIter::Edge::kConic: {
+                const SkPoint* quadPts =
+                        quadder.computeQuads(e.fPts, iter.conicWeight(), kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    collector->addQuad(quadPts);
+                    quadPts += 2;
+                }
+            } break;
+            case SkPathEdgeIter::Edge::kCubic:
+                collector->addCubic(e.fPts);
+                break;
+        }
+    }
+}
+
+// Accumulation buffer for one strip of the drawn bounds. Each row has width + 2 cells so that the
+// cell to the right of the rightmost pixel a segment touches is always addressable.
+class StripAccumulator {
+public:
+    explicit StripAccumulator(int width)
+            : fStride(width + 2)
+            , fWidth(width)
+            , fCells(fStride * kStripHeight) {
+        sk_bzero(fCells.get(), fStride * kStripHeight * sizeof(float));
+        this->resetTouched();
+    }
+
+    void resetTouched() {
+        std::fill_n(fMinX, kStripHeight, fStride);
+        std::fill_n(fMaxX, kStripHeight, -1);
+    }
+
+    // Accumulates the part of the line between stripTop and stripTop + kStripHeight.
+    void accumulate(const Line& line, int stripTop) {
+        SkPoint p0 = line.fP0,
+                p1 = line.fP1;
+        float dir = 1;
+        if (p0.fY > p1.fY) {
+            std::swap(p0, p1);
+            dir = -1;
+        }
+        const float dxdy = (p1.fX - p0.fX) / (p1.fY - p0.fY);
+        const float top = std::max(p0.fY, (float)stripTop),
+                    bot = std::min(p1.fY, (float)(stripTop + kStripHeight));
+        if (!(top < bot)) {
+            return;
+        }
+
+        // The line's own x range bounds the rounding of the steps.
+        const float minX = std::min(p0.fX, p1.fX),
+                    maxX = std::max(p0.fX, p1.fX);
+        float x = SkTPin(p0.fX + dxdy * (top - p0.fY), minX, maxX);
+        const int y0 = (int)top,
+                  y1 = std::min((int)std::ceil(bot), stripTop + kStripHeight);
+        for (int y = y0; y < y1; ++y) {
+            const float dy = std::min((float)(y + 1), bot) - std::max((float)y, top);
+            const float xNext = SkTPin(x + dxdy * dy, minX, maxX);
+            const float d = dy * dir;
+            this->accumulateRow(y - stripTop, x, xNext, d);
+            x = xNext;
+        }
+    }
+
+    // Turns the accumulated area of row into alpha runs and hands them to the blitter at device
+    // row y. Cell x lands on device column x + dx.
+    void blitRow(int row, int y, int dx, bool evenOdd, SkBlitter* blitter, SkAlpha* alpha,
+                 int16_t* runs) {
+        const int minX = fMinX[row],
+                  maxX = fMaxX[row];
+        if (minX > maxX) {
+            return;
+        }
+        float* cells = fCells.get() + row * fStride;
+
+        float sum = 0;
+        const int start = minX,
+                  stop = std::min(maxX + 1, fWidth);
+        int runStart = 0;
+        for (int x = start; x < stop; ++x) {
+            sum += cells[x];
+            const SkAlpha a = coverage_to_alpha(sum, evenOdd);
+            const int i = x - start;
+            if (i == 0 || a != alpha[runStart]) {
+                if (i != 0) {
+                    runs[runStart] = SkToS16(i - runStart);
+                }
+                alpha[i] = a;
+                runStart = i;
+            }
+        }
+        if (start < stop) {
+            runs[runStart] = SkToS16(stop - start - runStart);
+            runs[stop - start] = 0;
+            blitter->blitAntiH(start + dx, y, alpha, runs);
+        }
+        this->clearRow(row);
+    }
+
+    void clearRow(int row) {
+        if (fMinX[row] <= fMaxX[row]) {
+            float* cells = fCells.get() + row * fStride;
+            std::fill(cells + fMinX[row], cells + fMaxX[row] + 1, 0.0f);
+        }
+    }
+
+private:
+    static SkAlpha coverage_to_alpha(float winding, bool evenOdd) {
+        float c = std::abs(winding);
+        if (evenOdd) {
+            c -= 2 * std::floor(c * 0.5f);
+            if (c > 1) {
+                c = 2 - c;
+            }
+        } else {
+            c = std::min(c, 1.0f);
+        }
+        return SkToU8((int)(c * 255 + 0.5f));
+    }
+
+    void touch(int row, int lo, int hi) {
+        fMinX[row] = std::min(fMinX[row], lo);
+        fMaxX[row] = std::max(fMaxX[row], hi);
+    }
+
+    // Adds the signed area of the segment from (x, row) to (xNext, row + dy), where d = +/-dy.
+    // The part of the segment left of column 0 adds its whole share of d to cell 0, and the part
+    // right of the last column only reaches cells that are never blitted, so it is dropped.
+    void accumulateRow(int row, float x, float xNext, float d) {
+        float* cells = fCells.get() + row * fStride;
+        float x0 = std::min(x, xNext),
+              x1 = std::max(x, xNext);
+        if (x1 <= 0) {
+            cells[0] += d;
+            this->touch(row, 0, 0);
+            return;
+        }
+        if (x0 >= fWidth) {
+            return;
+        }
+        if (x0 < 0 || x1 > fWidth) {
+            const float s = d / (x1 - x0);
+            const float dLeft = x0 < 0 ? -x0 * s : 0,
+                        dRight = x1 > fWidth ? (x1 - fWidth) * s : 0;
+            if (x0 < 0) {
+                cells[0] += dLeft;
+                this->touch(row, 0, 0);
+                x0 = 0;
+            }
+            x1 = std::min(x1, (float)fWidth);
+            d -= dLeft + dRight;
+            x = x0;
+            xNext = x1;
+        }
+        const float x0Floor = std::floor(x0);
+        const int x0i = (int)x0Floor;
+        const int x1i = (int)std::ceil(x1);
+
+        if (x1i <= x0i + 1) {
+            // The segment stays within one pixel column.
+            const float xMid = 0.5f * (x + xNext) - x0Floor;
+            cells[x0i]     += d - d * xMid;
+            cells[x0i + 1] += d * xMid;
+            this->touch(row, x0i, x0i + 1);
+            return;
+        }
+
+        const float s = 1 / (x1 - x0);
+        const float x0f = x0 - x0Floor;
+        const float a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+        const float x1f = x1 - x1i + 1;
+        const float am = 0.5f * s * x1f * x1f;
+        cells[x0i] += d * a0;
+        if (x1i == x0i + 2) {
+            cells[x0i + 1] += d * (1 - a0 - am);
+        } else {
+            const float a1 = s * (1.5f - x0f);
+            cells[x0i + 1] += d * (a1 - a0);
+            for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+                cells[xi] += d * s;
+            }
+            const float a2 = a1 + (x1i - x0i - 3) * s;
+            cells[x1i - 1] += d * (1 - a2 - am);
+        }
+        cells[x1i] += d * am;
+        this->touch(row, x0i, x1i);
+    }
+
+    const int fStride;
+    const int fWidth;
+    skia_private::AutoTMalloc<float> fCells;
+    int fMinX[kStripHeight];
+    int fMaxX[kStripHeight];
+};
+
+}  // namespace
+
+static thread_local SkAAFillAlgorithm sAAFillAlgorithm = SkAAFillAlgorithm::kHeuristic;
+
+SkAutoAAFillAlgorithm::SkAutoAAFillAlgorithm(SkAAFillAlgorithm algorithm)
+        : fPrev(sAAFillAlgorithm) {
+    sAAFillAlgorithm = algorithm;
+}
+
+SkAutoAAFillAlgorithm::~SkAutoAAFillAlgorithm() { sAAFillAlgorithm = fPrev; }
+
+bool SkScan::ShouldAccumulateFill(const SkPathRaw& path, const SkIRect& ir, bool forceRLE) {
+    switch (sAAFillAlgorithm) {
+        case SkAAFillAlgorithm::kAnalytic:
+            return false;
+        case SkAAFillAlgorithm::kSparseAccumulation:
+            return !path.isInverseFillType() && !forceRLE;
+        case SkAAFillAlgorithm::kHeuristic:
+            break;
+    }
+    // Inverse fills need the blitting above and below the path that AAA's callers do, and SkAAClip
+    // (forceRLE) wants AAA's exact runs. Convex paths never have more than two active edges.
+    if (path.isInverseFillType() || forceRLE || path.isKnownToBeConvex()) {
+        return false;
+    }
+    // This is the same threshold at which AAA stops computing edge intersections because there
+    // are already so many edges per scan line; that is where sorting starts to dominate.
+    constexpr size_t kMinPoints = 256;
+    const size_t points = path.points().size();
+    return points >= kMinPoints && points > SkToSizeT(ir.height()) * 2;
+}
+
+SkSparseAccumulation::SkSparseAccumulation(const SkPathRaw& path,
+                                           const SkIRect& ir,
+                                           const SkIRect& clipBounds)
+        : fEvenOdd(path.fillType() == SkPathFillType::kEvenOdd) {
+    SkASSERT(!path.isInverseFillType());
+    fStripStarts.push_back(0);
+    if (!fDrawBounds.intersect(ir, clipBounds)) {
+        return;
+    }
+
+    // Everything is relative to the drawn bounds, so a wide path under a small clip only costs
+    // the clipped width.
+    LineCollector collector(fDrawBounds);
+    collect_lines(path, &collector);
+    fLines = std::move(collector.lines());
+    if (fLines.empty()) {
+        return;
+    }
+
+    // Bin the lines into strips (a counting sort, so each strip's lines are contiguous).
+    const int height = fDrawBounds.height(),
+              stripCount = (height - 1) / kStripHeight + 1;
+    auto strip_range = [&](const Line& line, int* lo, int* hi) {
+        const float top = std::max(std::min(line.fP0.fY, line.fP1.fY), 0.0f),
+                    bot = std::min(std::max(line.fP0.fY, line.fP1.fY), (float)height);
+        *lo = (int)top / kStripHeight;
+        *hi = std::min(((int)std::ceil(bot) - 1) / kStripHeight, stripCount - 1);
+    };
+    fStripStarts.push_back_n(stripCount);
+    std::fill(fStripStarts.begin(), fStripStarts.end(), 0);
+    for (const Line& line : fLines) {
+        int lo, hi;
+        strip_range(line, &lo, &hi);
+        for (int s = lo; s <= hi; ++s) {
+            fStripStarts[s + 1]++;
+        }
+    }
+    for (int s = 0; s < stripCount; ++s) {
+        fStripStarts[s + 1] += fStripStarts[s];
+    }
+    fBinned.push_back_n(fStripStarts[stripCount]);
+    skia_private::AutoTMalloc<int> cursor(stripCount);
+    std::copy_n(fStripStarts.data(), stripCount, cursor.get());
+    for (int i = 0; i < fLines.size(); ++i) {
+        int lo, hi;
+        strip_range(fLines[i], &lo, &hi);
+        for (int s = lo; s <= hi; ++s) {
+            fBinned[cursor[s]++] = i;
+        }
+    }
+}
+
+void SkSparseAccumulation::fillStrips(int first, int count, SkBlitter* blitter) const {
+    SkASSERT(0 <= first && 0 <= count && first + count <= this->stripCount());
+    SkASSERT(blitter);
+    if (count == 0) {
+        return;
+    }
+
+    const int height = fDrawBounds.height(),
+              width = fDrawBounds.width();
+    StripAccumulator accumulator(width);
+    skia_private::AutoTMalloc<SkAlpha> alpha(width + 1);
+    skia_private::AutoTMalloc<int16_t> runs(width + 2);
+
+    for (int s = first; s < first + count; ++s) {
+        if (fStripStarts[s] == fStripStarts[s + 1]) {
+            continue;
+        }
+        const int stripTop = s * kStripHeight;
+        for (int i = fStripStarts[s]; i < fStripStarts[s + 1]; ++i) {
+            accumulator.accumulate(fLines[fBinned[i]], stripTop);
+        }
+        for (int row = 0; row < kStripHeight; ++row) {
+            if (stripTop + row < height) {
+                accumulator.blitRow(row, fDrawBounds.fTop + stripTop + row, fDrawBounds.fLeft,
+                                    fEvenOdd, blitter, alpha.get(), runs.get());
+            } else {
+                accumulator.clearRow(row);
+            }
+        }
+        accumulator.resetTouched();
+    }
+}
+
+void SkScan::AccumulateFillPath(const SkPathRaw& path,
+                                SkBlitter* blitter,
+                                const SkIRect& ir,
+                                const SkIRect& clipBounds) {
+    const SkSparseAccumulation accumulation(path, ir, clipBounds);
+    accumulation.fillStrips(0, accumulation.stripCount(), blitter);
+}
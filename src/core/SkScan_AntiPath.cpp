@@ -18,6 +18,7 @@
 #include "src/core/SkScan.h"
 #include "src/core/SkScanPriv.h"
 
+#include <algorithm>
 #include <cstdint>
 
 static SkIRect safeRoundOut(const SkRect& src) {
@@ -56,6 +57,23 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
            overflows_short_shift(rect.fBottom, shift);
 }
 
+// Our antialiasing can't handle a clip larger than 32767, so we restrict
+// the clip to that limit here. (the runs[] uses int16_t for its index).
+//
+// A more general solution (one that could also eliminate the need to
+// disable aa based on ir bounds (see overflows_short_shift) would be
+// to tile the clip/target...
+static const SkRegion* limit_clip(const SkRegion& origClip, SkRegion* storage) {
+    static const int32_t kMaxClipCoord = 32767;
+    const SkIRect& bounds = origClip.getBounds();
+    if (bounds.fRight > kMaxClipCoord || bounds.fBottom > kMaxClipCoord) {
+        SkIRect limit = { 0, 0, kMaxClipCoord, kMaxClipCoord };
+        storage->op(origClip, limit, SkRegion::kIntersect_Op);
+        return storage;
+    }
+    return &origClip;
+}
+
 void SkScan::AntiFillPath(const SkPathRaw& path, const SkRegion& origClip,
                           SkBlitter* blitter, bool forceRLE) {
     if (origClip.isEmpty()) {
@@ -89,23 +107,8 @@ void SkScan::AntiFillPath(const SkPathRaw& path, const SkRegion& origClip,
         return;
     }
 
-    // Our antialiasing can't handle a clip larger than 32767, so we restrict
-    // the clip to that limit here. (the runs[] uses int16_t for its index).
-    //
-    // A more general solution (one that could also eliminate the need to
-    // disable aa based on ir bounds (see overflows_short_shift) would be
-    // to tile the clip/target...
     SkRegion tmpClipStorage;
-    const SkRegion* clipRgn = &origClip;
-    {
-        static const int32_t kMaxClipCoord = 32767;
-        const SkIRect& bounds = origClip.getBounds();
-        if (bounds.fRight > kMaxClipCoord || bounds.fBottom > kMaxClipCoord) {
-            SkIRect limit = { 0, 0, kMaxClipCoord, kMaxClipCoord };
-            tmpClipStorage.op(origClip, limit, SkRegion::kIntersect_Op);
-            clipRgn = &tmpClipStorage;
-        }
-    }
+    const SkRegion* clipRgn = limit_clip(origClip, &tmpClipStorage);
     // for here down, use clipRgn, not origClip
 
     SkScanClipper   clipper(blitter, clipRgn, ir);
@@ -127,7 +130,11 @@ void SkScan::AntiFillPath(const SkPathRaw& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    if (SkScan::ShouldAccumulateFill(path, ir, forceRLE)) {
+        SkScan::AccumulateFillPath(path, blitter, ir, clipRgn->getBounds());
+    } else {
+        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    }
 
     if (isInverse) {
         sk_blit_below(blitter, ir, *clipRgn);
@@ -153,3 +160,49 @@ void SkScan::AntiFillPath(const SkPathRaw& raw, const SkRasterClip& clip, SkBlit
         AntiFillPath(raw, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkBandedAntiFillPath::CanBand(const SkPathRaw& raw, const SkRasterClip& clip) {
+    // These are the checks SkScan::AntiFillPath() makes before it picks a rasterizer.
+    if (!clip.isBW() || clip.isEmpty() || raw.isInverseFillType()) {
+        return false;
+    }
+    const SkIRect ir = safeRoundOut(raw.bounds());
+    SkIRect clippedIR;
+    if (ir.isEmpty() || !clippedIR.intersect(ir, clip.getBounds()) ||
+        rect_overflows_short_shift(clippedIR, SK_SUPERSAMPLE_SHIFT)) {
+        return false;
+    }
+    return SkScan::ShouldAccumulateFill(raw, ir, /*forceRLE=*/false);
+}
+
+static SkRegion limited_clip(const SkRegion& clip) {
+    SkRegion storage;
+    return *limit_clip(clip, &storage);
+}
+
+SkBandedAntiFillPath::SkBandedAntiFillPath(const SkPathRaw& raw,
+                                           const SkRasterClip& clip,
+                                           int bandHeight)
+        : fClip(limited_clip(clip.bwRgn()))
+        , fIR(safeRoundOut(raw.bounds()))
+        , fAccumulation(raw, fIR, fClip.getBounds())
+        , fBandStrips((bandHeight + SkSparseAccumulation::kStripHeight - 1) /
+                      SkSparseAccumulation::kStripHeight) {
+    SkASSERT(CanBand(raw, clip));
+    SkASSERT(bandHeight > 0);
+}
+
+void SkBandedAntiFillPath::fillBand(int i, SkBlitter* blitter) const {
+    SkASSERT(0 <= i && i < this->bandCount());
+    SkASSERT(blitter);
+    // Wrap the blitter as SkScan::AntiFillPath() does.
+    SkScanClipper clipper(blitter, &fClip, fIR);
+    if (clipper.getBlitter()) {
+        const int first = i * fBandStrips;
+        fAccumulation.fillStrips(first,
+                                 std::min(fBandStrips, fAccumulation.stripCount() - first),
+                                 clipper.getBlitter());
+    }
+}
@@ -19,6 +19,8 @@
 #include "include/private/base/SkMath.h"
 #include "include/private/base/SkPoint_impl.h"
 #include "include/private/base/SkSafe32.h"
+#include "include/private/base/SkTArray.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkTSort.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkEdge.h"
@@ -783,3 +785,186 @@ void SkScan::FillPath(const SkPathRaw& raw, const SkRasterClip& clip, SkBlitter*
     }
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkBandedFillPath::CanBand(const SkPathRaw& raw) {
+    return !raw.isInverseFillType() && !raw.isKnownToBeConvex();
+}
+
+template <typename EdgeType>
+static SkEdge* copy_edge(const SkEdge* edge, SkArenaAlloc* alloc) {
+    return alloc->make<EdgeType>(*static_cast<const EdgeType*>(edge));
+}
+
+static SkEdge* copy_edge(const SkEdge* edge, SkArenaAlloc* alloc) {
+    switch (edge->fEdgeType) {
+        case SkEdge::Type::kLine:  return copy_edge<SkEdge>(edge, alloc);
+        case SkEdge::Type::kQuad:  return copy_edge<SkQuadraticEdge>(edge, alloc);
+        case SkEdge::Type::kCubic: return copy_edge<SkCubicEdge>(edge, alloc);
+    }
+    SkUNREACHABLE;
+}
+
+// Steps the edge to row y the way walk_edges() would have by the time it reaches that row.
+// Returns false if the edge ends before y.
+static bool advance_edge_to(SkEdge* edge, int y) {
+    while (edge->fLastY < y) {
+        if (!edge->hasNextSegment() || !edge->nextSegment()) {
+            return false;
+        }
+    }
+    if (edge->fFirstY < y) {
+        // walk_edges() adds fDxDy once per row, so wrap around the same way it would.
+        uint32_t dx = (uint32_t)(y - edge->fFirstY) * (uint32_t)edge->fDxDy;
+        edge->fX = (SkFixed)((uint32_t)edge->fX + dx);
+        edge->fFirstY = y;
+    }
+    return true;
+}
+
+// Returns the last row of the edge, including all of its remaining segments.
+static int last_row(const SkEdge* edge, SkArenaAlloc* alloc) {
+    if (!edge->hasNextSegment()) {
+        return edge->fLastY;
+    }
+    SkEdge* copy = copy_edge(edge, alloc);
+    int lastY = copy->fLastY;
+    while (copy->hasNextSegment() && copy->nextSegment()) {
+        lastY = copy->fLastY;
+    }
+    return lastY;
+}
+
+SkBandedFillPath::SkBandedFillPath(const SkPathRaw& raw,
+                                   const SkRasterClip& clip,
+                                   int bandHeight)
+        : fRasterClip(clip), fFillType(raw.fillType()), fBandHeight(bandHeight) {
+    SkASSERT(CanBand(raw));
+    SkASSERT(bandHeight > 0);
+    fBandStarts.push_back(0);
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    // Set up the clip, bounds and edges exactly as SkScan::FillPath() does.
+    if (clip.isBW()) {
+        fClip = clip.bwRgn();
+    } else {
+        fClip.setRect(clip.getBounds());
+    }
+    SkRegion finiteClip;
+    if (clip_to_limit(fClip, &finiteClip)) {
+        fClip = finiteClip;
+    }
+    if (fClip.isEmpty()) {
+        return;
+    }
+
+    SkRect bounds = raw.bounds();
+    if (!SkRectPriv::MakeLargeS32().contains(bounds)) {
+        if (!bounds.intersect(SkRectPriv::MakeLargeS32())) {
+            bounds.setEmpty();
+        }
+        fIRPreClipped = true;
+    }
+    fIR = conservative_round_to_int(bounds);
+    const SkIRect& clipRect = fClip.getBounds();
+    if (fIR.isEmpty() || !SkIRect::Intersects(clipRect, fIR)) {
+        return;
+    }
+
+    // This is when SkScanClipper drops the clip rect.
+    const bool pathContainedInClip = fClip.isRect() && !fIRPreClipped && clipRect.contains(fIR);
+    const int count = fBuilder.buildEdges(raw, pathContainedInClip ? nullptr : &clipRect);
+    fTop = fIR.fTop;
+    fBottom = fIR.fBottom;
+    if (!pathContainedInClip) {
+        fTop = std::max(fTop, clipRect.fTop);
+        fBottom = std::min(fBottom, clipRect.fBottom);
+    }
+    if (count == 0 || fTop >= fBottom) {
+        return;
+    }
+
+    // Bin the edges by the bands their rows touch, counting them first so that every band's
+    // edges are contiguous.
+    const int bandCount = (fBottom - fTop + fBandHeight - 1) / fBandHeight;
+    SkEdge** edges = fBuilder.edgeList();
+    skia_private::TArray<int> firstBand(count), lastBand(count);
+    fBandStarts.push_back_n(bandCount);
+    std::fill(fBandStarts.begin(), fBandStarts.end(), 0);
+    {
+        SkSTArenaAlloc<256> alloc;
+        for (int i = 0; i < count; ++i) {
+            const int firstY = std::max(edges[i]->fFirstY, fTop);
+            const int lastY = std::min(last_row(edges[i], &alloc), fBottom - 1);
+            if (firstY > lastY) {
+                firstBand.push_back(0);
+                lastBand.push_back(-1);
+                continue;
+            }
+            firstBand.push_back((firstY - fTop) / fBandHeight);
+            lastBand.push_back((lastY - fTop) / fBandHeight);
+            for (int band = firstBand.back(); band <= lastBand.back(); ++band) {
+                fBandStarts[band + 1]++;
+            }
+        }
+    }
+    for (int band = 0; band < bandCount; ++band) {
+        fBandStarts[band + 1] += fBandStarts[band];
+    }
+    fBandEdges.push_back_n(fBandStarts.back(), (SkEdge*)nullptr);
+    skia_private::TArray<int> next(fBandStarts.data(), bandCount);
+    for (int i = 0; i < count; ++i) {
+        for (int band = firstBand[i]; band <= lastBand[i]; ++band) {
+            fBandEdges[next[band]++] = edges[i];
+        }
+    }
+}
+
+void SkBandedFillPath::fillBand(int i, SkBlitter* blitter) const {
+    SkASSERT(0 <= i && i < this->bandCount());
+    SkASSERT(blitter);
+    const int top = fTop + i * fBandHeight;
+    const int bottom = std::min(top + fBandHeight, fBottom);
+
+    // Copy the band's edges and step them to its first row, leaving the shared ones untouched.
+    SkSTArenaAlloc<4096> alloc;
+    skia_private::STArray<64, SkEdge*> list;
+    for (int e = fBandStarts[i]; e < fBandStarts[i + 1]; ++e) {
+        SkEdge* edge = copy_edge(fBandEdges[e], &alloc);
+        if (advance_edge_to(edge, top)) {
+            list.push_back(edge);
+        }
+    }
+    if (list.empty()) {
+        return;
+    }
+
+    SkEdge headEdge, tailEdge, *last;
+    SkEdge* edge = sort_edges(list.data(), list.size(), &last);
+
+    headEdge.fPrev = nullptr;
+    headEdge.fNext = edge;
+    headEdge.fFirstY = kEDGE_HEAD_Y;
+    headEdge.fX = SK_MinS32;
+    edge->fPrev = &headEdge;
+
+    tailEdge.fPrev = last;
+    tailEdge.fNext = nullptr;
+    tailEdge.fFirstY = kEDGE_TAIL_Y;
+    last->fNext = &tailEdge;
+
+    SkAAClipBlitter aaBlitter;
+    if (!fRasterClip.isBW()) {
+        aaBlitter.init(blitter, &fRasterClip.aaRgn());
+        blitter = &aaBlitter;
+    }
+    SkScanClipper clipper(blitter, &fClip, fIR, false, fIRPreClipped);
+    blitter = clipper.getBlitter();
+    if (blitter) {
+        walk_edges(&headEdge, fFillType, blitter, top, bottom, nullptr,
+                   fClip.getBounds().right());
+    }
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkShardedResourceCache.h"
+
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkDebug.h"
+#include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkMath.h"
+#include "src/core/SkCachedData.h"
+
+#include <algorithm>
+#include <cstdint>
+
+SkShardedResourceCache::SkShardedResourceCache(DiscardableFactory factory,
+                                               size_t byteLimit,
+                                               int shardCount)
+        : fDiscardableFactory(factory)
+        , fShardCount(shardCount)
+        , fShards(new Shard[shardCount])
+        , fTotalByteLimit(byteLimit) {
+    SkASSERT(shardCount > 0);
+    for (int i = 0; i < fShardCount; ++i) {
+        // The shards never purge on their own; purgeAsNeeded() enforces the budget across them.
+        fShards[i].fCache = std::make_unique<SkResourceCache>(SIZE_MAX);
+    }
+}
+
+SkShardedResourceCache::SkShardedResourceCache(DiscardableFactory factory, int shardCount)
+        : SkShardedResourceCache(factory, 0, shardCount) {}
+
+SkShardedResourceCache::SkShardedResourceCache(size_t byteLimit, int shardCount)
+        : SkShardedResourceCache(nullptr, byteLimit, shardCount) {}
+
+SkShardedResourceCache::~SkShardedResourceCache() = default;
+
+void SkShardedResourceCache::updateTotals(Shard* shard) {
+    const size_t bytesUsed = shard->fCache->fTotalBytesUsed;
+    const int count = shard->fCache->fCount;
+    // Unsigned wrap-around makes this a subtraction when the shard has shrunk.
+    fTotalBytesUsed.fetch_add(bytesUsed - shard->fBytesUsed, std::memory_order_relaxed);
+    fCount.fetch_add(count - shard->fCount, std::memory_order_relaxed);
+    shard->fBytesUsed = bytesUsed;
+    shard->fCount = count;
+}
+
+bool SkShardedResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
+    Shard& shard = this->shardFor(key);
+    {
+        // A hit marks the Rec as recently used instead of moving it to the head of the shard's
+        // LRU list, so lookups never block other readers of this shard.
+        SkAutoSharedMutexShared lock(shard.fMutex);
+        const Rec* rec = shard.fCache->findShared(key);
+        if (!rec) {
+            return false;
+        }
+        if (visitor(*rec, context)) {
+            return true;
+        }
+    }
+    // The visitor found the Rec stale. Removing it needs the lock exclusively, and by then another
+    // thread may have replaced it, so let the shard look it up (and call the visitor) again.
+    SkAutoSharedMutexExclusive lock(shard.fMutex);
+    bool found = shard.fCache->find(key, visitor, context);
+    this->updateTotals(&shard);
+    return found;
+}
+
+void SkShardedResourceCache::add(Rec* rec, void* payload) {
+    SkASSERT(rec);
+    Shard& shard = this->shardFor(rec->getKey());
+    {
+        SkAutoSharedMutexExclusive lock(shard.fMutex);
+        shard.fCache->add(rec, payload);
+        this->updateTotals(&shard);
+    }
+    // since the new rec may push us over-budget, we perform a purge check now
+    this->purgeAsNeeded();
+}
+
+void SkShardedResourceCache::purgeAsNeeded() {
+    size_t byteLimit;
+    int    countLimit;
+    SkResourceCache::GetPurgeLimits(fDiscardableFactory != nullptr, this->getTotalByteLimit(),
+                                    &byteLimit, &countLimit);
+
+    const unsigned start = fNextPurgeShard.fetch_add(1, std::memory_order_relaxed);
+    for (int i = 0; i < fShardCount; ++i) {
+        const size_t bytesUsed = this->getTotalBytesUsed();
+        const int count = fCount.load(std::memory_order_relaxed);
+        if (bytesUsed < byteLimit && count < countLimit) {
+            return;
+        }
+
+        Shard& shard = fShards[(start + i) % fShardCount];
+        SkAutoSharedMutexExclusive lock(shard.fMutex);
+        // Ask this shard to make up the whole overage; later shards only give up Recs if it
+        // could not.
+        const SkResourceCache* cache = shard.fCache.get();
+        size_t shardByteLimit = SIZE_MAX;
+        if (bytesUsed >= byteLimit) {
+            size_t excess = bytesUsed - byteLimit;
+            shardByteLimit = cache->fTotalBytesUsed > excess ? cache->fTotalBytesUsed - excess : 0;
+        }
+        int shardCountLimit = SK_MaxS32;
+        if (count >= countLimit) {
+            int excess = count - countLimit;
+            shardCountLimit = std::max(cache->fCount - excess, 0);
+        }
+        shard.fCache->purgeUntilUnder(shardByteLimit, shardCountLimit);
+        this->updateTotals(&shard);
+    }
+}
+
+void SkShardedResourceCache::visitAll(Visitor visitor, void* context) {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoSharedMutexShared lock(fShards[i].fMutex);
+        fShards[i].fCache->visitAll(visitor, context);
+    }
+}
+
+size_t SkShardedResourceCache::setTotalByteLimit(size_t newLimit) {
+    size_t prevLimit = fTotalByteLimit.exchange(newLimit, std::memory_order_relaxed);
+    if (newLimit < prevLimit) {
+        this->purgeAsNeeded();
+    }
+    return prevLimit;
+}
+
+size_t SkShardedResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
+    return fSingleAllocationByteLimit.exchange(newLimit, std::memory_order_relaxed);
+}
+
+size_t SkShardedResourceCache::getSingleAllocationByteLimit() const {
+    return fSingleAllocationByteLimit.load(std::memory_order_relaxed);
+}
+
+size_t SkShardedResourceCache::getEffectiveSingleAllocationByteLimit() const {
+    // 0 means the caller is asking for our default
+    size_t limit = this->getSingleAllocationByteLimit();
+
+    // if we're not discardable (i.e. we are fixed-budget) then cap the single-limit
+    // to our budget.
+    if (nullptr == fDiscardableFactory) {
+        size_t totalLimit = this->getTotalByteLimit();
+        limit = 0 == limit ? totalLimit : std::min(limit, totalLimit);
+    }
+    return limit;
+}
+
+void SkShardedResourceCache::purgeSharedID(uint64_t sharedID) {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoSharedMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->purgeSharedID(sharedID);
+        this->updateTotals(&fShards[i]);
+    }
+}
+
+void SkShardedResourceCache::purgeAll() {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoSharedMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->purgeAll();
+        this->updateTotals(&fShards[i]);
+    }
+}
+
+void SkShardedResourceCache::checkMessages() {
+    // Every shard has its own inbox, and so sees every purge message.
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoSharedMutexExclusive lock(fShards[i].fMutex);
+        fShards[i].fCache->checkMessages();
+        this->updateTotals(&fShards[i]);
+    }
+}
+
+SkCachedData* SkShardedResourceCache::newCachedData(size_t bytes) {
+    if (fDiscardableFactory) {
+        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+        return dm ? new SkCachedData(bytes, dm) : nullptr;
+    } else {
+        return new SkCachedData(sk_malloc_throw(bytes), bytes);
+    }
+}
+
+void SkShardedResourceCache::dump() const {
+    SkDebugf("SkShardedResourceCache: shards=%d count=%d bytes=%zu %s\n",
+             fShardCount, fCount.load(std::memory_order_relaxed), this->getTotalBytesUsed(),
+             fDiscardableFactory ? "discardable" : "malloc");
+}
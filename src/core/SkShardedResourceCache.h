@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkShardedResourceCache_DEFINED
+#define SkShardedResourceCache_DEFINED
+
+#include "src/base/SkSharedMutex.h"
+#include "src/core/SkResourceCache.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class SkCachedData;
+
+/**
+ *  A thread-safe SkResourceCache, split into independently locked shards so that threads looking
+ *  up different keys rarely wait on each other. Keys are assigned to shards by their hash, and
+ *  each shard keeps its own LRU list.
+ *
+ *  The byte (or, for discardable memory, count) budget covers all shards. It is enforced
+ *  approximately: when an add() pushes the cache over budget, Recs are purged from the least
+ *  recently used end of one shard after another until the cache is back within budget. Recs that
+ *  have been found since a purge last reached them are moved to the head instead, so the order
+ *  only approximates LRU.
+ */
+class SkShardedResourceCache {
+public:
+    using DiscardableFactory = SkResourceCache::DiscardableFactory;
+    using FindVisitor = SkResourceCache::FindVisitor;
+    using Key = SkResourceCache::Key;
+    using Rec = SkResourceCache::Rec;
+    using Visitor = SkResourceCache::Visitor;
+
+    static constexpr int kDefaultShardCount = 16;
+
+    SkShardedResourceCache(DiscardableFactory, int shardCount = kDefaultShardCount);
+    explicit SkShardedResourceCache(size_t byteLimit, int shardCount = kDefaultShardCount);
+    ~SkShardedResourceCache();
+
+    /**
+     *  See SkResourceCache::find(). Lookups only share their shard's lock with each other: a hit
+     *  marks the Rec as recently used, which purging reads, instead of reordering the shard's LRU
+     *  list. Only a Rec that the visitor finds stale takes the lock exclusively to remove it, and
+     *  the visitor may then be called a second time.
+     */
+    bool find(const Key&, FindVisitor, void* context);
+    void add(Rec*, void* payload = nullptr);
+    void visitAll(Visitor, void* context);
+
+    size_t getTotalBytesUsed() const { return fTotalBytesUsed.load(std::memory_order_relaxed); }
+    size_t getTotalByteLimit() const { return fTotalByteLimit.load(std::memory_order_relaxed); }
+    size_t setTotalByteLimit(size_t newLimit);
+
+    size_t setSingleAllocationByteLimit(size_t maximumAllocationSize);
+    size_t getSingleAllocationByteLimit() const;
+    size_t getEffectiveSingleAllocationByteLimit() const;
+
+    void purgeSharedID(uint64_t sharedID);
+    void purgeAll();
+    void checkMessages();
+
+    DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+
+    SkCachedData* newCachedData(size_t bytes);
+
+    int shardCount() const { return fShardCount; }
+
+    void dump() const;
+
+private:
+    struct Shard {
+        SkSharedMutex                    fMutex;
+        std::unique_ptr<SkResourceCache> fCache;
+        // What this shard last contributed to the cache totals.
+        size_t                           fBytesUsed = 0;
+        int                              fCount = 0;
+    };
+
+    SkShardedResourceCache(DiscardableFactory, size_t byteLimit, int shardCount);
+
+    Shard& shardFor(const Key& key) const {
+        return fShards[((uint64_t)key.hash() * fShardCount) >> 32];
+    }
+
+    // Must hold the shard's mutex exclusively.
+    void updateTotals(Shard*);
+    void purgeAsNeeded();
+
+    const DiscardableFactory  fDiscardableFactory;
+    const int                 fShardCount;
+    std::unique_ptr<Shard[]>  fShards;
+
+    std::atomic<size_t>       fTotalBytesUsed{0};
+    std::atomic<int>          fCount{0};
+    std::atomic<size_t>       fTotalByteLimit;
+    std::atomic<size_t>       fSingleAllocationByteLimit{0};
+    // Where the next purge starts, so that shards take turns giving up their oldest Recs.
+    std::atomic<int>          fNextPurgeShard{0};
+};
+
+#endif
@@ -16,6 +16,7 @@
 #include "include/core/SkTypeface.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTFitsIn.h"
+#include "src/base/SkSharedMutex.h"
 #include "src/core/SkGlyph.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkReadBuffer.h"
@@ -444,7 +445,7 @@ void SkStrike::updateMemoryUsage(size_t increase) {
     if (increase > 0) {
         // fRemoved and the cache's total memory are managed under the cache's lock. This allows
         // them to be accessed under LRU operation.
-        SkAutoMutexExclusive lock{fStrikeCache->fLock};
+        SkAutoSharedMutexExclusive lock{fStrikeCache->fLock};
         fMemoryUsed += increase;
         if (!fRemoved) {
             fStrikeCache->fTotalMemoryUsed += increase;
@@ -21,6 +21,7 @@
 #include "src/core/SkTHash.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -203,6 +204,10 @@ private:
     std::unique_ptr<SkStrikePinner> fPinner;
     size_t                          fMemoryUsed{sizeof(SkStrike)};
     bool                            fRemoved{false};
+
+    // Set when a lookup under the SkStrikeCache's shared lock finds this strike, which it can't
+    // move to the head of the LRU list.
+    std::atomic<bool>               fRecentlyUsed{false};
 };
 
 #endif  // SkStrike_DEFINED
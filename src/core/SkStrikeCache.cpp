@@ -12,12 +12,13 @@
 #include "include/core/SkTraceMemoryDump.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
-#include "include/private/base/SkMutex.h"
+#include "src/base/SkSharedMutex.h"
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 class SkScalerContext;
@@ -37,7 +38,17 @@ SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
 }
 
 auto SkStrikeCache::findOrCreateStrike(const SkStrikeSpec& strikeSpec) -> sk_sp<SkStrike> {
-    SkAutoMutexExclusive ac(fLock);
+    {
+        // Text draws almost always hit a strike that is already cached, so try that with other
+        // threads drawing text.
+        SkAutoSharedMutexShared ac(fLock);
+        sk_sp<SkStrike> strike = this->internalFindStrikeShared(strikeSpec.descriptor());
+        if (strike != nullptr && !this->internalIsOverBudget()) {
+            return strike;
+        }
+    }
+
+    SkAutoSharedMutexExclusive ac(fLock);
     sk_sp<SkStrike> strike = this->internalFindStrikeOrNull(strikeSpec.descriptor());
     if (strike == nullptr) {
         strike = this->internalCreateStrike(strikeSpec);
@@ -90,7 +101,15 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 sk_sp<SkStrike> SkStrikeCache::findStrike(const SkDescriptor& desc) {
-    SkAutoMutexExclusive ac(fLock);
+    {
+        SkAutoSharedMutexShared ac(fLock);
+        sk_sp<SkStrike> strike = this->internalFindStrikeShared(desc);
+        if (strike != nullptr && !this->internalIsOverBudget()) {
+            return strike;
+        }
+    }
+
+    SkAutoSharedMutexExclusive ac(fLock);
     sk_sp<SkStrike> result = this->internalFindStrikeOrNull(desc);
     this->internalPurge();
     return result;
@@ -106,6 +125,30 @@ auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<
     if (strikeHandle == nullptr) { return nullptr; }
     SkStrike* strikePtr = strikeHandle->get();
     SkASSERT(strikePtr != nullptr);
+    this->internalMoveToHead(strikePtr);
+    return sk_ref_sp(strikePtr);
+}
+
+auto SkStrikeCache::internalFindStrikeShared(const SkDescriptor& desc) const -> sk_sp<SkStrike> {
+    if (fHead != nullptr && fHead->getDescriptor() == desc) { return sk_ref_sp(fHead); }
+
+    sk_sp<SkStrike>* strikeHandle = fStrikeLookup.find(desc);
+    if (strikeHandle == nullptr) { return nullptr; }
+    SkStrike* strikePtr = strikeHandle->get();
+    // Avoid writing to the strike (and so sharing its cache line between threads) when it is
+    // already marked.
+    if (!strikePtr->fRecentlyUsed.load(std::memory_order_relaxed)) {
+        strikePtr->fRecentlyUsed.store(true, std::memory_order_relaxed);
+    }
+    return sk_ref_sp(strikePtr);
+}
+
+bool SkStrikeCache::internalIsOverBudget() const {
+    return fTotalMemoryUsed > fCacheSizeLimit || fCacheCount > fCacheCountLimit;
+}
+
+void SkStrikeCache::internalMoveToHead(SkStrike* strikePtr) {
+    strikePtr->fRecentlyUsed.store(false, std::memory_order_relaxed);
     if (fHead != strikePtr) {
         // Make most recently used
         strikePtr->fPrev->fNext = strikePtr->fNext;
@@ -119,14 +162,13 @@ auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<
         strikePtr->fPrev = nullptr;
         fHead = strikePtr;
     }
-    return sk_ref_sp(strikePtr);
 }
 
 sk_sp<SkStrike> SkStrikeCache::createStrike(
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     return this->internalCreateStrike(strikeSpec, maybeMetrics, std::move(pinner));
 }
 
@@ -142,32 +184,32 @@ auto SkStrikeCache::internalCreateStrike(
 }
 
 void SkStrikeCache::purgePinned(size_t minBytesNeeded) {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     this->internalPurge(minBytesNeeded, /* checkPinners= */ true);
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     this->internalPurge(fTotalMemoryUsed, /* checkPinners= */ true);
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     return fTotalMemoryUsed;
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     return fCacheCount;
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     return fCacheCountLimit;
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
 
     size_t prevLimit = fCacheSizeLimit;
     fCacheSizeLimit = newLimit;
@@ -176,7 +218,7 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
     return fCacheSizeLimit;
 }
 
@@ -185,7 +227,7 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
 
     int prevCount = fCacheCountLimit;
     fCacheCountLimit = newCount;
@@ -194,7 +236,7 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoSharedMutexExclusive ac(fLock);
 
     this->validate();
 
@@ -243,8 +285,13 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
     while (strike != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
         SkStrike* prev = strike->fPrev;
 
-        // Only delete if the strike is not pinned.
-        if (strike->fPinner == nullptr || (checkPinners && strike->fPinner->canDelete())) {
+        if (strike->fRecentlyUsed.load(std::memory_order_relaxed)) {
+            // Found by a shared lookup since it was last moved, so it is not really this old.
+            // Give it a second chance instead of deleting it.
+            this->internalMoveToHead(strike);
+        } else if (strike->fPinner == nullptr ||
+                   (checkPinners && strike->fPinner->canDelete())) {
+            // Only delete if the strike is not pinned.
             bytesFreed += strike->fMemoryUsed;
             countFreed += 1;
             this->internalRemoveStrike(strike);
@@ -10,8 +10,8 @@
 
 #include "include/core/SkRefCnt.h"
 #include "include/private/base/SkLoadUserConfig.h" // IWYU pragma: keep
-#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkSharedMutex.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkTHash.h"
 #include "src/text/StrikeForGPU.h"
@@ -78,6 +78,11 @@ private:
     friend class SkStrike;  // for SkStrike::updateDelta
     static constexpr char kGlyphCacheDumpName[] = "skia/sk_glyph_cache";
     sk_sp<SkStrike> internalFindStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
+    // Looks up a strike without reordering the LRU list, so that hits only need to share the lock.
+    // The strike is marked as used so that purging gives it a second chance.
+    sk_sp<SkStrike> internalFindStrikeShared(const SkDescriptor& desc) const
+            SK_REQUIRES_SHARED(fLock);
+    bool internalIsOverBudget() const SK_REQUIRES_SHARED(fLock);
     sk_sp<SkStrike> internalCreateStrike(
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
@@ -86,6 +91,7 @@ private:
     // The following methods can only be called when mutex is already held.
     void internalRemoveStrike(SkStrike* strike) SK_REQUIRES(fLock);
     void internalAttachToHead(sk_sp<SkStrike> strike) SK_REQUIRES(fLock);
+    void internalMoveToHead(SkStrike* strike) SK_REQUIRES(fLock);
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
@@ -97,7 +103,9 @@ private:
 
     void forEachStrike(std::function<void(const SkStrike&)> visitor) const SK_EXCLUDES(fLock);
 
-    mutable SkMutex fLock;
+    // Lookups that hit only take this lock shared; anything that changes the cache takes it
+    // exclusively.
+    mutable SkSharedMutex fLock;
     SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
     SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
     struct StrikeTraits {
@@ -10,6 +10,7 @@
 
 #include "src/base/SkVx.h"
 #include "src/core/SkColorData.h"
+#include "src/core/SkMasks.h"
 
 #include <cstdint>
 
@@ -29,7 +30,27 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. keep the high byte of big-endian 16-bit channels
+                           RGB16_to_BGR1,   //      and insert an opaque alpha, swapping RB or not
+                           RGBA16_to_RGBA,  // i.e. keep the high byte of big-endian 16-bit channels
+                           RGBA16_to_BGRA;  //      swapping RB or not
+
+    // Look up each 8-bit index in a table of 256 colors.
+    using Swizzle_8888_index = void (*)(uint32_t*, const uint8_t*, int, const uint32_t table[]);
+    extern Swizzle_8888_index index_to_8888;
+
+    // Extract each of the 4 channels with a bit mask, as described by SkMasks, and widen it to
+    // 8 bits. The channels are given in the order they are stored, e.g. {B,G,R,A} for BGRA; the
+    // RGB1 variants ignore the last one and store an opaque alpha instead.
+    using Swizzle_8888_masked16 = void (*)(uint32_t*, const uint16_t*, int,
+                                           const SkMasks::MaskInfo channels[4]);
+    using Swizzle_8888_masked32 = void (*)(uint32_t*, const uint32_t*, int,
+                                           const SkMasks::MaskInfo channels[4]);
+    extern Swizzle_8888_masked16 masked16_to_RGBA,
+                                 masked16_to_RGB1;
+    extern Swizzle_8888_masked32 masked32_to_RGBA,
+                                 masked32_to_RGB1;
 
     void Init_Swizzler();
 }  // namespace SkOpts
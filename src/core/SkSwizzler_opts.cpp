@@ -30,9 +30,19 @@ namespace SkOpts {
     DEFINE_DEFAULT(grayA_to_rgbA);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
+    DEFINE_DEFAULT(RGB16_to_RGB1);
+    DEFINE_DEFAULT(RGB16_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_RGBA);
+    DEFINE_DEFAULT(RGBA16_to_BGRA);
+    DEFINE_DEFAULT(index_to_8888);
+    DEFINE_DEFAULT(masked16_to_RGBA);
+    DEFINE_DEFAULT(masked16_to_RGB1);
+    DEFINE_DEFAULT(masked32_to_RGBA);
+    DEFINE_DEFAULT(masked32_to_RGB1);
 
     void Init_Swizzler_ssse3();
     void Init_Swizzler_hsw();
+    void Init_Swizzler_skx();
     void Init_Swizzler_lasx();
 
     static bool init() {
@@ -46,6 +56,10 @@ namespace SkOpts {
         #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
             if (SkCpu::Supports(SkCpu::HSW)) { Init_Swizzler_hsw(); }
         #endif
+
+        #if (SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SKX) && defined(SK_ENABLE_AVX512_OPTS)
+            if (SkCpu::Supports(SkCpu::SKX)) { Init_Swizzler_skx(); }
+        #endif
     #elif defined(SK_CPU_LOONGARCH)
         #if SK_CPU_LSX_LEVEL < SK_CPU_LSX_LEVEL_LASX
             if (SkCpu::Supports(SkCpu::LOONGARCH_ASX)) { Init_Swizzler_lasx(); }
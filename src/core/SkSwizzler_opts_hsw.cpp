@@ -36,6 +36,15 @@ namespace SkOpts {
         grayA_to_rgbA         = hsw::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = hsw::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = hsw::inverted_CMYK_to_BGR1;
+        RGB16_to_RGB1         = hsw::RGB16_to_RGB1;
+        RGB16_to_BGR1         = hsw::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = hsw::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = hsw::RGBA16_to_BGRA;
+        index_to_8888         = hsw::index_to_8888;
+        masked16_to_RGBA      = hsw::masked16_to_RGBA;
+        masked16_to_RGB1      = hsw::masked16_to_RGB1;
+        masked32_to_RGBA      = hsw::masked32_to_RGBA;
+        masked32_to_RGB1      = hsw::masked32_to_RGB1;
     }
 }  // namespace SkOpts
 
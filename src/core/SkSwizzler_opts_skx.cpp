@@ -0,0 +1,52 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "include/private/base/SkFeatures.h"
+#include "src/core/SkOptsTargets.h"
+#include "src/core/SkSwizzlePriv.h"
+
+#if defined(SK_CPU_X86) && \
+    !defined(SK_ENABLE_OPTIMIZE_SIZE) && \
+    defined(SK_ENABLE_AVX512_OPTS) && \
+    SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SKX
+
+// The order of these includes is important:
+// 1) Select the target CPU architecture by defining SK_OPTS_TARGET and including SkOpts_SetTarget
+// 2) Include the code to compile, typically in a _opts.inc file.
+// 3) Include SkOpts_RestoreTarget to switch back to the default CPU architecture
+
+#define SK_OPTS_TARGET SK_OPTS_TARGET_SKX
+#include "src/opts/SkOpts_SetTarget.h"
+
+#include "src/opts/SkSwizzler_opts.inc"
+
+#include "src/opts/SkOpts_RestoreTarget.h"
+
+namespace SkOpts {
+    void Init_Swizzler_skx() {
+        RGBA_to_BGRA          = skx::RGBA_to_BGRA;
+        RGBA_to_rgbA          = skx::RGBA_to_rgbA;
+        RGBA_to_bgrA          = skx::RGBA_to_bgrA;
+        gray_to_RGB1          = skx::gray_to_RGB1;
+        grayA_to_RGBA         = skx::grayA_to_RGBA;
+        grayA_to_rgbA         = skx::grayA_to_rgbA;
+        inverted_CMYK_to_RGB1 = skx::inverted_CMYK_to_RGB1;
+        inverted_CMYK_to_BGR1 = skx::inverted_CMYK_to_BGR1;
+        RGB16_to_RGB1         = skx::RGB16_to_RGB1;
+        RGB16_to_BGR1         = skx::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = skx::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = skx::RGBA16_to_BGRA;
+        index_to_8888         = skx::index_to_8888;
+        masked16_to_RGBA      = skx::masked16_to_RGBA;
+        masked16_to_RGB1      = skx::masked16_to_RGB1;
+        masked32_to_RGBA      = skx::masked32_to_RGBA;
+        masked32_to_RGB1      = skx::masked32_to_RGB1;
+    }
+}  // namespace SkOpts
+
+#endif // SK_CPU_X86 && !SK_ENABLE_OPTIMIZE_SIZE && SK_ENABLE_AVX512_OPTS
@@ -38,6 +38,15 @@ namespace SkOpts {
         grayA_to_rgbA         = ssse3::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = ssse3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
+        RGB16_to_RGB1         = ssse3::RGB16_to_RGB1;
+        RGB16_to_BGR1         = ssse3::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = ssse3::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = ssse3::RGBA16_to_BGRA;
+        index_to_8888         = ssse3::index_to_8888;
+        masked16_to_RGBA      = ssse3::masked16_to_RGBA;
+        masked16_to_RGB1      = ssse3::masked16_to_RGB1;
+        masked32_to_RGBA      = ssse3::masked32_to_RGBA;
+        masked32_to_RGB1      = ssse3::masked32_to_RGB1;
     }
 }  // namespace SkOpts
 
@@ -308,9 +308,13 @@ skif::FilterResult SkBlendImageFilter::onFilterImage(const skif::Context& ctx) c
     }
 
     skif::Context inputCtx = ctx.withNewDesiredOutput(*requiredInput);
+    const skif::Context inputContexts[] = {inputCtx, inputCtx};
+    skif::FilterResult childOutputs[2];
+    this->getChildOutputs(inputContexts, childOutputs);
+
     skif::FilterResult::Builder builder{ctx};
-    builder.add(this->getChildOutput(kBackground, inputCtx));
-    builder.add(this->getChildOutput(kForeground, inputCtx));
+    builder.add(childOutputs[kBackground]);
+    builder.add(childOutputs[kForeground]);
     return builder.eval(
             [&](SkSpan<sk_sp<SkShader>> inputs) -> sk_sp<SkShader> {
                 return this->makeBlendShader(inputs[kBackground], inputs[kForeground]);
@@ -59,6 +59,8 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    float onGetMaxLayerBlurSigma(const skif::Mapping& mapping) const override;
+
     skif::LayerSpace<SkSize> mapSigma(const skif::Mapping& mapping) const;
 
     skif::LayerSpace<SkIRect> kernelBounds(const skif::Mapping& mapping,
@@ -195,6 +197,11 @@ skif::FilterResult SkBlurImageFilter::onFilterImage(const skif::Context& ctx) co
     return builder.blur(sigma);
 }
 
+float SkBlurImageFilter::onGetMaxLayerBlurSigma(const skif::Mapping& mapping) const {
+    skif::LayerSpace<SkSize> sigma = this->mapSigma(mapping);
+    return std::max({sigma.width(), sigma.height(), this->getChildMaxLayerBlurSigma(0, mapping)});
+}
+
 skif::LayerSpace<SkSize> SkBlurImageFilter::mapSigma(const skif::Mapping& mapping) const {
     skif::LayerSpace<SkSize> sigma = mapping.paramToLayer(fSigma);
     // Clamp to the maximum sigma
@@ -7,11 +7,15 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
@@ -20,14 +24,22 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -142,6 +154,150 @@ sk_sp<SkShader> make_displacement_shader(
     return builder.makeShader();
 }
 
+// Returns the byte offset, in bits, of 'channel' within an RGBA or BGRA 8888 pixel.
+int channel_shift(SkColorChannel channel, bool swapRB) {
+    switch (channel) {
+        case SkColorChannel::kR: return swapRB ? 16 : 0;
+        case SkColorChannel::kG: return 8;
+        case SkColorChannel::kB: return swapRB ? 0 : 16;
+        case SkColorChannel::kA: return 24;
+    }
+    SkUNREACHABLE;
+}
+
+// Evaluates the displacement shader for the rows [top, bottom) of 'dst', which covers 'dstBounds'
+// in layer space. Eight pixels are displaced at a time and then gathered from 'color' with nearest
+// sampling, where anything outside of 'colorBounds' is transparent.
+void raster_displacement_rows(const SkPixmap& displ, const SkIRect& displBounds,
+                              const SkPixmap& color, const SkIRect& colorBounds,
+                              const SkPixmap& dst, const SkIRect& dstBounds,
+                              SkV2 scale, int xShift, int yShift, int top, int bottom) {
+    using Vec8f = skvx::Vec<8, float>;
+    using Vec8i = skvx::Vec<8, int32_t>;
+    using Vec8u32 = skvx::Vec<8, uint32_t>;
+
+    const int width = dstBounds.width();
+    // The displacement row is padded to whole vectors, with transparent pixels wherever the
+    // displacement image doesn't cover the output.
+    skia_private::AutoTMalloc<uint32_t> displRow(SkAlign8(width));
+    const int displLeft = std::clamp(displBounds.fLeft - dstBounds.fLeft, 0, width),
+              displRight = std::clamp(displBounds.fRight - dstBounds.fLeft, displLeft, width);
+    sk_bzero(displRow.get(), SkAlign8(width) * sizeof(uint32_t));
+
+    const Vec8f laneOffsets = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f};
+    const Vec8f maxX = (float)colorBounds.width(),
+                maxY = (float)colorBounds.height();
+
+    for (int y = top; y < bottom; ++y) {
+        if (displLeft < displRight && y >= displBounds.fTop && y < displBounds.fBottom) {
+            memcpy(displRow.get() + displLeft,
+                   displ.addr32(dstBounds.fLeft + displLeft - displBounds.fLeft,
+                                y - displBounds.fTop),
+                   (displRight - displLeft) * sizeof(uint32_t));
+        } else {
+            sk_bzero(displRow.get() + displLeft, (displRight - displLeft) * sizeof(uint32_t));
+        }
+        uint32_t* dstRow = dst.writable_addr32(0, y - dstBounds.fTop);
+
+        for (int x = 0; x < width; x += 8) {
+            const Vec8u32 d = Vec8u32::Load(displRow.get() + x);
+
+            // Unpremultiply the selected channels. Alpha is left as is, like unpremul() in SkSL.
+            const Vec8f a = skvx::cast<float>(d >> 24) * (1 / 255.f);
+            const Vec8f invA = skvx::if_then_else(a > 0.f, 1.f / a, Vec8f(0.f));
+            auto channel = [&](int shift) {
+                return shift == 24 ? a
+                                   : skvx::cast<float>((d >> shift) & 0xff) * (1 / 255.f) * invA;
+            };
+            const Vec8f dx = scale.x * (channel(xShift) - 0.5f),
+                        dy = scale.y * (channel(yShift) - 0.5f);
+
+            // The sample coordinates relative to the color image, pinned before converting to ints
+            // so that any displacement far outside of the image stays outside of it.
+            const Vec8f sx = laneOffsets + (float)(dstBounds.fLeft + x - colorBounds.fLeft) + dx,
+                        sy = (y + 0.5f - colorBounds.fTop) + dy;
+            const Vec8i ix = skvx::cast<int32_t>(skvx::floor(pin(sx, Vec8f(-1.f), maxX))),
+                        iy = skvx::cast<int32_t>(skvx::floor(pin(sy, Vec8f(-1.f), maxY)));
+
+            const int count = std::min(8, width - x);
+            for (int i = 0; i < count; ++i) {
+                const bool inside = ix[i] >= 0 && ix[i] < colorBounds.width() &&
+                                    iy[i] >= 0 && iy[i] < colorBounds.height();
+                dstRow[x + i] = inside ? *color.addr32(ix[i], iy[i]) : 0;
+            }
+        }
+    }
+}
+
+// Returns the displacement of 'colorOutput' evaluated on the CPU over 'outputBounds', or an empty
+// optional if it must be evaluated with the displacement shader instead.
+std::optional<skif::FilterResult> raster_displacement(
+        const skif::Context& ctx,
+        const skif::FilterResult& displacementOutput,
+        const skif::Context& displacementCtx,
+        const skif::FilterResult& colorOutput,
+        const skif::LayerSpace<SkIRect>& colorSampleBounds,
+        const skif::LayerSpace<SkIRect>& outputBounds,
+        skif::LayerSpace<skif::Vector> scale,
+        SkColorChannel xChannel,
+        SkColorChannel yChannel) {
+    const SkColorType colorType = ctx.backend()->colorType();
+    if (colorType != kRGBA_8888_SkColorType && colorType != kBGRA_8888_SkColorType) {
+        return {};
+    }
+    SkASSERT(displacementOutput && colorOutput);
+    for (const skif::FilterResult* input : {&displacementOutput, &colorOutput}) {
+        if (input->image()->isGaneshBacked() || input->image()->isGraphiteBacked()) {
+            return {};
+        }
+    }
+
+    auto asBitmap = [colorType](const sk_sp<SkSpecialImage>& image, SkBitmap* bitmap) {
+        return SkSpecialImages::AsBitmap(image.get(), bitmap) &&
+               bitmap->colorType() == colorType &&
+               bitmap->alphaType() != kUnpremul_SkAlphaType;
+    };
+
+    auto [displImage, displOrigin] = displacementOutput.imageAndOffset(displacementCtx);
+    auto [colorImage, colorOrigin] =
+            colorOutput.imageAndOffset(ctx.withNewDesiredOutput(colorSampleBounds));
+    if (!displImage) {
+        return {}; // The shader path handles a displacement map that resolved to nothing
+    }
+    if (!colorImage) {
+        return skif::FilterResult{};
+    }
+    SkBitmap displ, color;
+    if (!asBitmap(displImage, &displ) || !asBitmap(colorImage, &color)) {
+        return {};
+    }
+
+    const SkIRect dstBounds = SkIRect(outputBounds);
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(SkImageInfo::Make(dstBounds.size(), colorType, kPremul_SkAlphaType,
+                                              ctx.refColorSpace()))) {
+        return skif::FilterResult{};
+    }
+
+    const SkIRect displBounds = SkIRect::MakeXYWH(displOrigin.x(), displOrigin.y(),
+                                                  displ.width(), displ.height());
+    const SkIRect colorBounds = SkIRect::MakeXYWH(colorOrigin.x(), colorOrigin.y(),
+                                                  color.width(), color.height());
+    const bool swapRB = colorType == kBGRA_8888_SkColorType;
+    ctx.forEachRowBand(dstBounds.fTop, dstBounds.fBottom, [&](int top, int bottom) {
+        raster_displacement_rows(displ.pixmap(), displBounds, color.pixmap(), colorBounds,
+                                 dst.pixmap(), dstBounds, SkV2{scale.x(), scale.y()},
+                                 channel_shift(xChannel, swapRB), channel_shift(yChannel, swapRB),
+                                 top, bottom);
+    });
+    dst.setImmutable();
+
+    return skif::FilterResult(SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                                              dst,
+                                                              ctx.backend()->surfaceProps()),
+                              outputBounds.topLeft());
+}
+
 }  // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -197,8 +353,40 @@ void SkDisplacementMapImageFilter::flatten(SkWriteBuffer& buffer) const {
 skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Context& ctx) const {
     skif::LayerSpace<SkIRect> requiredColorInput =
             this->outsetByMaxDisplacement(ctx.mapping(), ctx.desiredOutput());
-    skif::FilterResult colorOutput =
-            this->getChildOutput(kColor, ctx.withNewDesiredOutput(requiredColorInput));
+
+    // Creation of the displacement map should happen in a non-colorspace aware context. This
+    // texture is a purely mathematical construct, so we want to just operate on the stored
+    // values. Consider:
+    //
+    //   User supplies an sRGB displacement map. If we're rendering to a wider gamut, then we could
+    //   end up filtering the displacement map into that gamut, which has the effect of reducing
+    //   the amount of displacement that it represents (as encoded values move away from the
+    //   primaries).
+    //
+    //   With a more complex DAG attached to this input, it's not clear that working in ANY specific
+    //   color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
+    //   ideal, but it's at least consistent and predictable.
+    auto displacementContext = [&](const skif::LayerSpace<SkIRect>& bounds) {
+        return ctx.withNewDesiredOutput(bounds).withNewColorSpace(/*cs=*/nullptr);
+    };
+
+    skif::FilterResult colorOutput;
+    skif::FilterResult displacementOutput;
+    const bool evaluateInputsConcurrently =
+            ctx.executor() && this->getInput(kColor) && this->getInput(kDisplacement);
+    if (evaluateInputsConcurrently) {
+        // The displacement map only has to cover where the color output can be displaced to,
+        // which isn't known until the color input has been evaluated. Requesting all of the
+        // desired output from it instead lets both inputs be evaluated at the same time.
+        const skif::Context contexts[] = {displacementContext(ctx.desiredOutput()),
+                                          ctx.withNewDesiredOutput(requiredColorInput)};
+        skif::FilterResult outputs[2];
+        this->getChildOutputs(contexts, outputs);
+        displacementOutput = outputs[kDisplacement];
+        colorOutput = outputs[kColor];
+    } else {
+        colorOutput = this->getChildOutput(kColor, ctx.withNewDesiredOutput(requiredColorInput));
+    }
     if (!colorOutput) {
         return {}; // No non-transparent black colors to displace
     }
@@ -218,21 +406,9 @@ skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Conte
         return {};
     }
 
-    // Creation of the displacement map should happen in a non-colorspace aware context. This
-    // texture is a purely mathematical construct, so we want to just operate on the stored
-    // values. Consider:
-    //
-    //   User supplies an sRGB displacement map. If we're rendering to a wider gamut, then we could
-    //   end up filtering the displacement map into that gamut, which has the effect of reducing
-    //   the amount of displacement that it represents (as encoded values move away from the
-    //   primaries).
-    //
-    //   With a more complex DAG attached to this input, it's not clear that working in ANY specific
-    //   color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
-    //   ideal, but it's at least consistent and predictable.
-    skif::FilterResult displacementOutput =
-            this->getChildOutput(kDisplacement, ctx.withNewDesiredOutput(outputBounds)
-                                                   .withNewColorSpace(/*cs=*/nullptr));
+    if (!evaluateInputsConcurrently) {
+        displacementOutput = this->getChildOutput(kDisplacement, displacementContext(outputBounds));
+    }
 
     // NOTE: The scale is a "vector" not a "size" since we want to preserve negations on the final
     // displacement vector.
@@ -249,6 +425,13 @@ skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Conte
 
     // If we made it this far, then we actually have per-pixel displacement affecting the color
     // image. We need to evaluate each pixel within 'outputBounds'.
+    if (std::optional<skif::FilterResult> rasterOutput =
+                raster_displacement(ctx, displacementOutput, displacementContext(outputBounds),
+                                    colorOutput, requiredColorInput, outputBounds, scale,
+                                    fXChannel, fYChannel)) {
+        return *rasterOutput;
+    }
+
     using ShaderFlags = skif::FilterResult::ShaderFlags;
 
     skif::FilterResult::Builder builder{ctx};
@@ -7,10 +7,14 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkPoint3.h"
 #include "include/core/SkRect.h"
@@ -19,17 +23,26 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -222,43 +235,38 @@ sk_sp<SkShader> make_normal_shader(sk_sp<SkShader> alphaMap,
     return builder.makeShader();
 }
 
-sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap,
-                                     Light::Type lightType,
-                                     SkColor lightColor,
-                                     skif::LayerSpace<SkPoint> locationXY,
-                                     skif::LayerSpace<ZValue> locationZ,
-                                     skif::LayerSpace<skif::Vector> directionXY,
-                                     skif::LayerSpace<ZValue> directionZ,
-                                     float falloffExponent,
-                                     float cosCutoffAngle,
-                                     Material::Type matType,
-                                     skif::LayerSpace<ZValue> surfaceDepth,
-                                     float k,
-                                     float shininess) {
-
-    const SkRuntimeEffect* lightingEffect =
-            GetKnownRuntimeEffect(SkKnownRuntimeEffects::StableKey::kLighting);
-
-    SkRuntimeShaderBuilder builder(sk_ref_sp(lightingEffect));
-    builder.child("normalMap") = std::move(normalMap);
-
-    builder.uniform("materialAndLightType") =
-            SkV4{surfaceDepth.val(),
-                 shininess,
-                 static_cast<float>(matType),
-                 lightType == Light::Type::kPoint ?
-                         0.f : (lightType == Light::Type::kDistant ? -1.f : 1.f)};
-    builder.uniform("lightPosAndSpotFalloff") =
-            SkV4{locationXY.x(), locationXY.y(), locationZ.val(), falloffExponent};
+// The light and material parameters mapped into layer space, shared by the lighting shader and the
+// raster lighting kernel.
+struct LayerLighting {
+    Light::Type fLightType;
+    Material::Type fMaterialType;
+    SkV3 fLightColor;  // Already scaled by the material's K
+    SkV3 fLightPos;
+    SkV3 fLightDir;    // Normalized, or (0,0,0) if it was degenerate
+    float fSpotFalloff;
+    float fCosCutoffAngle;
+    float fSurfaceDepth;
+    float fShininess;
+};
 
+LayerLighting make_layer_lighting(Light::Type lightType,
+                                  SkColor lightColor,
+                                  skif::LayerSpace<SkPoint> locationXY,
+                                  skif::LayerSpace<ZValue> locationZ,
+                                  skif::LayerSpace<skif::Vector> directionXY,
+                                  skif::LayerSpace<ZValue> directionZ,
+                                  float falloffExponent,
+                                  float cosCutoffAngle,
+                                  Material::Type matType,
+                                  skif::LayerSpace<ZValue> surfaceDepth,
+                                  float k,
+                                  float shininess) {
     // Pre-normalize the light direction, but this can be (0,0,0) for point lights, which won't use
     // the uniform anyways. Avoid a division by 0 to keep ASAN happy or in the event that a spot/dir
     // light have bad user input.
     SkV3 dir{directionXY.x(), directionXY.y(), directionZ.val()};
     float invDirLen = dir.length();
     invDirLen = invDirLen ? 1.0f / invDirLen : 0.f;
-    builder.uniform("lightDirAndSpotCutoff") =
-            SkV4{invDirLen*dir.x, invDirLen*dir.y, invDirLen*dir.z, cosCutoffAngle};
 
     // Historically, the Skia lighting image filter did not apply any color space transformation to
     // the light's color. The SVG spec for the lighting effects does not stipulate how to interpret
@@ -275,13 +283,240 @@ sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap,
     //  - so for now, leave the color un-modified and apply K up front since no color space
     //    transforms need to be performed on the original light color.
     const float colorScale = k / 255.f;
-    builder.uniform("lightColor") = SkV3{SkColorGetR(lightColor) * colorScale,
-                                         SkColorGetG(lightColor) * colorScale,
-                                         SkColorGetB(lightColor) * colorScale};
+
+    return {lightType,
+            matType,
+            SkV3{SkColorGetR(lightColor) * colorScale,
+                 SkColorGetG(lightColor) * colorScale,
+                 SkColorGetB(lightColor) * colorScale},
+            SkV3{locationXY.x(), locationXY.y(), locationZ.val()},
+            invDirLen * dir,
+            falloffExponent,
+            cosCutoffAngle,
+            surfaceDepth.val(),
+            shininess};
+}
+
+sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap, const LayerLighting& lighting) {
+    const SkRuntimeEffect* lightingEffect =
+            GetKnownRuntimeEffect(SkKnownRuntimeEffects::StableKey::kLighting);
+
+    SkRuntimeShaderBuilder builder(sk_ref_sp(lightingEffect));
+    builder.child("normalMap") = std::move(normalMap);
+
+    builder.uniform("materialAndLightType") =
+            SkV4{lighting.fSurfaceDepth,
+                 lighting.fShininess,
+                 static_cast<float>(lighting.fMaterialType),
+                 lighting.fLightType == Light::Type::kPoint ?
+                         0.f : (lighting.fLightType == Light::Type::kDistant ? -1.f : 1.f)};
+    builder.uniform("lightPosAndSpotFalloff") =
+            SkV4{lighting.fLightPos.x, lighting.fLightPos.y, lighting.fLightPos.z,
+                 lighting.fSpotFalloff};
+    builder.uniform("lightDirAndSpotCutoff") =
+            SkV4{lighting.fLightDir.x, lighting.fLightDir.y, lighting.fLightDir.z,
+                 lighting.fCosCutoffAngle};
+    builder.uniform("lightColor") = lighting.fLightColor;
 
     return builder.makeShader();
 }
 
+// The raster lighting kernel evaluates this many horizontally adjacent pixels at a time.
+using LightingVec = skvx::Vec<8, float>;
+static constexpr int kLightingLanes = 8;
+
+LightingVec pow_lanes(const LightingVec& base, float exponent) {
+    return skvx::map([exponent](float b) { return std::pow(b, exponent); }, base);
+}
+
+// Normalizes (x,y,z) in place, leaving zero-length vectors as 0 instead of NaN.
+void normalize_lanes(LightingVec* x, LightingVec* y, LightingVec* z) {
+    LightingVec lengthSq = (*x) * (*x) + (*y) * (*y) + (*z) * (*z);
+    LightingVec invLength = skvx::if_then_else(lengthSq > 0.f,
+                                               1.f / skvx::sqrt(lengthSq), LightingVec(0.f));
+    *x *= invLength;
+    *y *= invLength;
+    *z *= invLength;
+}
+
+// Fills 'row' with the alpha of the pixels [x0, x0+count) in row 'y' of the alpha map, using the
+// same coordinate clamping as the normal shader. Pixels outside of 'srcBounds' are transparent.
+void fill_alpha_row(const SkPixmap& src, const SkIRect& srcBounds, const SkIRect& clampRect,
+                    int x0, int count, int y, float* row) {
+    y = SkTPin(y, clampRect.fTop, clampRect.fBottom - 1);
+    const uint32_t* srcRow = y >= srcBounds.fTop && y < srcBounds.fBottom
+                                     ? src.addr32(0, y - srcBounds.fTop) : nullptr;
+    for (int i = 0; i < count; ++i) {
+        const int x = SkTPin(x0 + i, clampRect.fLeft, clampRect.fRight - 1);
+        // Alpha is the most significant byte of both RGBA and BGRA 8888 pixels.
+        row[i] = srcRow && x >= srcBounds.fLeft && x < srcBounds.fRight
+                         ? (srcRow[x - srcBounds.fLeft] >> 24) * (1 / 255.f) : 0.f;
+    }
+}
+
+// Evaluates the normal and lighting shaders for the rows [top, bottom) of 'dst', which covers
+// 'dstBounds' in layer space. The alpha map is read through a sliding window of three rows so
+// that the Sobel kernel only touches each source pixel once per band.
+void raster_lighting_rows(const SkPixmap& src, const SkIRect& srcBounds,
+                          const SkIRect& clampRect, const SkPixmap& dst, const SkIRect& dstBounds,
+                          const LayerLighting& lighting, int top, int bottom) {
+    using Vec8u32 = skvx::Vec<8, uint32_t>;
+
+    const int width = dstBounds.width();
+    // Pad each row to a whole number of vectors, plus the left and right columns of the kernel.
+    const int rowStride = SkAlign8(width) + 2;
+    skia_private::AutoTMalloc<float> alphaRows(3 * rowStride);
+    float* window[3] = {alphaRows.get(), alphaRows.get() + rowStride, alphaRows.get() + 2*rowStride};
+    for (int i = 0; i < 3; ++i) {
+        fill_alpha_row(src, srcBounds, clampRect, dstBounds.fLeft - 1, rowStride, top - 1 + i,
+                       window[i]);
+    }
+
+    const float depth = lighting.fSurfaceDepth;
+    const SkV3& lightPos = lighting.fLightPos;
+    const SkV3& lightDir = lighting.fLightDir;
+    const bool swapRB = dst.colorType() == kBGRA_8888_SkColorType;
+    const LightingVec laneOffsets = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f};
+
+    for (int y = top; y < bottom; ++y) {
+        if (y > top) {
+            std::rotate(window, window + 1, window + 3);
+            fill_alpha_row(src, srcBounds, clampRect, dstBounds.fLeft - 1, rowStride, y + 1,
+                           window[2]);
+        }
+        uint32_t* dstRow = dst.writable_addr32(0, y - dstBounds.fTop);
+        const float cy = y + 0.5f;
+
+        for (int x = 0; x < width; x += kLightingLanes) {
+            const LightingVec tl = LightingVec::Load(window[0] + x),
+                              tc = LightingVec::Load(window[0] + x + 1),
+                              tr = LightingVec::Load(window[0] + x + 2),
+                              ml = LightingVec::Load(window[1] + x),
+                              alpha = LightingVec::Load(window[1] + x + 1),
+                              mr = LightingVec::Load(window[1] + x + 2),
+                              bl = LightingVec::Load(window[2] + x),
+                              bc = LightingVec::Load(window[2] + x + 1),
+                              br = LightingVec::Load(window[2] + x + 2);
+
+            // Sobel normals, matching $normal_filter
+            LightingVec nx = -depth * 0.25f * ((tr + 2.f * mr + br) - (tl + 2.f * ml + bl)),
+                        ny = -depth * 0.25f * ((bl + 2.f * bc + br) - (tl + 2.f * tc + tr)),
+                        nz = 1.f;
+            normalize_lanes(&nx, &ny, &nz);
+
+            LightingVec lx, ly, lz;
+            if (lighting.fLightType == Light::Type::kDistant) {
+                lx = lightDir.x;
+                ly = lightDir.y;
+                lz = lightDir.z;
+            } else {
+                lx = lightPos.x - (laneOffsets + (float)(dstBounds.fLeft + x));
+                ly = lightPos.y - cy;
+                lz = lightPos.z - depth * alpha;
+                normalize_lanes(&lx, &ly, &lz);
+            }
+
+            LightingVec scale = 1.f;
+            if (lighting.fLightType == Light::Type::kSpot) {
+                static constexpr float kConeAAThreshold = 0.016f;
+                const float cutoff = lighting.fCosCutoffAngle;
+                LightingVec cosAngle = -(lx * lightDir.x + ly * lightDir.y + lz * lightDir.z);
+                scale = pow_lanes(max(cosAngle, 0.f), lighting.fSpotFalloff);
+                scale = skvx::if_then_else(cosAngle < cutoff + kConeAAThreshold,
+                                           scale * (cosAngle - cutoff) * (1.f / kConeAAThreshold),
+                                           scale);
+                scale = skvx::if_then_else(cosAngle < cutoff, LightingVec(0.f), scale);
+            }
+
+            // The bases of pow() are clamped to 0, where the shader's result would be undefined.
+            const LightingVec nDotL = nx * lx + ny * ly + nz * lz;
+            LightingVec coeff;
+            switch (lighting.fMaterialType) {
+                case Material::Type::kDiffuse:
+                    coeff = nDotL;
+                    break;
+                case Material::Type::kSpecular: {
+                    LightingVec hx = lx, hy = ly, hz = lz + 1.f;
+                    normalize_lanes(&hx, &hy, &hz);
+                    coeff = pow_lanes(max(nx * hx + ny * hy + nz * hz, 0.f), lighting.fShininess);
+                    break;
+                }
+                case Material::Type::kEmbossSpecular:
+                    coeff = pow_lanes(max((2.f * nDotL - lz) * lz, 0.f), lighting.fShininess);
+                    break;
+            }
+            coeff *= scale;
+
+            const LightingVec r = min(max(coeff * lighting.fLightColor.x, 0.f), 1.f),
+                              g = min(max(coeff * lighting.fLightColor.y, 0.f), 1.f),
+                              b = min(max(coeff * lighting.fLightColor.z, 0.f), 1.f),
+                              a = lighting.fMaterialType == Material::Type::kDiffuse
+                                          ? LightingVec(1.f) : max(max(r, g), b);
+
+            auto toUnorm = [](const LightingVec& v) {
+                return skvx::cast<uint32_t>(v * 255.f + 0.5f);
+            };
+            const Vec8u32 px = toUnorm(swapRB ? b : r)       |
+                               toUnorm(g)                << 8  |
+                               toUnorm(swapRB ? r : b)   << 16 |
+                               toUnorm(a)                << 24;
+            if (x + kLightingLanes <= width) {
+                px.store(dstRow + x);
+            } else {
+                uint32_t tail[kLightingLanes];
+                px.store(tail);
+                memcpy(dstRow + x, tail, (width - x) * sizeof(uint32_t));
+            }
+        }
+    }
+}
+
+// Returns the lighting filter evaluated on the CPU over the desired output, or an empty optional
+// if it must be evaluated with the normal and lighting shaders instead.
+std::optional<skif::FilterResult> raster_lighting(const skif::Context& ctx,
+                                                  const skif::FilterResult& childOutput,
+                                                  const skif::LayerSpace<SkIRect>& clampRect,
+                                                  const LayerLighting& lighting) {
+    const SkColorType colorType = ctx.backend()->colorType();
+    if (colorType != kRGBA_8888_SkColorType && colorType != kBGRA_8888_SkColorType) {
+        return {};
+    }
+
+    // A transparent alpha map still produces a lit, flat surface, so an empty 'src' is valid.
+    SkBitmap src;
+    SkIRect srcBounds = SkIRect::MakeEmpty();
+    if (childOutput) {
+        if (childOutput.image()->isGaneshBacked() || childOutput.image()->isGraphiteBacked()) {
+            return {};
+        }
+        auto [image, origin] = childOutput.imageAndOffset(ctx.withNewDesiredOutput(clampRect));
+        if (image) {
+            if (!SkSpecialImages::AsBitmap(image.get(), &src) || src.colorType() != colorType ||
+                src.alphaType() == kUnpremul_SkAlphaType) {
+                return {};
+            }
+            srcBounds = SkIRect::MakeXYWH(origin.x(), origin.y(), src.width(), src.height());
+        }
+    }
+
+    const SkIRect dstBounds = SkIRect(ctx.desiredOutput());
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(SkImageInfo::Make(dstBounds.size(), colorType, kPremul_SkAlphaType,
+                                              ctx.refColorSpace()))) {
+        return skif::FilterResult{};
+    }
+    ctx.forEachRowBand(dstBounds.fTop, dstBounds.fBottom, [&](int top, int bottom) {
+        raster_lighting_rows(src.pixmap(), srcBounds, SkIRect(clampRect), dst.pixmap(), dstBounds,
+                             lighting, top, bottom);
+    });
+    dst.setImmutable();
+
+    return skif::FilterResult(SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                                              dst,
+                                                              ctx.backend()->surfaceProps()),
+                              ctx.desiredOutput().topLeft());
+}
+
 sk_sp<SkImageFilter> make_lighting(const Light& light,
                                    const Material& material,
                                    sk_sp<SkImageFilter> input,
@@ -566,6 +801,23 @@ skif::FilterResult SkLightingImageFilter::onFilterImage(const skif::Context& ctx
                 edgeClamp(inputRect.bottom(), requiredInput.bottom(), clampTo.bottom())});
     }
 
+    const LayerLighting lighting = make_layer_lighting(fLight.fType,
+                                                       fLight.fLightColor,
+                                                       lightLocationXY,
+                                                       lightLocationZ,
+                                                       lightDirXY,
+                                                       lightDirZ,
+                                                       fLight.fFalloffExponent,
+                                                       fLight.fCosCutoffAngle,
+                                                       fMaterial.fType,
+                                                       surfaceDepth,
+                                                       fMaterial.fK,
+                                                       fMaterial.fShininess);
+    if (std::optional<skif::FilterResult> rasterOutput =
+                raster_lighting(ctx, childOutput, clampRect, lighting)) {
+        return *rasterOutput;
+    }
+
     skif::FilterResult::Builder builder{ctx};
     builder.add(childOutput, /*sampleBounds=*/clampRect, ShaderFlags::kSampledRepeatedly);
     return builder.eval([&](SkSpan<sk_sp<SkShader>> input) {
@@ -576,21 +828,7 @@ skif::FilterResult SkLightingImageFilter::onFilterImage(const skif::Context& ctx
         // output would be automatically cached, and the lighting equation shader would be deferred
         // to the merge's draw operation, making for a maximum of 2 renderpasses instead of N+1.
         sk_sp<SkShader> normals = make_normal_shader(std::move(input[0]), clampRect, surfaceDepth);
-        return make_lighting_shader(std::move(normals),
-                                    // Light in layer space
-                                    fLight.fType,
-                                    fLight.fLightColor,
-                                    lightLocationXY,
-                                    lightLocationZ,
-                                    lightDirXY,
-                                    lightDirZ,
-                                    fLight.fFalloffExponent,
-                                    fLight.fCosCutoffAngle,
-                                    // Material in layer space
-                                    fMaterial.fType,
-                                    surfaceDepth,
-                                    fMaterial.fK,
-                                    fMaterial.fShininess);
+        return make_lighting_shader(std::move(normals), lighting);
     });
 }
 
@@ -31,14 +31,18 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkSafeMath.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <optional>
@@ -58,6 +62,9 @@ static_assert(kMaxUniformKernelSize % 4 == 0, "Must be a multiple of 4");
 SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
                               float* innerGain, float* innerBias);
 
+bool decompose_separable_kernel(const SkISize& kernelSize, const float* kernel,
+                                TArray<float>* rowKernel, TArray<float>* columnKernel);
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -78,6 +85,8 @@ public:
 
         // Does nothing for small kernels, otherwise encodes kernel into an A8 image.
         fKernelBitmap = create_kernel_bitmap(kernelSize, kernel, &fInnerGain, &fInnerBias);
+        // Leaves the 1D kernels empty unless the kernel can be applied as two cheaper passes.
+        decompose_separable_kernel(kernelSize, kernel, &fRowKernel, &fColumnKernel);
     }
 
     SkRect computeFastBounds(const SkRect& bounds) const override;
@@ -123,6 +132,13 @@ private:
 
     sk_sp<SkShader> createShader(const skif::Context& ctx, sk_sp<SkShader> input) const;
 
+    // Evaluates the convolution directly on the CPU for raster 8888 inputs, or returns an empty
+    // optional if the shader must be used instead.
+    std::optional<skif::FilterResult> rasterConvolve(
+            const skif::Context& ctx,
+            const skif::FilterResult& input,
+            const skif::LayerSpace<SkIRect>& outputBounds) const;
+
     // Original kernel data, preserved for serialization even if it was encoded into fKernelBitmap
     TArray<float> fKernel;
 
@@ -141,6 +157,12 @@ private:
     SkBitmap fKernelBitmap;
     float fInnerBias;
     float fInnerGain;
+
+    // When the kernel is rank 1 it equals the outer product of fColumnKernel and fRowKernel, and
+    // the raster path applies it as a horizontal pass followed by a vertical pass. Otherwise both
+    // are empty. These are also derived and not serialized.
+    TArray<float> fRowKernel;
+    TArray<float> fColumnKernel;
 };
 
 // LayerSpace doesn't have a clean type to represent 4 separate edge deltas, but the result
@@ -223,6 +245,58 @@ SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
     return kernelBM;
 }
 
+bool decompose_separable_kernel(const SkISize& kernelSize, const float* kernel,
+                                TArray<float>* rowKernel, TArray<float>* columnKernel) {
+    const int width = kernelSize.fWidth;
+    const int height = kernelSize.fHeight;
+    if (width == 1 || height == 1) {
+        return false; // Already one dimensional, so a second pass would only add work
+    }
+
+    // Every row of a rank 1 kernel is a multiple of the row holding the largest coefficient.
+    int pivotX = 0, pivotY = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (std::fabs(kernel[y * width + x]) > std::fabs(kernel[pivotY * width + pivotX])) {
+                pivotX = x;
+                pivotY = y;
+            }
+        }
+    }
+    const float pivot = kernel[pivotY * width + pivotX];
+    if (pivot == 0.f) {
+        return false;
+    }
+
+    const float tolerance = 1e-6f * pivot * pivot;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float expected = kernel[y * width + pivotX] * kernel[pivotY * width + x];
+            if (std::fabs(kernel[y * width + x] * pivot - expected) > tolerance) {
+                return false;
+            }
+        }
+    }
+
+    rowKernel->reset(width);
+    for (int x = 0; x < width; ++x) {
+        (*rowKernel)[x] = kernel[pivotY * width + x];
+    }
+    columnKernel->reset(height);
+    for (int y = 0; y < height; ++y) {
+        (*columnKernel)[y] = kernel[y * width + pivotX] / pivot;
+    }
+    return true;
+}
+
+// Adds 'k' times each of the 'count' pixels in 'src' to 'dst'. Kernels are applied one coefficient
+// at a time across a whole row so that the inner loop streams through contiguous pixels.
+void accumulate_row(const skvx::float4* src, float k, int count, skvx::float4* dst) {
+    for (int x = 0; x < count; ++x) {
+        dst[x] += k * src[x];
+    }
+}
+
 } // anonymous namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -388,6 +462,131 @@ sk_sp<SkShader> SkMatrixConvolutionImageFilter::createShader(const skif::Context
     return builder.makeShader();
 }
 
+std::optional<skif::FilterResult> SkMatrixConvolutionImageFilter::rasterConvolve(
+        const skif::Context& ctx,
+        const skif::FilterResult& input,
+        const skif::LayerSpace<SkIRect>& outputBounds) const {
+    const SkColorType colorType = ctx.backend()->colorType();
+    if (colorType != kRGBA_8888_SkColorType && colorType != kBGRA_8888_SkColorType) {
+        return {};
+    }
+    if (!input || input.image()->isGaneshBacked() || input.image()->isGraphiteBacked()) {
+        return {};
+    }
+
+    const skif::LayerSpace<SkIRect> sampleBounds = this->boundsSampledByKernel(outputBounds);
+    auto [image, origin] = input.imageAndOffset(ctx.withNewDesiredOutput(sampleBounds));
+    SkBitmap src;
+    if (image && (!SkSpecialImages::AsBitmap(image.get(), &src) ||
+                  src.colorType() != colorType ||
+                  src.alphaType() == kUnpremul_SkAlphaType)) {
+        return {};
+    }
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(SkImageInfo::Make(SkISize(outputBounds.size()), colorType,
+                                              kPremul_SkAlphaType, ctx.refColorSpace()))) {
+        return skif::FilterResult{};
+    }
+
+    // Each sampled row is converted to float once, unpremultiplying when alpha is not convolved,
+    // as the kernel first reaches it. The rows go into a ring holding as many rows as the kernel
+    // is tall, so the working memory is bounded by the kernel height rather than by the output
+    // height. Row x coordinates have the sample bounds' left edge at 0.
+    const int outWidth = dst.width();
+    const int outHeight = dst.height();
+    const int sampleWidth = sampleBounds.width();
+    const int kernelHeight = fKernelSize.height();
+    SkASSERT(sampleWidth == outWidth + fKernelSize.width() - 1);
+    SkASSERT(sampleBounds.height() == outHeight + kernelHeight - 1);
+    AutoTArray<skvx::float4> sampleRing(SkToSizeT(sampleWidth) * kernelHeight);
+    // For separable kernels, the horizontal pass over each row in 'sampleRing', in the same slot.
+    AutoTArray<skvx::float4> rowRing(fRowKernel.empty() ? 0
+                                                        : SkToSizeT(outWidth) * kernelHeight);
+    const int srcDX = image ? sampleBounds.left() - origin.x() : 0;
+    const int srcDY = image ? sampleBounds.top() - origin.y() : 0;
+    auto loadRow = [&](int y) {
+        skvx::float4* row = &sampleRing[(y % kernelHeight) * sampleWidth];
+        const int sy = y + srcDY;
+        for (int x = 0; x < sampleWidth; ++x) {
+            const int sx = x + srcDX;
+            skvx::float4 c = 0.f;
+            if (image && sx >= 0 && sx < src.width() && sy >= 0 && sy < src.height()) {
+                c = skvx::cast<float>(skvx::byte4::Load(src.getAddr32(sx, sy))) * (1 / 255.f);
+                if (!fConvolveAlpha && c[3] > 0.f) {
+                    const float a = c[3];
+                    c = c * (1.f / a);
+                    c[3] = a;
+                }
+            }
+            row[x] = c;
+        }
+        if (!fRowKernel.empty()) {
+            skvx::float4* filtered = &rowRing[(y % kernelHeight) * outWidth];
+            std::fill_n(filtered, outWidth, skvx::float4(0.f));
+            for (int kx = 0; kx < fRowKernel.size(); ++kx) {
+                if (fRowKernel[kx] != 0.f) {
+                    accumulate_row(&row[kx], fRowKernel[kx], outWidth, filtered);
+                }
+            }
+        }
+    };
+
+    AutoTArray<skvx::float4> sums(outWidth);
+    const float bias = fBias / 255.f;
+    for (int y = 0; y < kernelHeight - 1; ++y) {
+        loadRow(y);
+    }
+    for (int y = 0; y < outHeight; ++y) {
+        // This replaces the row that output row y-1 started at, which nothing reads anymore.
+        loadRow(y + kernelHeight - 1);
+
+        std::fill_n(sums.get(), outWidth, skvx::float4(0.f));
+        for (int ky = 0; ky < kernelHeight; ++ky) {
+            const int slot = (y + ky) % kernelHeight;
+            if (!fRowKernel.empty()) {
+                // A vertical pass over the horizontally filtered rows.
+                if (fColumnKernel[ky] != 0.f) {
+                    accumulate_row(&rowRing[slot * outWidth], fColumnKernel[ky], outWidth,
+                                   sums.get());
+                }
+                continue;
+            }
+            for (int kx = 0; kx < fKernelSize.width(); ++kx) {
+                const float k = fKernel[ky * fKernelSize.width() + kx];
+                if (k != 0.f) {
+                    accumulate_row(&sampleRing[slot * sampleWidth + kx], k, outWidth, sums.get());
+                }
+            }
+        }
+
+        // Matches the shader's final gain, bias, and premultiplication.
+        const skvx::float4* sampleRow =
+                &sampleRing[((y + fKernelOffset.y()) % kernelHeight) * sampleWidth +
+                            fKernelOffset.x()];
+        uint32_t* dstRow = dst.getAddr32(0, y);
+        for (int x = 0; x < outWidth; ++x) {
+            skvx::float4 color = sums[x] * fGain + bias;
+            float a;
+            if (fConvolveAlpha) {
+                a = std::clamp(color[3], 0.f, 1.f);
+            } else {
+                a = sampleRow[x][3];
+                color = color * a;
+            }
+            color = skvx::pin(color, skvx::float4(0.f), skvx::float4(a));
+            color[3] = a;
+            skvx::cast<uint8_t>(skvx::lrint(color * 255.f)).store(dstRow + x);
+        }
+    }
+    dst.setImmutable();
+
+    return skif::FilterResult(SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                                              dst,
+                                                              ctx.backend()->surfaceProps()),
+                              outputBounds.topLeft());
+}
+
 skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         const skif::Context& context) const {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
@@ -409,6 +608,11 @@ skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         }
     }
 
+    if (std::optional<skif::FilterResult> rasterOutput =
+                this->rasterConvolve(context, childOutput, outputBounds)) {
+        return *rasterOutput;
+    }
+
     skif::FilterResult::Builder builder{context};
     builder.add(childOutput,
                 this->boundsSampledByKernel(outputBounds),
@@ -12,6 +12,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTArray.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -83,9 +84,15 @@ sk_sp<SkFlattenable> SkMergeImageFilter::CreateProc(SkReadBuffer& buffer) {
 
 skif::FilterResult SkMergeImageFilter::onFilterImage(const skif::Context& ctx) const {
     const int inputCount = this->countInputs();
+    skia_private::TArray<skif::Context> contexts;
+    contexts.push_back_n(inputCount, ctx);
+    skia_private::TArray<skif::FilterResult> childOutputs;
+    childOutputs.push_back_n(inputCount);
+    this->getChildOutputs(contexts, childOutputs);
+
     skif::FilterResult::Builder builder{ctx};
     for (int i = 0; i < inputCount; ++i) {
-        builder.add(this->getChildOutput(i, ctx));
+        builder.add(childOutputs[i]);
     }
     return builder.merge();
 }
@@ -7,9 +7,13 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
@@ -18,10 +22,13 @@
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <algorithm>
@@ -168,10 +175,170 @@ sk_sp<SkShader> make_sparse_morphology(sk_sp<SkShader> input,
     return builder.makeShader();
 }
 
+// The raster backend evaluates each pass directly on the pixels with the van Herk/Gil-Werman
+// algorithm. A line is split into blocks as wide as the kernel window (2R+1), and the aggregate is
+// accumulated forwards from each block's start into 'g' and backwards from each block's end into
+// 'h'. Any window then spans at most two blocks, so its aggregate is op(h[i], g[i+2R]), which costs
+// three min/max operations per pixel regardless of R.
+//
+// Four lines are processed together so each element holds one 8888 pixel from every line. Per
+// channel min/max of premul colors matches what the shaders compute.
+static constexpr int kMorphologyLanes = 4;
+using MorphologyVec = skvx::Vec<4 * kMorphologyLanes, uint8_t>;
+
+struct Dilate {
+    MorphologyVec operator()(const MorphologyVec& a, const MorphologyVec& b) const {
+        return skvx::max(a, b);
+    }
+};
+
+struct Erode {
+    MorphologyVec operator()(const MorphologyVec& a, const MorphologyVec& b) const {
+        return skvx::min(a, b);
+    }
+};
+
+// 'src' holds 'count' elements and 'dst' receives the (count - window + 1) window aggregates.
+template <typename Op>
+void van_herk_gil_werman(const MorphologyVec* src, int count, int window,
+                         MorphologyVec* g, MorphologyVec* h, MorphologyVec* dst) {
+    Op op;
+    for (int blockStart = 0; blockStart < count; blockStart += window) {
+        const int blockEnd = std::min(blockStart + window, count);
+        g[blockStart] = src[blockStart];
+        for (int i = blockStart + 1; i < blockEnd; ++i) {
+            g[i] = op(g[i - 1], src[i]);
+        }
+        h[blockEnd - 1] = src[blockEnd - 1];
+        for (int i = blockEnd - 2; i >= blockStart; --i) {
+            h[i] = op(h[i + 1], src[i]);
+        }
+    }
+    for (int i = 0; i + window <= count; ++i) {
+        dst[i] = op(h[i], g[i + window - 1]);
+    }
+}
+
+// Fills 'dst', whose top-left pixel is at 'dstOrigin', with the morphology of 'src', whose top-left
+// is at 'srcOrigin'. Pixels outside of 'src' are treated as transparent black.
+template <typename Op>
+void raster_morphology(const SkPixmap& src, SkIPoint srcOrigin,
+                       const SkPixmap& dst, SkIPoint dstOrigin,
+                       MorphDirection dir, int radius) {
+    const bool horizontal = dir == MorphDirection::kX;
+    const int lineCount = horizontal ? dst.height() : dst.width();
+    const int lineLength = horizontal ? dst.width() : dst.height();
+    const int window = 2 * radius + 1;
+    const int count = lineLength + 2 * radius;
+
+    skia_private::AutoTArray<MorphologyVec> storage(4 * SkToSizeT(count));
+    MorphologyVec* line = storage.get();
+    MorphologyVec* g = line + count;
+    MorphologyVec* h = g + count;
+    MorphologyVec* out = h + count;
+
+    // Layer-space offset from a (line, position) pair to the source pixel it reads.
+    const int srcDX = dstOrigin.fX - srcOrigin.fX - (horizontal ? radius : 0);
+    const int srcDY = dstOrigin.fY - srcOrigin.fY - (horizontal ? 0 : radius);
+
+    for (int firstLine = 0; firstLine < lineCount; firstLine += kMorphologyLanes) {
+        const int lanes = std::min(kMorphologyLanes, lineCount - firstLine);
+        uint32_t pixels[kMorphologyLanes];
+        for (int i = 0; i < count; ++i) {
+            for (int lane = 0; lane < kMorphologyLanes; ++lane) {
+                const int l = firstLine + std::min(lane, lanes - 1);
+                const int x = (horizontal ? i : l) + srcDX;
+                const int y = (horizontal ? l : i) + srcDY;
+                pixels[lane] = (x >= 0 && x < src.width() && y >= 0 && y < src.height())
+                                       ? *src.addr32(x, y) : 0;
+            }
+            line[i] = MorphologyVec::Load(pixels);
+        }
+
+        van_herk_gil_werman<Op>(line, count, window, g, h, out);
+
+        for (int i = 0; i < lineLength; ++i) {
+            out[i].store(pixels);
+            for (int lane = 0; lane < lanes; ++lane) {
+                const int l = firstLine + lane;
+                *dst.writable_addr32(horizontal ? i : l, horizontal ? l : i) = pixels[lane];
+            }
+        }
+    }
+}
+
+// Returns the morphology pass evaluated on the CPU, or an empty optional if 'input' must be
+// processed with the shader-based passes instead.
+std::optional<skif::FilterResult> raster_morphology_pass(const skif::Context& ctx,
+                                                         const skif::FilterResult& input,
+                                                         MorphType type,
+                                                         MorphDirection dir,
+                                                         int radius) {
+    const SkColorType colorType = ctx.backend()->colorType();
+    if (colorType != kRGBA_8888_SkColorType && colorType != kBGRA_8888_SkColorType) {
+        return {};
+    }
+    if (!input) {
+        return skif::FilterResult{};
+    }
+    if (input.image()->isGaneshBacked() || input.image()->isGraphiteBacked()) {
+        return {};
+    }
+
+    const skif::LayerSpace<SkISize> axisRadius{{dir == MorphDirection::kX ? radius : 0,
+                                                dir == MorphDirection::kY ? radius : 0}};
+    skif::LayerSpace<SkIRect> sampleBounds = ctx.desiredOutput();
+    sampleBounds.outset(axisRadius);
+    auto [image, origin] = input.imageAndOffset(ctx.withNewDesiredOutput(sampleBounds));
+    if (!image) {
+        return skif::FilterResult{};
+    }
+    SkBitmap src;
+    if (!SkSpecialImages::AsBitmap(image.get(), &src) || src.colorType() != colorType ||
+        src.alphaType() == kUnpremul_SkAlphaType) {
+        return {};
+    }
+
+    // Erosion is transparent wherever the window reaches outside of the image, while dilation
+    // can spread the image by the radius.
+    skif::LayerSpace<SkIRect> outputBounds{SkIRect::MakeXYWH(origin.x(), origin.y(),
+                                                             src.width(), src.height())};
+    if (type == MorphType::kDilate) {
+        outputBounds.outset(axisRadius);
+    }
+    if (!outputBounds.intersect(ctx.desiredOutput())) {
+        return skif::FilterResult{};
+    }
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(SkImageInfo::Make(SkISize(outputBounds.size()), colorType,
+                                              kPremul_SkAlphaType, ctx.refColorSpace()))) {
+        return skif::FilterResult{};
+    }
+    const SkIPoint srcOrigin = SkIPoint(origin);
+    const SkIPoint dstOrigin = SkIPoint(outputBounds.topLeft());
+    if (type == MorphType::kDilate) {
+        raster_morphology<Dilate>(src.pixmap(), srcOrigin, dst.pixmap(), dstOrigin, dir, radius);
+    } else {
+        raster_morphology<Erode>(src.pixmap(), srcOrigin, dst.pixmap(), dstOrigin, dir, radius);
+    }
+    dst.setImmutable();
+
+    return skif::FilterResult(SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                                              dst,
+                                                              ctx.backend()->surfaceProps()),
+                              outputBounds.topLeft());
+}
+
 skif::FilterResult morphology_pass(const skif::Context& ctx, const skif::FilterResult& input,
                                    MorphType type, MorphDirection dir, int radius) {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
 
+    if (std::optional<skif::FilterResult> rasterOutput =
+                raster_morphology_pass(ctx, input, type, dir, radius)) {
+        return *rasterOutput;
+    }
+
     auto axisDelta = [dir](int step) {
         return skif::LayerSpace<SkISize>({
                 dir == MorphDirection::kX ? step : 0,
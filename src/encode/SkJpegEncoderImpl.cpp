@@ -11,8 +11,10 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkYUVAInfo.h"
@@ -23,21 +25,25 @@
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "src/base/SkMSAN.h"
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegPriv.h"
 #include "src/core/SkConvertPixels.h"
 #include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/encode/SkJPEGWriteUtility.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 class GrDirectContext;
 class SkColorSpace;
@@ -47,6 +53,15 @@ extern "C" {
 #include "jpeglib.h"  // NO_G3_REWRITE
 }
 
+// Concurrent encodes split the image into strips of about this many bytes of pixels.
+static constexpr size_t kConcurrentStripBytes = 256 * 1024;
+
+// The StartOfFrame markers libjpeg-turbo writes for 8 bit Huffman coded images, and the last of
+// the restart markers RST0 through RST7, which are used in turn.
+static constexpr uint8_t kJpegMarkerStartOfFrameBaseline = 0xC0;
+static constexpr uint8_t kJpegMarkerStartOfFrameExtended = 0xC1;
+static constexpr uint8_t kJpegMarkerRestart7 = 0xD7;
+
 class SkJpegEncoderMgr final : SkNoncopyable {
 public:
     /*
@@ -69,6 +84,10 @@ public:
     skjpeg_error_mgr* errorMgr() { return &fErrMgr; }
 
     bool shouldUseColorXform() { return fUseColorXform; }
+
+    // Emits a restart marker every |mcus| MCUs, and uses the standard Huffman tables instead of
+    // optimized ones, so that strips of an image encoded separately can be concatenated.
+    void setRestartInterval(unsigned int mcus) { fRestartInterval = mcus; }
     bool colorTransformProc(void* dst, const void* src, int width);
 
     ~SkJpegEncoderMgr() { jpeg_destroy_compress(&fCInfo); }
@@ -89,6 +108,7 @@ private:
     std::optional<SkImageInfo> fSrcInfo;
     std::optional<SkImageInfo> fDstInfo;
     bool fUseColorXform = false;
+    unsigned int fRestartInterval = 0;
 };
 
 // This function should only be called if fUseColorXform is true and thus fSrcInfo
@@ -280,10 +300,14 @@ bool SkJpegEncoderMgr::initializeYUV(const SkYUVAPixmapInfo& srcInfo,
 void SkJpegEncoderMgr::initializeCommon(
         const SkJpegEncoder::Options& options,
         const SkJpegMetadataEncoder::SegmentList& metadataSegments) {
-    // Tells libjpeg-turbo to compute optimal Huffman coding tables
-    // for the image.  This improves compression at the cost of
-    // slower encode performance.
-    fCInfo.optimize_coding = TRUE;
+    if (fRestartInterval) {
+        fCInfo.restart_interval = fRestartInterval;
+    } else {
+        // Tells libjpeg-turbo to compute optimal Huffman coding tables
+        // for the image.  This improves compression at the cost of
+        // slower encode performance.
+        fCInfo.optimize_coding = TRUE;
+    }
 
     jpeg_set_quality(&fCInfo, options.fQuality, TRUE);
     jpeg_start_compress(&fCInfo, TRUE);
@@ -322,11 +346,13 @@ std::unique_ptr<SkEncoder> SkJpegEncoderImpl::MakeRGB(
         SkWStream* dst,
         const SkPixmap& src,
         const SkJpegEncoder::Options& options,
-        const SkJpegMetadataEncoder::SegmentList& metadataSegments) {
+        const SkJpegMetadataEncoder::SegmentList& metadataSegments,
+        unsigned int restartInterval) {
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
     std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    encoderMgr->setRestartInterval(restartInterval);
     skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
     if (setjmp(jmp)) {
         return nullptr;
@@ -399,9 +425,145 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
     return true;
 }
 
+// Finds the parts of a JPEG written by libjpeg-turbo: the offset of the image height in the
+// StartOfFrame segment, and the entropy-coded data between the StartOfScan segment and the
+// EndOfImage marker.
+static bool find_scan(const SkData* jpeg, size_t* heightOffset, size_t* scanBegin,
+                      size_t* scanEnd) {
+    const uint8_t* data = jpeg->bytes();
+    const size_t size = jpeg->size();
+    if (size < 2 * kJpegMarkerCodeSize || data[size - 2] != 0xFF ||
+        data[size - 1] != kJpegMarkerEndOfImage) {
+        return false;
+    }
+    *heightOffset = 0;
+    size_t offset = kJpegMarkerCodeSize;
+    while (offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize <= size &&
+           data[offset] == 0xFF) {
+        const uint8_t marker = data[offset + 1];
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        const size_t params = offset + kJpegMarkerCodeSize + kJpegSegmentParameterLengthSize;
+        if (marker == kJpegMarkerStartOfFrameBaseline ||
+            marker == kJpegMarkerStartOfFrameExtended) {
+            // The parameters begin with the sample precision, then the height.
+            *heightOffset = params + 1;
+        } else if (marker == kJpegMarkerStartOfScan) {
+            *scanBegin = offset + kJpegMarkerCodeSize + length;
+            *scanEnd = size - kJpegMarkerCodeSize;
+            return *heightOffset != 0 && *scanBegin <= *scanEnd;
+        }
+        offset += kJpegMarkerCodeSize + length;
+    }
+    return false;
+}
+
+bool SkJpegEncoderImpl::EncodeConcurrently(SkWStream* dst,
+                                           const SkPixmap& src,
+                                           const SkJpegEncoder::Options& options,
+                                           const SkJpegMetadataEncoder::SegmentList& metadata,
+                                           SkExecutor& executor) {
+    if (!dst || !SkPixmapIsValid(src)) {
+        return false;
+    }
+    const int width = src.width(), height = src.height();
+    // The strips would each fit, but the joined image could not be decoded.
+    if (width > JPEG_MAX_DIMENSION || height > JPEG_MAX_DIMENSION) {
+        return false;
+    }
+
+    // Each row of MCUs is a restart interval. Strips begin every multiple of eight rows of MCUs,
+    // so with an RST7 marker between strips, the strips' own restart markers, which libjpeg
+    // numbers from RST0, are already in sequence.
+    const bool gray = SkColorTypeNumChannels(src.colorType()) == 1;
+    const int mcuWidth =
+            gray || options.fDownsample == SkJpegEncoder::Downsample::k444 ? 8 : 16;
+    const int mcuHeight =
+            gray || options.fDownsample != SkJpegEncoder::Downsample::k420 ? 8 : 16;
+    const int mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+    const int stripAlignment = 8 * mcuHeight;
+    int rowsPerStrip = SkToInt(std::max<size_t>(kConcurrentStripBytes / (4 * width), 1));
+    rowsPerStrip = (rowsPerStrip + stripAlignment - 1) / stripAlignment * stripAlignment;
+    const int stripCount = (height - 1) / rowsPerStrip + 1;
+    if (stripCount < 2 || mcusPerRow > 0xFFFF) {
+        auto encoder = MakeRGB(dst, src, options, metadata);
+        return encoder && encoder->encodeRows(height);
+    }
+
+    std::vector<sk_sp<SkData>> strips(stripCount);
+    SkTaskGroup(executor).batch(stripCount, [&](int i) {
+        const int top = i * rowsPerStrip;
+        SkPixmap strip;
+        SkAssertResult(src.extractSubset(
+                &strip, SkIRect::MakeLTRB(0, top, width, std::min(top + rowsPerStrip, height))));
+        // Only the first strip's header is kept.
+        SkDynamicMemoryWStream stream;
+        auto encoder = MakeRGB(&stream, strip, options,
+                               i == 0 ? metadata : SkJpegMetadataEncoder::SegmentList(),
+                               mcusPerRow);
+        if (encoder && encoder->encodeRows(strip.height())) {
+            strips[i] = stream.detachAsData();
+        }
+    });
+
+    // Every strip is checked before anything is written, so that a failed strip leaves dst
+    // untouched.
+    size_t heightOffset = 0;
+    std::vector<std::pair<size_t, size_t>> scans(stripCount);
+    for (int i = 0; i < stripCount; ++i) {
+        size_t stripHeightOffset;
+        if (!strips[i] || !find_scan(strips[i].get(), &stripHeightOffset, &scans[i].first,
+                                     &scans[i].second)) {
+            return false;
+        }
+        if (i == 0) {
+            heightOffset = stripHeightOffset;
+        }
+    }
+
+    // The first strip's header, with the height of the whole image, and then each strip's
+    // entropy-coded data, separated by the restart marker that ends the previous strip's last
+    // interval.
+    for (int i = 0; i < stripCount; ++i) {
+        const uint8_t* data = strips[i]->bytes();
+        const auto [scanBegin, scanEnd] = scans[i];
+        if (i == 0) {
+            const uint8_t heightBE[2] = {SkToU8(height >> 8), SkToU8(height & 0xFF)};
+            if (!dst->write(data, heightOffset) || !dst->write(heightBE, sizeof(heightBE)) ||
+                !dst->write(data + heightOffset + 2, scanBegin - heightOffset - 2)) {
+                return false;
+            }
+        } else {
+            const uint8_t restart[2] = {0xFF, kJpegMarkerRestart7};
+            if (!dst->write(restart, sizeof(restart))) {
+                return false;
+            }
+        }
+        if (!dst->write(data + scanBegin, scanEnd - scanBegin)) {
+            return false;
+        }
+    }
+    const uint8_t endOfImage[2] = {0xFF, kJpegMarkerEndOfImage};
+    return dst->write(endOfImage, sizeof(endOfImage));
+}
+
+static SkJpegMetadataEncoder::SegmentList make_metadata(const SkJpegEncoder::Options& options,
+                                                        const SkColorSpace* colorSpace) {
+    SkJpegMetadataEncoder::SegmentList metadataSegments;
+    SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
+    SkJpegMetadataEncoder::AppendICC(metadataSegments, options, colorSpace);
+    if (options.fOrigin.has_value()) {
+      SkJpegMetadataEncoder::AppendOrigin(metadataSegments, options.fOrigin.value());
+    }
+    return metadataSegments;
+}
+
 namespace SkJpegEncoder {
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (options.fExecutor) {
+        return SkJpegEncoderImpl::EncodeConcurrently(
+                dst, src, options, make_metadata(options, src.colorSpace()), *options.fExecutor);
+    }
     auto encoder = Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
@@ -431,26 +593,15 @@ sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& op
 }
 
 std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    SkJpegMetadataEncoder::SegmentList metadataSegments;
-    SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
-    SkJpegMetadataEncoder::AppendICC(metadataSegments, options, src.colorSpace());
-    if (options.fOrigin.has_value()) {
-      SkJpegMetadataEncoder::AppendOrigin(metadataSegments, options.fOrigin.value());
-    }
-    return SkJpegEncoderImpl::MakeRGB(dst, src, options, metadataSegments);
+    return SkJpegEncoderImpl::MakeRGB(dst, src, options, make_metadata(options, src.colorSpace()));
 }
 
 std::unique_ptr<SkEncoder> Make(SkWStream* dst,
                                 const SkYUVAPixmaps& src,
                                 const SkColorSpace* srcColorSpace,
                                 const Options& options) {
-    SkJpegMetadataEncoder::SegmentList metadataSegments;
-    SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
-    SkJpegMetadataEncoder::AppendICC(metadataSegments, options, srcColorSpace);
-    if (options.fOrigin.has_value()) {
-      SkJpegMetadataEncoder::AppendOrigin(metadataSegments, options.fOrigin.value());
-    }
-    return SkJpegEncoderImpl::MakeYUV(dst, src, srcColorSpace, options, metadataSegments);
+    return SkJpegEncoderImpl::MakeYUV(
+            dst, src, srcColorSpace, options, make_metadata(options, srcColorSpace));
 }
 
 }  // namespace SkJpegEncoder
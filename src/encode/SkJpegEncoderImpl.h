@@ -21,6 +21,7 @@
 #include <vector>
 
 class SkColorSpace;
+class SkExecutor;
 class SkJpegEncoderMgr;
 class SkPixmap;
 class SkWStream;
@@ -66,13 +67,22 @@ public:
     static std::unique_ptr<SkEncoder> MakeRGB(SkWStream* dst,
                                               const SkPixmap& src,
                                               const SkJpegEncoder::Options& options,
-                                              const SkJpegMetadataEncoder::SegmentList& metadata);
+                                              const SkJpegMetadataEncoder::SegmentList& metadata,
+                                              unsigned int restartInterval = 0);
     static std::unique_ptr<SkEncoder> MakeYUV(SkWStream* dst,
                                               const SkYUVAPixmaps& srcYUVA,
                                               const SkColorSpace* srcYUVAColorSpace,
                                               const SkJpegEncoder::Options& options,
                                               const SkJpegMetadataEncoder::SegmentList& metadata);
 
+    // Encodes strips of |src|'s rows concurrently on |executor|, and joins them at restart
+    // markers into a single image.
+    static bool EncodeConcurrently(SkWStream* dst,
+                                   const SkPixmap& src,
+                                   const SkJpegEncoder::Options& options,
+                                   const SkJpegMetadataEncoder::SegmentList& metadata,
+                                   SkExecutor& executor);
+
     ~SkJpegEncoderImpl() override;
 
 protected:
@@ -57,6 +57,11 @@ protected:
 
     const TargetInfo& targetInfo() const { return fTargetInfo; }
 
+    // Converts row `y` of the source into `dst`, which must hold `fDstRowSize`
+    // bytes. This does not depend on the encoder's current row, so it can be
+    // called from several threads at once.
+    bool convertRow(int y, uint8_t* dst) const;
+
 private:
     TargetInfo fTargetInfo;
     bool fFinishedEncoding = false;
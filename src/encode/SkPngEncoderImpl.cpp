@@ -26,19 +26,27 @@
 #include "include/private/SkGainmapInfo.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkMath.h"
 #include "include/private/base/SkNoncopyable.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
+#include "src/base/SkEndian.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/encode/SkPngEncoderBase.h"
+#include "src/encode/SkPngFilters.h"
 #include "src/image/SkImage_Base.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -46,6 +54,8 @@
 #include <png.h>
 #include <pngconf.h>
 
+#include "zlib.h"  // NO_G3_REWRITE
+
 class GrDirectContext;
 class SkImage;
 
@@ -90,6 +100,8 @@ public:
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
     transform_scanline_proc proc() const { return fProc; }
+    int filterFlags() const { return fFilterFlags; }
+    int zlibLevel() const { return fZLibLevel; }
 
     ~SkPngEncoderMgr() { png_destroy_write_struct(&fPngPtr, &fInfoPtr); }
 
@@ -99,6 +111,8 @@ private:
     png_structp fPngPtr;
     png_infop fInfoPtr;
     transform_scanline_proc fProc = nullptr;
+    int fFilterFlags = 0;
+    int fZLibLevel = 0;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -233,13 +247,15 @@ bool SkPngEncoderMgr::setHeader(const SkPngEncoderBase::TargetInfo& targetInfo,
         png_set_sBIT(fPngPtr, fInfoPtr, &sigBit);
     }
 
-    int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
-    SkASSERT(filters == (int)options.fFilterFlags);
-    png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, filters);
+    // The image data is filtered and compressed by SkPngEncoderImpl rather than libpng.
+    fFilterFlags = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
+    SkASSERT(fFilterFlags == (int)options.fFilterFlags);
+    if (fFilterFlags == 0) {
+        fFilterFlags = PNG_FILTER_NONE;
+    }
 
-    int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
-    SkASSERT(zlibLevel == options.fZLibLevel);
-    png_set_compression_level(fPngPtr, zlibLevel);
+    fZLibLevel = std::min(std::max(0, options.fZLibLevel), 9);
+    SkASSERT(fZLibLevel == options.fZLibLevel);
 
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
@@ -420,20 +436,97 @@ bool SkPngEncoderMgr::writeInfo(const SkImageInfo& srcInfo, const SkPngEncoderBa
       return false;
   }
   png_write_info(fPngPtr, fInfoPtr);
+  return true;
+}
 
-  const SkEncodedInfo& dstInfo = targetInfo.fDstInfo;
-  const std::optional<SkImageInfo>& dstRowInfo = targetInfo.fDstRowInfo;
+// Strips of about this many bytes of filtered rows are compressed concurrently.
+static constexpr size_t kConcurrentStripBytes = 256 * 1024;
+
+// Each strip is compressed with the end of the previous strip as its preset dictionary, so that
+// the strips can reference it like a single deflate stream would. This is deflate's window size.
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+// Rows encoded one at a time are compressed into IDAT chunks of this size, like libpng's.
+static constexpr size_t kIdatChunkBytes = 8192;
+
+// At these zlib levels filtering costs about as much as compressing, so rather than trying every
+// allowed filter on every row, the filter picked most often for the first kFilterLearningRows
+// rows is used for the rest of the image.
+static constexpr int kMaxFilterLearningZLibLevel = 3;
+static constexpr int kFilterLearningRows = 8;
+
+// Writes a chunk whose CRC, which covers the chunk type and data, has already been computed.
+static bool write_png_chunk(SkWStream* stream, const char type[4], SkSpan<const uint8_t> data,
+                            uint32_t crc) {
+    return stream->write32(SkEndian_SwapBE32(SkToU32(data.size()))) &&
+           stream->write(type, 4) &&
+           stream->write(data.data(), data.size()) &&
+           stream->write32(SkEndian_SwapBE32(crc));
+}
 
-  // Strip input data that has 4 or 8 bytes per pixel down to 3 or 6 bytes if we don't want alpha.
-  if (dstInfo.color() == SkEncodedInfo::kRGBA_Color) {
-      SkASSERT(dstRowInfo);
-      if (dstRowInfo->isOpaque()) {
-          png_set_filler(fPngPtr, 0, PNG_FILLER_AFTER);
-      }
-  }
-  return true;
+static uint32_t chunk_crc(const char type[4], const uint8_t* data, size_t size) {
+    return crc32(crc32(0, reinterpret_cast<const Bytef*>(type), 4), data, SkToU32(size));
 }
 
+struct SkPngEncoderImpl::FilterParams {
+    size_t fPngRowSize;   // Unfiltered bytes per row
+    size_t fBytesPerPixel;
+    int fFilterFlags;
+    int fLearnedFilterFlags;  // Used from row kFilterLearningRows on
+    int fZLibLevel;
+    int fZLibStrategy;
+    int fHeight;
+
+    int filterFlagsForRow(int y) const {
+        return y < kFilterLearningRows ? fFilterFlags : fLearnedFilterFlags;
+    }
+};
+
+struct SkPngEncoderImpl::CompressedStrip {
+    std::vector<uint8_t> fData;  // This strip's piece of the zlib stream
+    uint32_t fAdler;             // Adler-32 of the strip's filtered rows
+    size_t fFilteredSize;
+    uint32_t fCrc;               // CRC of an IDAT chunk holding fData
+};
+
+struct SkPngEncoderImpl::RowDeflater {
+    ~RowDeflater() {
+        if (fInitialized) {
+            deflateEnd(&fZStream);
+        }
+    }
+
+    // Compresses whatever is in fZStream's input, writing each IDAT chunk as it fills up.
+    bool compress(SkWStream* stream, int flush) {
+        int result;
+        do {
+            result = deflate(&fZStream, flush);
+            if (result != Z_OK && result != Z_STREAM_END) {
+                return false;
+            }
+            if (fZStream.avail_out == 0 || result == Z_STREAM_END) {
+                const size_t size = kIdatChunkBytes - fZStream.avail_out;
+                if (size > 0 &&
+                    !write_png_chunk(stream, "IDAT", {fChunk, size},
+                                     chunk_crc("IDAT", fChunk, size))) {
+                    return false;
+                }
+                fZStream.next_out = fChunk;
+                fZStream.avail_out = SkToU32(kIdatChunkBytes);
+            }
+        } while (fZStream.avail_in > 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+        return true;
+    }
+
+    z_stream fZStream = {};
+    bool fInitialized = false;
+    FilterParams fParams;
+    std::vector<uint8_t> fRows;      // The unfiltered previous and current rows
+    std::vector<uint8_t> fFiltered;  // The current row's filter type byte and filtered bytes
+    std::vector<uint8_t> fScratch;
+    uint8_t fChunk[kIdatChunkBytes];
+};
+
 SkPngEncoderImpl::SkPngEncoderImpl(TargetInfo targetInfo,
                                    std::unique_ptr<SkPngEncoderMgr> encoderMgr,
                                    const SkPixmap& src)
@@ -441,36 +534,296 @@ SkPngEncoderImpl::SkPngEncoderImpl(TargetInfo targetInfo,
 
 SkPngEncoderImpl::~SkPngEncoderImpl() {}
 
-bool SkPngEncoderImpl::onEncodeRow(SkSpan<const uint8_t> row) {
-    if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
-        return false;
+SkWStream* SkPngEncoderImpl::stream() const {
+    return static_cast<SkWStream*>(png_get_io_ptr(fEncoderMgr->pngPtr()));
+}
+
+SkPngEncoderImpl::FilterParams SkPngEncoderImpl::filterParams() const {
+    png_structp pngPtr = fEncoderMgr->pngPtr();
+    png_infop infoPtr = fEncoderMgr->infoPtr();
+    const int bitDepth = png_get_bit_depth(pngPtr, infoPtr);
+    const int filterFlags = fEncoderMgr->filterFlags();
+
+    FilterParams params;
+    params.fPngRowSize = png_get_rowbytes(pngPtr, infoPtr);
+    params.fBytesPerPixel = std::max(png_get_channels(pngPtr, infoPtr) * bitDepth / 8, 1);
+    params.fFilterFlags = filterFlags;
+    params.fLearnedFilterFlags = filterFlags;
+    params.fZLibLevel = fEncoderMgr->zlibLevel();
+    // libpng's default strategy
+    params.fZLibStrategy = filterFlags & ~PNG_FILTER_NONE ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+    params.fHeight = fSrc.height();
+    return params;
+}
+
+bool SkPngEncoderImpl::learnFilterFlags(FilterParams* params) const {
+    if (params->fZLibLevel < 1 || params->fZLibLevel > kMaxFilterLearningZLibLevel ||
+        SkIsPow2(params->fFilterFlags)) {
+        return true;
+    }
+
+    // Filtering doesn't depend on the encoder's state, so the learning rows can be filtered
+    // again by whichever path encodes them and will come out the same.
+    const size_t rowSize = params->fPngRowSize;
+    skia_private::AutoTMalloc<uint8_t> converted(this->targetInfo().fDstRowSize);
+    std::vector<uint8_t> rows(2 * rowSize, 0);
+    skia_private::AutoTMalloc<uint8_t> filtered(rowSize + 1);
+    skia_private::AutoTMalloc<uint8_t> scratch(rowSize + 1);
+    int counts[SkPngFilters::kTypeCount] = {};
+    const int learningRows = std::min(kFilterLearningRows, params->fHeight);
+    for (int y = 0; y < learningRows; ++y) {
+        uint8_t* prev = rows.data() + ((y + 1) % 2) * rowSize;
+        uint8_t* curr = rows.data() + (y % 2) * rowSize;
+        if (!this->makePngRow(y, converted.get(), curr)) {
+            return false;
+        }
+        SkPngFilters::Type type = SkPngFilters::FilterAdaptive(
+                params->fFilterFlags, curr, prev, rowSize, params->fBytesPerPixel,
+                filtered.get(), scratch.get());
+        counts[static_cast<int>(type)]++;
     }
 
-    // `png_bytep` is `uint8_t*` rather than `const uint8_t*`.
-    png_bytep rowPtr = const_cast<png_bytep>(row.data());
+    const int* mostCommon = std::max_element(std::begin(counts), std::end(counts));
+    params->fLearnedFilterFlags =
+            SkPngFilters::FlagFor(static_cast<SkPngFilters::Type>(mostCommon - counts));
+    return true;
+}
+
+void SkPngEncoderImpl::packPngRow(const uint8_t* converted, uint8_t* pngRow) const {
+    const TargetInfo& info = this->targetInfo();
+    const int bytesPerComponent = info.fDstInfo.bitsPerComponent() / 8;
+    const bool stripFiller = info.fDstInfo.color() == SkEncodedInfo::kRGBA_Color &&
+                             info.fDstRowInfo->isOpaque();
+    if (!stripFiller && bytesPerComponent == 1) {
+        memcpy(pngRow, converted, info.fDstRowSize);
+        return;
+    }
 
-    // Swap to big endian if we are storing more than a byte per color channel
-    // (SkColorTypes are little endian by default).
-    // By this point our data will either be 8888 or 16161616, so we only check that case.
-    if (png_get_bit_depth(fEncoderMgr->pngPtr(), fEncoderMgr->infoPtr()) == 16) {
-        png_set_swap(fEncoderMgr->pngPtr());
+    const int width = fSrc.width();
+    const size_t srcChannels = info.fDstRowSize / (SkToSizeT(width) * bytesPerComponent);
+    const size_t dstChannels = stripFiller ? 3 : srcChannels;
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* src = converted + x * srcChannels * bytesPerComponent;
+        uint8_t* dst = pngRow + x * dstChannels * bytesPerComponent;
+        for (size_t c = 0; c < dstChannels; ++c) {
+            if (bytesPerComponent == 2) {
+                dst[2*c + 0] = src[2*c + 1];
+                dst[2*c + 1] = src[2*c + 0];
+            } else {
+                dst[c] = src[c];
+            }
+        }
     }
+}
 
-    png_write_rows(fEncoderMgr->pngPtr(), &rowPtr, 1);
+bool SkPngEncoderImpl::makePngRow(int y, uint8_t* converted, uint8_t* pngRow) const {
+    if (!this->convertRow(y, converted)) {
+        return false;
+    }
+    this->packPngRow(converted, pngRow);
     return true;
 }
 
+bool SkPngEncoderImpl::onEncodeRow(SkSpan<const uint8_t> row) {
+    if (!fDeflater) {
+        auto deflater = std::make_unique<RowDeflater>();
+        deflater->fParams = this->filterParams();
+        if (!this->learnFilterFlags(&deflater->fParams)) {
+            return false;
+        }
+        const FilterParams& params = deflater->fParams;
+        if (deflateInit2(&deflater->fZStream, params.fZLibLevel, Z_DEFLATED, MAX_WBITS,
+                         /*memLevel=*/8, params.fZLibStrategy) != Z_OK) {
+            return false;
+        }
+        deflater->fInitialized = true;
+        deflater->fZStream.next_out = deflater->fChunk;
+        deflater->fZStream.avail_out = SkToU32(kIdatChunkBytes);
+        deflater->fRows.resize(2 * params.fPngRowSize, 0);
+        deflater->fFiltered.resize(params.fPngRowSize + 1);
+        deflater->fScratch.resize(params.fPngRowSize + 1);
+        fDeflater = std::move(deflater);
+    }
+
+    // Row y is kept in fRows[y % 2]. The row above the first is all zeros.
+    RowDeflater& deflater = *fDeflater;
+    const FilterParams& params = deflater.fParams;
+    const size_t rowSize = params.fPngRowSize;
+    uint8_t* prev = deflater.fRows.data() + ((fCurrRow + 1) % 2) * rowSize;
+    uint8_t* curr = deflater.fRows.data() + (fCurrRow % 2) * rowSize;
+    this->packPngRow(row.data(), curr);
+    SkPngFilters::FilterAdaptive(params.filterFlagsForRow(fCurrRow), curr, prev, rowSize,
+                                 params.fBytesPerPixel, deflater.fFiltered.data(),
+                                 deflater.fScratch.data());
+
+    deflater.fZStream.next_in = deflater.fFiltered.data();
+    deflater.fZStream.avail_in = SkToU32(deflater.fFiltered.size());
+    return deflater.compress(this->stream(), Z_NO_FLUSH);
+}
+
 bool SkPngEncoderImpl::onFinishEncoding() {
-    if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
+    if (!fDeflater || !fDeflater->compress(this->stream(), Z_FINISH)) {
         return false;
     }
+    fDeflater.reset();
+    return write_png_chunk(this->stream(), "IEND", {}, chunk_crc("IEND", nullptr, 0));
+}
 
-    png_write_end(fEncoderMgr->pngPtr(), fEncoderMgr->infoPtr());
+bool SkPngEncoderImpl::compressStrip(int top, int bottom, const FilterParams& params,
+                                     CompressedStrip* strip) const {
+    const size_t rowSize = params.fPngRowSize;
+    const size_t filteredRowSize = rowSize + 1;
+
+    // Filter enough of the rows above the strip to fill the dictionary, which is cheaper than
+    // waiting for the previous strip to be filtered.
+    const int dictionaryRows = SkToInt((kDeflateWindowBytes + rowSize) / filteredRowSize);
+    const int first = std::max(top - dictionaryRows, 0);
+
+    skia_private::AutoTMalloc<uint8_t> converted(this->targetInfo().fDstRowSize);
+    skia_private::AutoTMalloc<uint8_t> rows(2 * rowSize);
+    skia_private::AutoTMalloc<uint8_t> scratch(filteredRowSize);
+    std::vector<uint8_t> filtered((bottom - first) * filteredRowSize);
+
+    uint8_t* prev = rows.get();
+    uint8_t* curr = rows.get() + rowSize;
+    if (first > 0) {
+        if (!this->makePngRow(first - 1, converted.get(), prev)) {
+            return false;
+        }
+    } else {
+        memset(prev, 0, rowSize);
+    }
+    for (int y = first; y < bottom; ++y) {
+        if (!this->makePngRow(y, converted.get(), curr)) {
+            return false;
+        }
+        SkPngFilters::FilterAdaptive(params.filterFlagsForRow(y), curr, prev, rowSize,
+                                     params.fBytesPerPixel,
+                                     filtered.data() + (y - first) * filteredRowSize,
+                                     scratch.get());
+        std::swap(prev, curr);
+    }
+
+    const uint8_t* stripRows = filtered.data() + (top - first) * filteredRowSize;
+    const size_t stripSize = (bottom - top) * filteredRowSize;
+    const size_t dictionarySize = std::min(kDeflateWindowBytes, (top - first) * filteredRowSize);
+    const bool isFirst = top == 0;
+    const bool isLast = bottom == params.fHeight;
+
+    // Each strip is raw deflate data. The first strip adds the zlib header, and the last strip's
+    // final block ends the stream; the others end with a sync flush so that they end on a byte
+    // boundary and can be concatenated.
+    z_stream zstream = {};
+    if (deflateInit2(&zstream, params.fZLibLevel, Z_DEFLATED, -MAX_WBITS, /*memLevel=*/8,
+                     params.fZLibStrategy) != Z_OK) {
+        return false;
+    }
+    bool succeeded = dictionarySize == 0 ||
+                     deflateSetDictionary(&zstream, stripRows - dictionarySize,
+                                          SkToU32(dictionarySize)) == Z_OK;
+
+    const size_t headerSize = isFirst ? 2 : 0;
+    std::vector<uint8_t>& data = strip->fData;
+    data.resize(headerSize + deflateBound(&zstream, stripSize) + 16);
+    if (isFirst) {
+        // CMF selects deflate with a 32K window. FLG records the compression level like zlib
+        // does, and is chosen so that CMF*256 + FLG is a multiple of 31.
+        const int level = params.fZLibLevel;
+        const int levelFlag = params.fZLibStrategy >= Z_HUFFMAN_ONLY || level < 2 ? 0
+                            : level < 6                                          ? 1
+                            : level == 6                                         ? 2
+                                                                                 : 3;
+        const int header = (0x78 << 8) | (levelFlag << 6);
+        data[0] = 0x78;
+        data[1] = SkToU8((levelFlag << 6) + (31 - header % 31) % 31);
+    }
+
+    zstream.next_in = const_cast<Bytef*>(stripRows);
+    zstream.avail_in = SkToU32(stripSize);
+    zstream.next_out = data.data() + headerSize;
+    zstream.avail_out = SkToU32(data.size() - headerSize);
+    while (succeeded) {
+        int result = deflate(&zstream, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+        if (result == Z_STREAM_END || (result == Z_OK && !isLast && zstream.avail_out > 0)) {
+            break;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) {
+            succeeded = false;
+            break;
+        }
+        // Out of space, which deflateBound() shouldn't allow, but grow and continue anyway.
+        const size_t used = data.size() - zstream.avail_out;
+        data.resize(2 * data.size());
+        zstream.next_out = data.data() + used;
+        zstream.avail_out = SkToU32(data.size() - used);
+    }
+    data.resize(data.size() - zstream.avail_out);
+    deflateEnd(&zstream);
+    if (!succeeded) {
+        return false;
+    }
+
+    strip->fAdler = adler32(adler32(0, nullptr, 0), stripRows, SkToU32(stripSize));
+    strip->fFilteredSize = stripSize;
+    strip->fCrc = chunk_crc("IDAT", data.data(), data.size());
     return true;
 }
 
-namespace SkPngEncoder {
-std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+bool SkPngEncoderImpl::encodeConcurrently(SkExecutor& executor) {
+    const int height = fSrc.height();
+    if (fCurrRow != 0 || fSrc.width() == 0 || height == 0) {
+        return false;
+    }
+
+    FilterParams params = this->filterParams();
+    const int rowsPerStrip =
+            SkToInt(std::max<size_t>(kConcurrentStripBytes / (params.fPngRowSize + 1), 1));
+    const int stripCount = (height - 1) / rowsPerStrip + 1;
+    if (stripCount < 2) {
+        return this->encodeRows(height);
+    }
+    if (!this->learnFilterFlags(&params)) {
+        return false;
+    }
+
+    std::vector<CompressedStrip> strips(stripCount);
+    std::atomic<bool> succeeded{true};
+    SkTaskGroup(executor).batch(stripCount, [&](int i) {
+        const int top = i * rowsPerStrip;
+        if (!this->compressStrip(top, std::min(top + rowsPerStrip, height), params, &strips[i])) {
+            succeeded = false;
+        }
+    });
+    if (!succeeded) {
+        return false;
+    }
+
+    // The stream ends with the Adler-32 of all of the filtered rows, and the last IDAT chunk's
+    // CRC is extended to cover it.
+    uint32_t adler = adler32(0, nullptr, 0);
+    for (const CompressedStrip& strip : strips) {
+        adler = adler32_combine(adler, strip.fAdler, strip.fFilteredSize);
+    }
+    CompressedStrip& last = strips.back();
+    const uint32_t adlerBE = SkEndian_SwapBE32(adler);
+    const uint8_t* adlerBytes = reinterpret_cast<const uint8_t*>(&adlerBE);
+    last.fData.insert(last.fData.end(), adlerBytes, adlerBytes + 4);
+    last.fCrc = crc32(last.fCrc, adlerBytes, 4);
+
+    SkWStream* stream = this->stream();
+    for (const CompressedStrip& strip : strips) {
+        if (strip.fData.size() > PNG_UINT_31_MAX ||
+            !write_png_chunk(stream, "IDAT", strip.fData, strip.fCrc)) {
+            return false;
+        }
+    }
+    fCurrRow = height;
+    return write_png_chunk(stream, "IEND", {}, chunk_crc("IEND", nullptr, 0));
+}
+
+static std::unique_ptr<SkPngEncoderImpl> make_encoder(SkWStream* dst,
+                                                      const SkPixmap& src,
+                                                      const SkPngEncoder::Options& options) {
     if (!SkPixmapIsValid(src)) {
         return nullptr;
     }
@@ -504,9 +857,20 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
     return std::make_unique<SkPngEncoderImpl>(std::move(*targetInfo), std::move(encoderMgr), src);
 }
 
+namespace SkPngEncoder {
+std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    return make_encoder(dst, src, options);
+}
+
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    auto encoder = Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    auto encoder = make_encoder(dst, src, options);
+    if (!encoder) {
+        return false;
+    }
+    if (options.fExecutor) {
+        return encoder->encodeConcurrently(*options.fExecutor);
+    }
+    return encoder->encodeRows(src.height());
 }
 
 sk_sp<SkData> Encode(const SkPixmap& src, const Options& options) {
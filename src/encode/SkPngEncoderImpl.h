@@ -15,8 +15,10 @@
 
 #include <memory>
 
+class SkExecutor;
 class SkPixmap;
 class SkPngEncoderMgr;
+class SkWStream;
 
 class SkPngEncoderImpl final : public SkPngEncoderBase {
 public:
@@ -25,10 +27,40 @@ public:
     SkPngEncoderImpl(TargetInfo targetInfo, std::unique_ptr<SkPngEncoderMgr>, const SkPixmap& src);
     ~SkPngEncoderImpl() override;
 
+    // Encodes every row of the source, filtering and compressing strips of rows concurrently on
+    // `executor`. This must be called before any rows have been encoded.
+    bool encodeConcurrently(SkExecutor& executor);
+
 protected:
     bool onEncodeRow(SkSpan<const uint8_t> row) override;
     bool onFinishEncoding() override;
 
     std::unique_ptr<SkPngEncoderMgr> fEncoderMgr;
+
+private:
+    struct CompressedStrip;
+    struct FilterParams;
+    struct RowDeflater;
+
+    FilterParams filterParams() const;
+
+    // Picks the filter for the rows after the first few, if `params` calls for one to be
+    // learned from them.
+    bool learnFilterFlags(FilterParams* params) const;
+
+    // Rewrites a row produced by convertRow() into the bytes that are filtered: opaque RGBA
+    // rows lose their unused fourth channel, and 16-bit components become big endian.
+    void packPngRow(const uint8_t* converted, uint8_t* pngRow) const;
+
+    // Converts and packs row `y`.
+    bool makePngRow(int y, uint8_t* converted, uint8_t* pngRow) const;
+
+    // Filters and deflates the rows [top, bottom) into a piece of the image's zlib stream.
+    bool compressStrip(int top, int bottom, const FilterParams&, CompressedStrip*) const;
+
+    SkWStream* stream() const;
+
+    // Filters and compresses rows as they are encoded one at a time.
+    std::unique_ptr<RowDeflater> fDeflater;
 };
 #endif
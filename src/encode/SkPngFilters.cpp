@@ -0,0 +1,174 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/encode/SkPngFilters.h"
+
+#include "include/encode/SkPngEncoder.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkMath.h"
+#include "src/base/SkVx.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace SkPngFilters {
+namespace {
+
+using U8x16 = skvx::Vec<16, uint8_t>;
+using I16x16 = skvx::Vec<16, int16_t>;
+using U16x16 = skvx::Vec<16, uint16_t>;
+
+constexpr size_t kLanes = 16;
+
+// Each filter predicts x from its neighbours a (left), b (above) and c (above left), using the
+// names from the PNG specification, and stores x minus the prediction. a and c are zero for the
+// first pixel of a row.
+template <typename ScalarFn, typename VectorFn>
+void filter_row(const uint8_t* row, const uint8_t* prev, size_t size, size_t bpp, uint8_t* dst,
+                ScalarFn&& scalar, VectorFn&& vector) {
+    size_t i = 0;
+    for (; i < std::min(bpp, size); ++i) {
+        dst[i] = scalar(row[i], 0, prev[i], 0);
+    }
+    for (; i + kLanes <= size; i += kLanes) {
+        U8x16 filtered = vector(U8x16::Load(row + i), U8x16::Load(row + i - bpp),
+                                U8x16::Load(prev + i), U8x16::Load(prev + i - bpp));
+        filtered.store(dst + i);
+    }
+    for (; i < size; ++i) {
+        dst[i] = scalar(row[i], row[i - bpp], prev[i], prev[i - bpp]);
+    }
+}
+
+uint8_t paeth_predictor(int a, int b, int c) {
+    // |p - a|, |p - b| and |p - c| for p = a + b - c
+    int pa = std::abs(b - c);
+    int pb = std::abs(a - c);
+    int pc = std::abs(a + b - 2 * c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+U8x16 paeth_predictor(const U8x16& a8, const U8x16& b8, const U8x16& c8) {
+    I16x16 a = skvx::cast<int16_t>(a8),
+           b = skvx::cast<int16_t>(b8),
+           c = skvx::cast<int16_t>(c8);
+    I16x16 pa = skvx::max(b - c, c - b),
+           pb = skvx::max(a - c, c - a),
+           pc = skvx::max(a + b - 2 * c, 2 * c - a - b);
+    I16x16 p = skvx::if_then_else((pa <= pb) & (pa <= pc), a,
+                                  skvx::if_then_else(pb <= pc, b, c));
+    return skvx::cast<uint8_t>(p);
+}
+
+}  // namespace
+
+void Filter(Type type, const uint8_t* row, const uint8_t* prev, size_t size, size_t bpp,
+            uint8_t* dst) {
+    SkASSERT(bpp >= 1);
+    switch (type) {
+        case Type::kNone:
+            memcpy(dst, row, size);
+            return;
+        case Type::kSub:
+            filter_row(row, prev, size, bpp, dst,
+                       [](uint8_t x, uint8_t a, uint8_t, uint8_t) -> uint8_t { return x - a; },
+                       [](const U8x16& x, const U8x16& a, const U8x16&, const U8x16&) {
+                           return x - a;
+                       });
+            return;
+        case Type::kUp:
+            filter_row(row, prev, size, bpp, dst,
+                       [](uint8_t x, uint8_t, uint8_t b, uint8_t) -> uint8_t { return x - b; },
+                       [](const U8x16& x, const U8x16&, const U8x16& b, const U8x16&) {
+                           return x - b;
+                       });
+            return;
+        case Type::kAvg:
+            filter_row(row, prev, size, bpp, dst,
+                       [](uint8_t x, uint8_t a, uint8_t b, uint8_t) -> uint8_t {
+                           return x - ((a + b) >> 1);
+                       },
+                       [](const U8x16& x, const U8x16& a, const U8x16& b, const U8x16&) {
+                           // floor((a + b) / 2) without overflowing 8 bits
+                           return x - ((a & b) + ((a ^ b) >> 1));
+                       });
+            return;
+        case Type::kPaeth:
+            filter_row(row, prev, size, bpp, dst,
+                       [](uint8_t x, uint8_t a, uint8_t b, uint8_t c) -> uint8_t {
+                           return x - paeth_predictor(a, b, c);
+                       },
+                       [](const U8x16& x, const U8x16& a, const U8x16& b, const U8x16& c) {
+                           return x - paeth_predictor(a, b, c);
+                       });
+            return;
+    }
+    SkUNREACHABLE;
+}
+
+uint64_t SumOfMagnitudes(const uint8_t* data, size_t size) {
+    uint64_t sum = 0;
+    size_t i = 0;
+    while (i + kLanes <= size) {
+        // Each step adds at most 128 to a lane, so 16-bit lanes can't overflow in 511 steps.
+        U16x16 lanes = 0;
+        for (int step = 0; step < 511 && i + kLanes <= size; ++step, i += kLanes) {
+            U8x16 v = U8x16::Load(data + i);
+            // For a signed byte v stored as u, |v| is the smaller of u and 256 - u.
+            lanes += skvx::cast<uint16_t>(skvx::min(v, U8x16(0) - v));
+        }
+        for (int lane = 0; lane < 16; ++lane) {
+            sum += lanes[lane];
+        }
+    }
+    for (; i < size; ++i) {
+        sum += std::abs(static_cast<int>(static_cast<int8_t>(data[i])));
+    }
+    return sum;
+}
+
+Type FilterAdaptive(int filterFlags, const uint8_t* row, const uint8_t* prev, size_t size,
+                    size_t bpp, uint8_t* dst, uint8_t* scratch) {
+    filterFlags &= static_cast<int>(SkPngEncoder::FilterFlag::kAll);
+    if (!filterFlags) {
+        filterFlags = FlagFor(Type::kNone);
+    }
+    const bool singleFilter = SkIsPow2(filterFlags);
+
+    // Candidates are filtered into whichever buffer isn't holding the best row so far.
+    uint8_t* best = nullptr;
+    Type bestType = Type::kNone;
+    uint64_t bestSum = UINT64_MAX;
+    for (int t = 0; t < kTypeCount; ++t) {
+        const Type type = static_cast<Type>(t);
+        if (!(filterFlags & FlagFor(type))) {
+            continue;
+        }
+        uint8_t* candidate = best == dst ? scratch : dst;
+        candidate[0] = static_cast<uint8_t>(type);
+        Filter(type, row, prev, size, bpp, candidate + 1);
+        if (singleFilter) {
+            return type;
+        }
+        const uint64_t sum = SumOfMagnitudes(candidate + 1, size);
+        if (sum < bestSum) {
+            best = candidate;
+            bestType = type;
+            bestSum = sum;
+        }
+    }
+    if (best != dst) {
+        memcpy(dst, best, size + 1);
+    }
+    return bestType;
+}
+
+}  // namespace SkPngFilters
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilters_DEFINED
+#define SkPngFilters_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ *  Vectorized implementations of the PNG row filters, for encoders that filter rows themselves
+ *  and feed them straight to zlib.
+ *
+ *  All of the filters' inputs are unfiltered bytes, so every byte of a row can be filtered
+ *  independently of the others; the loops below process 16 bytes at a time.
+ */
+namespace SkPngFilters {
+
+// The filter types, as written in the byte that begins each filtered row.
+enum class Type : uint8_t {
+    kNone  = 0,
+    kSub   = 1,
+    kUp    = 2,
+    kAvg   = 3,
+    kPaeth = 4,
+};
+inline constexpr int kTypeCount = 5;
+
+// Returns the SkPngEncoder::FilterFlag bit that allows `type`.
+constexpr int FlagFor(Type type) { return 0x08 << static_cast<int>(type); }
+
+/**
+ *  Writes `row` filtered with `type` to `dst`, which has room for `size` bytes and does not
+ *  include the type byte. `prev` is the unfiltered row above, all zeros for the first row, and
+ *  `bpp` is the number of bytes per complete pixel (at least 1).
+ */
+void Filter(Type type, const uint8_t* row, const uint8_t* prev, size_t size, size_t bpp,
+            uint8_t* dst);
+
+/**
+ *  Returns the sum of the magnitudes of `data` as signed bytes, which is the usual estimate of
+ *  how well a filtered row will compress: smaller is better.
+ */
+uint64_t SumOfMagnitudes(const uint8_t* data, size_t size);
+
+/**
+ *  Writes the type byte followed by `row` filtered with the filter allowed by `filterFlags`
+ *  (SkPngEncoder::FilterFlag bits) that minimizes SumOfMagnitudes(), and returns that type.
+ *  `dst` and `scratch` must each have room for size + 1 bytes. No flags means kNone.
+ */
+Type FilterAdaptive(int filterFlags, const uint8_t* row, const uint8_t* prev, size_t size,
+                    size_t bpp, uint8_t* dst, uint8_t* scratch);
+
+}  // namespace SkPngFilters
+
+#endif  // SkPngFilters_DEFINED
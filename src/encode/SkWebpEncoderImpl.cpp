@@ -11,18 +11,24 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkEncoder.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -51,6 +57,30 @@ static int stream_writer(const uint8_t* data, size_t data_size, const WebPPictur
 
 using WebPPictureImportProc = int (*)(WebPPicture* picture, const uint8_t* pixels, int stride);
 
+// Concurrent conversions split the image into strips of about this many bytes of pixels.
+static constexpr size_t kConcurrentStripBytes = 256 * 1024;
+
+static bool convert_pixels(const SkPixmap& dst, const SkPixmap& src, SkExecutor* executor) {
+    const int rowsPerStrip =
+            SkToInt(std::max<size_t>(kConcurrentStripBytes / dst.info().minRowBytes(), 1));
+    const int stripCount = (src.height() - 1) / rowsPerStrip + 1;
+    if (!executor || stripCount < 2) {
+        return src.readPixels(dst);
+    }
+
+    std::atomic<bool> succeeded{true};
+    SkTaskGroup(*executor).batch(stripCount, [&](int i) {
+        const SkIRect rows = SkIRect::MakeLTRB(
+                0, i * rowsPerStrip, src.width(), std::min((i + 1) * rowsPerStrip, src.height()));
+        SkPixmap srcStrip, dstStrip;
+        if (!src.extractSubset(&srcStrip, rows) || !dst.extractSubset(&dstStrip, rows) ||
+            !srcStrip.readPixels(dstStrip)) {
+            succeeded = false;
+        }
+    });
+    return succeeded;
+}
+
 static bool preprocess_webp_picture(WebPPicture* pic,
                                     WebPConfig* webp_config,
                                     const SkPixmap& pixmap,
@@ -87,6 +117,9 @@ static bool preprocess_webp_picture(WebPPicture* pic,
         webp_config->method = 0;
         pic->use_argb = 1;
     }
+    if (opts.fExecutor) {
+        webp_config->thread_level = 1;
+    }
 
     {
         const SkColorType ct = pixmap.colorType();
@@ -111,7 +144,7 @@ static bool preprocess_webp_picture(WebPPicture* pic,
                                 .makeColorType(kRGBA_8888_SkColorType)
                                 .makeAlphaType(kUnpremul_SkAlphaType);
             if (!tmpBm.tryAllocPixels(info) ||
-                !pixmap.readPixels(tmpBm.info(), tmpBm.getPixels(), tmpBm.rowBytes())) {
+                !convert_pixels(tmpBm.pixmap(), pixmap, opts.fExecutor)) {
                 return false;
             }
             src = &tmpBm.pixmap();
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/image/SkImageDecodeAhead.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImageInfo.h"
+#include "src/base/SkTime.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/image/SkImage_Base.h"
+
+#include <algorithm>
+#include <utility>
+
+// Decodes the image into SkBitmapCache, where SkImage_Lazy::getROPixels() will find it.
+static bool decode_into_cache(const SkImage* image) {
+    SkBitmap bitmap;
+    return as_IB(image)->getROPixels(nullptr, &bitmap, SkImage::kAllow_CachingHint);
+}
+
+SkImageDecodeAhead::SkImageDecodeAhead(SkExecutor& executor, size_t byteBudget)
+        : fByteBudget(byteBudget), fTasks(executor) {}
+
+SkImageDecodeAhead::~SkImageDecodeAhead() {
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        fCancelled = true;
+    }
+    fTasks.wait();
+}
+
+bool SkImageDecodeAhead::DecodesLater(const Entry* a, const Entry* b) {
+    // The heap functions keep the greatest entry at the front.
+    if (a->fPriority != b->fPriority) {
+        return a->fPriority < b->fPriority;
+    }
+    return a->fOrder > b->fOrder;
+}
+
+void SkImageDecodeAhead::add(SkSpan<const Request> requests) {
+    int added = 0;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        for (const Request& request : requests) {
+            const SkImage* image = request.fImage.get();
+            if (!image || as_IB(image)->type() != SkImage_Base::Type::kLazy ||
+                fEntriesByID.find(image->uniqueID())) {
+                continue;
+            }
+            auto entry = std::make_unique<Entry>();
+            entry->fImage = request.fImage;
+            entry->fPriority = request.fPriority;
+            entry->fOrder = fNextOrder++;
+            entry->fBytes = image->imageInfo().computeMinByteSize();
+
+            fEntriesByID.set(image->uniqueID(), entry.get());
+            fQueue.push_back(entry.get());
+            std::push_heap(fQueue.begin(), fQueue.end(), DecodesLater);
+            fEntries.push_back(std::move(entry));
+            fStats.fQueueDepth++;
+            added++;
+        }
+    }
+
+    // Each task decodes whichever entry is at the front of the queue when it runs, so entries
+    // are decoded in priority order even though the executor runs tasks in the order added.
+    for (int i = 0; i < added; ++i) {
+        fTasks.add([this] { this->decodeNext(); });
+    }
+}
+
+SkImageDecodeAhead::Entry* SkImageDecodeAhead::popNext() {
+    while (!fQueue.empty()) {
+        std::pop_heap(fQueue.begin(), fQueue.end(), DecodesLater);
+        Entry* entry = fQueue.back();
+        fQueue.pop_back();
+        if (entry->fState != State::kQueued) {
+            // prepare() has already decoded it.
+            continue;
+        }
+        fStats.fQueueDepth--;
+        if (fStats.fBytesDecoded + entry->fBytes > fByteBudget) {
+            fStats.fSkipped++;
+            this->finish(entry, false);
+            continue;
+        }
+        // Reserve the entry's bytes now, so that concurrent decodes stay within the budget.
+        fStats.fBytesDecoded += entry->fBytes;
+        entry->fState = State::kDecoding;
+        return entry;
+    }
+    return nullptr;
+}
+
+void SkImageDecodeAhead::decodeNext() {
+    Entry* entry;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        entry = fCancelled ? nullptr : this->popNext();
+    }
+    if (!entry) {
+        return;
+    }
+
+    const bool decoded = decode_into_cache(entry->fImage.get());
+
+    SkAutoMutexExclusive lock(fMutex);
+    if (decoded) {
+        fStats.fDecoded++;
+    } else {
+        fStats.fSkipped++;
+        fStats.fBytesDecoded -= entry->fBytes;
+    }
+    this->finish(entry, decoded);
+}
+
+void SkImageDecodeAhead::finish(Entry* entry, bool decoded) {
+    entry->fState = decoded ? State::kDecoded : State::kSkipped;
+    entry->fFinished.signal();
+}
+
+bool SkImageDecodeAhead::prepare(const SkImage* image) {
+    if (!image) {
+        return false;
+    }
+    const double start = SkTime::GetNSecs();
+
+    Entry* entry;
+    State state;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        Entry** found = fEntriesByID.find(image->uniqueID());
+        if (!found) {
+            return false;
+        }
+        entry = *found;
+        state = entry->fState;
+        if (state == State::kQueued) {
+            // Take it from the queue. It stays in fQueue, where popNext() will skip it.
+            entry->fState = State::kDecoding;
+            fStats.fQueueDepth--;
+        }
+    }
+
+    switch (state) {
+        case State::kQueued: {
+            const bool decoded = decode_into_cache(image);
+            SkAutoMutexExclusive lock(fMutex);
+            this->finish(entry, decoded);
+            break;
+        }
+        case State::kDecoding:
+            // Pass the signal on to any other thread waiting for the entry.
+            entry->fFinished.wait();
+            entry->fFinished.signal();
+            break;
+        case State::kDecoded:
+        case State::kSkipped:
+            break;
+    }
+
+    // The pixels may have been purged from the cache since they were decoded ahead.
+    SkBitmap bitmap;
+    const bool cached = SkBitmapCache::Find(SkBitmapCacheDesc::Make(image), &bitmap);
+
+    SkAutoMutexExclusive lock(fMutex);
+    if (state == State::kDecoded && cached) {
+        fStats.fHits++;
+    } else {
+        fStats.fMisses++;
+        fStats.fStallMs += (SkTime::GetNSecs() - start) * 1e-6;
+    }
+    return cached;
+}
+
+void SkImageDecodeAhead::wait() { fTasks.wait(); }
+
+SkImageDecodeAhead::Stats SkImageDecodeAhead::stats() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fStats;
+}
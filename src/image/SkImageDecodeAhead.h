@@ -0,0 +1,121 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageDecodeAhead_DEFINED
+#define SkImageDecodeAhead_DEFINED
+
+#include "include/core/SkImage.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkNoncopyable.h"
+#include "include/private/base/SkSemaphore.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/core/SkTHash.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkExecutor;
+
+/**
+ *  Decodes lazily generated images (e.g. from SkImages::DeferredFromEncodedData) ahead of their
+ *  use, on an executor, so that playback finds their pixels already in SkBitmapCache instead of
+ *  decoding them synchronously on first draw.
+ *
+ *  Requests are decoded in priority order: highest priority first, and in the order they were
+ *  added for equal priorities. The decoded pixels live in SkResourceCache, under its byte limit;
+ *  in addition, images are only decoded ahead while the total size of the images decoded so far
+ *  fits in the byte budget given here, so that decoding ahead doesn't purge what playback needs.
+ *
+ *  Images that are not lazily generated, or that have already been added, are ignored.
+ */
+class SkImageDecodeAhead : SkNoncopyable {
+public:
+    struct Request {
+        sk_sp<SkImage> fImage;
+        int            fPriority = 0;
+    };
+
+    struct Stats {
+        int    fQueueDepth = 0;    // Requests that have not started decoding.
+        int    fDecoded = 0;       // Requests decoded ahead of prepare().
+        int    fSkipped = 0;       // Requests that were over budget or failed to decode.
+        int    fHits = 0;          // Calls to prepare() that found the pixels in the cache.
+        int    fMisses = 0;        // Calls to prepare() that had to wait, or will decode on draw.
+        double fStallMs = 0;       // Time spent in prepare() waiting for pixels.
+        size_t fBytesDecoded = 0;  // The size of the pixels decoded ahead.
+
+        float hitRate() const {
+            const int lookups = fHits + fMisses;
+            return lookups ? (float)fHits / lookups : 0.f;
+        }
+    };
+
+    SkImageDecodeAhead(SkExecutor& executor, size_t byteBudget);
+
+    // Drops the requests that have not started, and waits for those that have.
+    ~SkImageDecodeAhead();
+
+    void add(SkSpan<const Request> requests);
+
+    /**
+     *  Called by playback before drawing the image. If its request is still queued it is decoded
+     *  now, on the calling thread, and if it is being decoded this waits for it. Returns true if
+     *  the image's pixels are in the cache.
+     */
+    bool prepare(const SkImage* image);
+
+    // Blocks until every request added so far has been decoded or skipped.
+    void wait();
+
+    Stats stats() const;
+
+private:
+    enum class State {
+        kQueued,
+        kDecoding,
+        kDecoded,
+        kSkipped,
+    };
+
+    struct Entry {
+        sk_sp<SkImage> fImage;
+        int            fPriority;
+        uint64_t       fOrder;
+        size_t         fBytes;
+        State          fState = State::kQueued;
+        // Signaled once the entry is kDecoded or kSkipped.
+        SkSemaphore    fFinished;
+    };
+
+    // Orders the queue so that the entry to decode next is at the front of the heap.
+    static bool DecodesLater(const Entry* a, const Entry* b);
+
+    // Pops the next entry that should be decoded ahead and marks it kDecoding, or returns null
+    // if there are none left. Entries that don't fit in the budget are skipped.
+    Entry* popNext() SK_REQUIRES(fMutex);
+    void decodeNext();
+    void finish(Entry*, bool decoded) SK_REQUIRES(fMutex);
+
+    const size_t fByteBudget;
+
+    mutable SkMutex fMutex;
+    std::vector<std::unique_ptr<Entry>>         fEntries SK_GUARDED_BY(fMutex);
+    std::vector<Entry*>                         fQueue SK_GUARDED_BY(fMutex);
+    skia_private::THashMap<uint32_t, Entry*>    fEntriesByID SK_GUARDED_BY(fMutex);
+    uint64_t                                    fNextOrder SK_GUARDED_BY(fMutex) = 0;
+    bool                                        fCancelled SK_GUARDED_BY(fMutex) = false;
+    Stats                                       fStats SK_GUARDED_BY(fMutex);
+
+    SkTaskGroup fTasks;
+};
+
+#endif
@@ -353,6 +353,85 @@ namespace SK_OPTS_NS {
         } while (--height != 0);
     }
 
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    #include <immintrin.h>
+
+    // Matches Sk4px::approxMulDiv255(), (x*y+x)/256 in 16-bit lanes, for 64 bytes at a time.
+    static inline __m512i approx_mul_div255_skx(__m512i x, __m512i y) {
+        const __m512i zeros = _mm512_setzero_si512();
+        __m512i xlo = _mm512_unpacklo_epi8(x, zeros), ylo = _mm512_unpacklo_epi8(y, zeros),
+                xhi = _mm512_unpackhi_epi8(x, zeros), yhi = _mm512_unpackhi_epi8(y, zeros);
+        __m512i lo = _mm512_srli_epi16(_mm512_add_epi16(_mm512_mullo_epi16(xlo, ylo), xlo), 8),
+                hi = _mm512_srli_epi16(_mm512_add_epi16(_mm512_mullo_epi16(xhi, yhi), xhi), 8);
+        // unpack and pack both work within 128-bit lanes, so this restores the original order.
+        return _mm512_packus_epi16(lo, hi);
+    }
+
+    // Like Sk4px::MapDstAlpha(), but 16 pixels at a time, with masked loads and stores for the
+    // tail of each row. fn is passed dst pixels and their mask alphas splatted to all 4 bytes.
+    template <typename Fn>
+    static void map_dst_alpha_skx(SkPMColor* dst, size_t dstRB,
+                                  const SkAlpha* mask, size_t maskRB,
+                                  int w, int h, const Fn& fn) {
+        const __m512i splat = _mm512_broadcast_i32x4(
+                _mm_setr_epi8(0,0,0,0, 4,4,4,4, 8,8,8,8, 12,12,12,12));
+        while (h --> 0) {
+            for (int x = 0; x < w; x += 16) {
+                const __mmask16 m = w - x >= 16 ? (__mmask16)0xffff
+                                                : (__mmask16)((1u << (w - x)) - 1);
+                // Widen each alpha to the low byte of its pixel, then splat it to all 4 bytes.
+                __m128i aa = _mm_maskz_loadu_epi8(m, mask + x);
+                __m512i a = _mm512_shuffle_epi8(_mm512_cvtepu8_epi32(aa), splat);
+                __m512i d = _mm512_maskz_loadu_epi32(m, dst + x);
+                _mm512_mask_storeu_epi32(dst + x, m, fn(d, a));
+            }
+            dst  +=  dstRB / sizeof(*dst);
+            mask += maskRB / sizeof(*mask);
+        }
+    }
+
+    static void blit_mask_d32_a8_general(SkPMColor* dst, size_t dstRB,
+                                         const SkAlpha* mask, size_t maskRB,
+                                         SkColor color, int w, int h) {
+        const __m512i s = _mm512_set1_epi32((int)SkPreMultiplyColor(color));
+        const __m512i ones = _mm512_set1_epi8((char)0xff);
+        const __m512i alphas = _mm512_broadcast_i32x4(
+                _mm_setr_epi8(3,3,3,3, 7,7,7,7, 11,11,11,11, 15,15,15,15));
+        map_dst_alpha_skx(dst, dstRB, mask, maskRB, w, h, [&](__m512i d, __m512i aa) {
+            //  = (s + d(1-sa))aa + d(1-aa)
+            //  = s*aa + d(1-sa*aa)
+            __m512i left  = approx_mul_div255_skx(s, aa),
+                    right = approx_mul_div255_skx(
+                            d, _mm512_sub_epi8(ones, _mm512_shuffle_epi8(left, alphas)));
+            return _mm512_add_epi8(left, right);
+        });
+    }
+
+    // As above, but made slightly simpler by requiring that color is opaque.
+    static void blit_mask_d32_a8_opaque(SkPMColor* dst, size_t dstRB,
+                                        const SkAlpha* mask, size_t maskRB,
+                                        SkColor color, int w, int h) {
+        SkASSERT(SkColorGetA(color) == 0xFF);
+        const __m512i s = _mm512_set1_epi32((int)SkPreMultiplyColor(color));
+        const __m512i ones = _mm512_set1_epi8((char)0xff);
+        map_dst_alpha_skx(dst, dstRB, mask, maskRB, w, h, [&](__m512i d, __m512i aa) {
+            return _mm512_add_epi8(approx_mul_div255_skx(s, aa),
+                                   approx_mul_div255_skx(d, _mm512_sub_epi8(ones, aa)));
+        });
+    }
+
+    // Same as _opaque, but assumes color == SK_ColorBLACK, a very common and even simpler case.
+    static void blit_mask_d32_a8_black(SkPMColor* dst, size_t dstRB,
+                                       const SkAlpha* mask, size_t maskRB,
+                                       int w, int h) {
+        const __m512i ones = _mm512_set1_epi8((char)0xff);
+        const __m512i alphaBytes = _mm512_set1_epi32((int)0xff000000);
+        map_dst_alpha_skx(dst, dstRB, mask, maskRB, w, h, [&](__m512i d, __m512i aa) {
+            return _mm512_add_epi8(_mm512_and_si512(aa, alphaBytes),
+                                   approx_mul_div255_skx(d, _mm512_sub_epi8(ones, aa)));
+        });
+    }
+
 #else
     static void blit_mask_d32_a8_general(SkPMColor* dst, size_t dstRB,
                                          const SkAlpha* mask, size_t maskRB,
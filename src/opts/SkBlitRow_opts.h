@@ -19,6 +19,29 @@
 // To keep Skia resistant to timing attacks, it's important not to branch on pixel data.
 // In particular, don't be tempted to [v]ptest, pmovmskb, etc. to branch on the source alpha.
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    #include <immintrin.h>
+
+    // The same math as SkPMSrcOver_AVX2() below, 16 pixels at a time.
+    static inline __m512i SkPMSrcOver_SKX(const __m512i& src, const __m512i& dst) {
+        const int _ = -1;   // fills a literal 0 byte.
+        __m512i srcA_x2 = _mm512_shuffle_epi8(src,
+                _mm512_broadcast_i32x4(_mm_setr_epi8(3,_,3,_, 7,_,7,_, 11,_,11,_, 15,_,15,_)));
+        __m512i scale_x2 = _mm512_sub_epi16(_mm512_set1_epi16(256),
+                                            srcA_x2);
+
+        __m512i rb = _mm512_and_si512(_mm512_set1_epi32(0x00ff00ff), dst);
+        rb = _mm512_mullo_epi16(rb, scale_x2);
+        rb = _mm512_srli_epi16 (rb, 8);
+
+        __m512i ga = _mm512_srli_epi16(dst, 8);
+        ga = _mm512_mullo_epi16(ga, scale_x2);
+        ga = _mm512_andnot_si512(_mm512_set1_epi32(0x00ff00ff), ga);
+
+        return _mm512_adds_epu8(src, _mm512_or_si512(rb, ga));
+    }
+#endif
+
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     #include <immintrin.h>
 
@@ -165,6 +188,25 @@ inline void blit_row_s32a_opaque(SkPMColor* dst, const SkPMColor* src, int len,
     SkASSERT(alpha == 0xFF);
     sk_msan_assert_initialized(src, src+len);
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    while (len >= 16) {
+        _mm512_storeu_si512((__m512i*)dst,
+                            SkPMSrcOver_SKX(_mm512_loadu_si512((const __m512i*)src),
+                                            _mm512_loadu_si512((const __m512i*)dst)));
+        src += 16;
+        dst += 16;
+        len -= 16;
+    }
+    // Masked loads and stores finish off the tail without touching pixels past len.
+    if (len > 0) {
+        const __mmask16 tail = (__mmask16)((1u << len) - 1);
+        _mm512_mask_storeu_epi32(dst, tail,
+                                 SkPMSrcOver_SKX(_mm512_maskz_loadu_epi32(tail, src),
+                                                 _mm512_maskz_loadu_epi32(tail, dst)));
+    }
+    return;
+#endif
+
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     while (len >= 8) {
         _mm256_storeu_si256((__m256i*)dst,
@@ -241,7 +283,11 @@ inline void blit_row_s32a_opaque(SkPMColor* dst, const SkPMColor* src, int len,
 // Blend constant color over count dst pixels
 /*not static*/
 inline void blit_row_color32(SkPMColor* dst, int count, SkPMColor color) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    constexpr int N = 16;  // Fills a 512-bit register.
+#else
     constexpr int N = 4;  // 8, 16 also reasonable choices
+#endif
     using U32 = skvx::Vec<  N, uint32_t>;
     using U16 = skvx::Vec<4*N, uint16_t>;
     using U8  = skvx::Vec<4*N, uint8_t>;
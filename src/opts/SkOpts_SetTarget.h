@@ -130,6 +130,35 @@
             #include <fmaintrin.h>
         #endif
 
+    #elif SK_OPTS_TARGET == SK_OPTS_TARGET_SKX
+
+        #define SK_CPU_SSE_LEVEL SK_CPU_SSE_LEVEL_SKX
+        #define SK_OPTS_NS skx
+
+        #if defined(__clang__)
+            #pragma clang attribute push(__attribute__((target("sse2,ssse3,sse4.1,sse4.2,avx,avx2,bmi,bmi2,f16c,fma,avx512f,avx512dq,avx512cd,avx512bw,avx512vl"))), apply_to=function)
+        #elif defined(__GNUC__)
+            #pragma GCC push_options
+            #pragma GCC target("sse2,ssse3,sse4.1,sse4.2,avx,avx2,bmi,bmi2,f16c,fma,avx512f,avx512dq,avx512cd,avx512bw,avx512vl")
+        #endif
+
+        #if defined(__clang__) && defined(_MSC_VER)
+            #include <pmmintrin.h>
+            #include <tmmintrin.h>
+            #include <smmintrin.h>
+            #include <avxintrin.h>
+            #include <avx2intrin.h>
+            #include <f16cintrin.h>
+            #include <bmi2intrin.h>
+            #include <fmaintrin.h>
+            #include <avx512fintrin.h>
+            #include <avx512dqintrin.h>
+            #include <avx512cdintrin.h>
+            #include <avx512bwintrin.h>
+            #include <avx512vlintrin.h>
+            #include <avx512vlbwintrin.h>
+        #endif
+
     #elif SK_OPTS_TARGET == SK_OPTS_TARGET_LASX
 
         #define SK_CPU_LSX_LEVEL SK_CPU_LSX_LEVEL_LASX
@@ -21,16 +21,20 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkMath.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkAAClip.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkRasterClip.h"
+#include "src/core/SkResourceCache.h"
 #include "tests/Test.h"
 
 #include <cstdint>
 #include <cstring>
 #include <initializer_list>
+#include <iterator>
 #include <limits>
 #include <string>
 
@@ -457,3 +461,94 @@ DEF_TEST(AAClip_setPath_LargePathSmallClip_StillBlits, reporter) {
     REPORTER_ASSERT(reporter, clip.setPath(largePath, smallClip, true));
     REPORTER_ASSERT(reporter, clip.setPath(largePath, smallClip, false));
 }
+
+static uint8_t mask_alpha(const SkMask& mask, int x, int y) {
+    return mask.fBounds.contains(x, y) ? *mask.getAddr8(x, y) : 0;
+}
+
+// Many thin, fractionally-positioned stripes give every row lots of short runs, so op() combines
+// them a scanline at a time.
+static SkPath make_stripes(float dx, float dy, float angle) {
+    SkPathBuilder builder;
+    for (int i = 0; i < 40; ++i) {
+        float x = dx + i * 2.7f;
+        builder.addRect(SkRect::MakeXYWH(x, dy, 1.3f, 100));
+    }
+    return builder.detach().makeTransform(SkMatrix::RotateDeg(angle, {60, 60}));
+}
+
+DEF_TEST(AAClip_op_ManyRuns_MatchesMaskMath, reporter) {
+    const SkIRect bounds = SkIRect::MakeWH(120, 120);
+    for (SkClipOp op : {SkClipOp::kIntersect, SkClipOp::kDifference}) {
+        SkAAClip a, b;
+        a.setPath(make_stripes(0.3f, 5, 10), bounds);
+        b.setPath(make_stripes(1.1f, 15, -25), bounds);
+
+        SkMaskBuilder maskA, maskB;
+        a.copyToMask(&maskA);
+        b.copyToMask(&maskB);
+        SkAutoMaskFreeImage freeA(maskA.image());
+        SkAutoMaskFreeImage freeB(maskB.image());
+
+        SkAAClip result = a;
+        result.op(b, op);
+        SkMaskBuilder maskR;
+        result.copyToMask(&maskR);
+        SkAutoMaskFreeImage freeR(maskR.image());
+
+        bool matches = true;
+        for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+            for (int x = bounds.fLeft; x < bounds.fRight; ++x) {
+                U8CPU alphaB = mask_alpha(maskB, x, y);
+                U8CPU expected = SkMulDiv255Round(mask_alpha(maskA, x, y),
+                                                  op == SkClipOp::kIntersect ? alphaB
+                                                                             : 0xFF - alphaB);
+                matches &= mask_alpha(maskR, x, y) == expected;
+            }
+        }
+        REPORTER_ASSERT(reporter, matches, "op %d", (int)op);
+    }
+}
+
+DEF_TEST(AAClip_RasterClip_RepeatedPathClip_MatchesUncached, reporter) {
+    SkPath path = SkPath::RRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(3.5f, 4.25f, 90, 70), 12, 9));
+
+    struct Data {
+        uint64_t sharedID;
+        int counter;
+    } data = {
+        SkMakeResourceCacheSharedIDForAAClipPath(path.getGenerationID()),
+        0,
+    };
+    auto counter = [](const SkResourceCache::Rec& rec, void* dataPtr) {
+        if (rec.getKey().getSharedID() == ((Data*)dataPtr)->sharedID) {
+            ((Data*)dataPtr)->counter += 1;
+        }
+    };
+
+    const SkMatrix matrices[] = {SkMatrix::I(), SkMatrix::Scale(1.5f, 1.25f),
+                                 SkMatrix::RotateDeg(30, {50, 40})};
+    for (int m = 0; m < (int)std::size(matrices); ++m) {
+        const SkMatrix& matrix = matrices[m];
+        SkRasterClip expected(path.makeTransform(matrix), SkIRect::MakeWH(100, 100), true);
+        // The first clip misses and caches the coverage, the rest find it.
+        for (int i = 0; i < 3; ++i) {
+            SkRasterClip rc(SkIRect::MakeWH(100, 100));
+            rc.op(path, matrix, SkClipOp::kIntersect, true);
+            REPORTER_ASSERT(reporter, rc == expected);
+
+            data.counter = 0;
+            SkResourceCache::VisitAll(counter, &data);
+            REPORTER_ASSERT(reporter, data.counter == m + 1, "matrix %d clip %d", m, i);
+        }
+    }
+    // One listener purges the clips cached at every matrix.
+    REPORTER_ASSERT(reporter, SkPathPriv::GenIDChangeListenersCount(path) == 1);
+
+    // Resetting the path releases its data, which purges what was cached for it.
+    path.reset();
+    SkResourceCache::CheckMessages();
+    data.counter = 0;
+    SkResourceCache::VisitAll(counter, &data);
+    REPORTER_ASSERT(reporter, data.counter == 0);
+}
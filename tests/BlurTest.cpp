@@ -596,6 +596,38 @@ DEF_TEST(zero_blur, reporter) {
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
 
+// Outer blurs of rects and rrects are drawn as stretched nine-patches, which must leave the
+// shape's interior empty and produce the same edges regardless of the shape's size.
+DEF_TEST(BlurOuterNinePatch, reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(400, 120);
+    SkCanvas canvas(bitmap);
+
+    SkPaint paint;
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kOuter_SkBlurStyle, 3));
+
+    for (bool round : {false, true}) {
+        SkBitmap lefts[2];
+        for (int i = 0; i < 2; ++i) {
+            canvas.clear(SK_ColorWHITE);
+            SkRect r = SkRect::MakeXYWH(20, 20, i == 0 ? 100 : 300, 80);
+            if (round) {
+                canvas.drawRRect(SkRRect::MakeRectXY(r, 8, 8), paint);
+            } else {
+                canvas.drawRect(r, paint);
+            }
+            REPORTER_ASSERT(reporter, bitmap.getColor(r.centerX(), r.centerY()) == SK_ColorWHITE,
+                            "round %d", round);
+            REPORTER_ASSERT(reporter, bitmap.getColor(r.centerX(), r.top() - 3) != SK_ColorWHITE,
+                            "round %d", round);
+
+            lefts[i].allocN32Pixels(60, 120);
+            SkAssertResult(bitmap.readPixels(lefts[i].pixmap(), 0, 0));
+        }
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(lefts[0], lefts[1]), "round %d", round);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 // b/444805331 : Fuzzer created a view matrix that did not preserveRightAngles but could still
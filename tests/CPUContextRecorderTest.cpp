@@ -12,17 +12,28 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkSurface.h"
+#include "include/effects/SkImageFilters.h"
 #include "src/core/SkCPUContextImpl.h"
 #include "src/core/SkResourceCache.h"
 
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
+#include <atomic>
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <utility>
 
 DEF_TEST(CPUSurface_UsesCPUContextAndRecorderToDraw_DrawsPixels, reporter) {
     skcpu::Context::Options opts;
@@ -93,3 +104,156 @@ DEF_TEST(ImageMakeScaled_UsesCPURecorderToMakeImage_Success, reporter) {
     REPORTER_ASSERT(reporter, legacyAPI->width() == 70);
     REPORTER_ASSERT(reporter, !legacyAPI->isTextureBacked());
 }
+
+enum class StarClip {
+    kNone,
+    kHard,  // A clip that is not a rectangle, but has hard edges.
+    kSoft,  // An anti-aliased clip.
+};
+
+static SkBitmap draw_big_star(SkExecutor* executor, bool aa, bool curves, StarClip clip) {
+    skcpu::Context::Options opts;
+    opts.fExecutor = executor;
+    auto ctx = skcpu::Context::Make(opts);
+    std::unique_ptr<skcpu::Recorder> recorder = ctx->makeRecorder();
+    SkImageInfo imageInfo =
+            SkImageInfo::Make(600, 1000, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    auto surface = recorder->makeBitmapSurface(imageInfo, imageInfo.minRowBytes(), {});
+
+    // A self-intersecting star with enough edges to be split into bands.
+    SkPathBuilder builder;
+    constexpr int kPoints = 5003;
+    constexpr SkPoint kCenter = {300, 500};
+    auto point = [&](int i) {
+        float t = i * 2 * 3.14159265f * 2001 / kPoints;
+        return kCenter + SkVector{290 * std::cos(t), 490 * std::sin(t)};
+    };
+    builder.moveTo(point(0));
+    for (int i = 1; i < kPoints; ++i) {
+        if (curves) {
+            // Bulge each edge outwards a little.
+            SkPoint mid = (point(i - 1) + point(i)) * 0.5f;
+            builder.quadTo(kCenter + (mid - kCenter) * 1.2f, point(i));
+        } else {
+            builder.lineTo(point(i));
+        }
+    }
+    builder.setFillType(SkPathFillType::kEvenOdd);
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    if (clip != StarClip::kNone) {
+        // The bands must respect clips that are not rectangles too.
+        canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeLTRB(50, 40, 570, 930)),
+                          clip == StarClip::kSoft);
+    }
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    paint.setAntiAlias(aa);
+    canvas->drawPath(builder.detach(), paint);
+
+    SkBitmap bm;
+    bm.allocPixels(imageInfo);
+    SkAssertResult(surface->readPixels(bm, 0, 0));
+    return bm;
+}
+
+// Counts the work handed to another executor.
+class CountingExecutor final : public SkExecutor {
+public:
+    explicit CountingExecutor(SkExecutor* executor) : fExecutor(executor) {}
+
+    void add(std::function<void(void)> work, int workList) override {
+        fCount.fetch_add(1, std::memory_order_relaxed);
+        fExecutor->add(std::move(work), workList);
+    }
+    void add(std::function<void(void)> work) override {
+        this->add(std::move(work), /* workList= */ 0);
+    }
+    int discardAllPendingWork() override { return fExecutor->discardAllPendingWork(); }
+    void borrow() override { fExecutor->borrow(); }
+
+    int count() const { return fCount.load(std::memory_order_relaxed); }
+
+private:
+    SkExecutor* fExecutor;
+    std::atomic<int> fCount{0};
+};
+
+DEF_TEST(CPUSurface_BandedPathFill_MatchesSerialFill, reporter) {
+    std::unique_ptr<SkExecutor> single = SkExecutor::MakeFIFOThreadPool(1);
+    std::unique_ptr<SkExecutor> threaded = SkExecutor::MakeFIFOThreadPool(4);
+    for (bool aa : {false, true}) {
+        for (bool curves : {false, true}) {
+            for (StarClip clip : {StarClip::kNone, StarClip::kHard, StarClip::kSoft}) {
+                // The star has so many edges per row that anti-aliased fills use the sparse
+                // accumulation rasterizer, which is banded unless the clip is anti-aliased.
+                const bool banded = !aa || clip != StarClip::kSoft;
+                SkBitmap expected = draw_big_star(nullptr, aa, curves, clip);
+                for (SkExecutor* executor : {single.get(), threaded.get()}) {
+                    CountingExecutor counting(executor);
+                    SkBitmap actual = draw_big_star(&counting, aa, curves, clip);
+                    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                                    "aa=%d curves=%d clip=%d", aa, curves, (int)clip);
+                    REPORTER_ASSERT(reporter, (counting.count() > 0) == banded,
+                                    "aa=%d curves=%d clip=%d: %d tasks",
+                                    aa, curves, (int)clip, counting.count());
+                }
+                REPORTER_ASSERT(reporter, expected.getColor(300, 500) != SK_ColorWHITE);
+            }
+        }
+    }
+}
+
+static SkBitmap draw_filter_dag(SkExecutor* executor) {
+    skcpu::Context::Options opts;
+    opts.fExecutor = executor;
+    auto ctx = skcpu::Context::Make(opts);
+    std::unique_ptr<skcpu::Recorder> recorder = ctx->makeRecorder();
+    SkImageInfo imageInfo =
+            SkImageInfo::Make(256, 256, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    auto surface = recorder->makeBitmapSurface(imageInfo, imageInfo.minRowBytes(), {});
+
+    // A wide, shallow DAG like an SVG feMerge of blurred and offset copies of the source, which
+    // is then blended with and displaced by other independent branches. The filters are made
+    // per call so that nothing is shared through the image filter cache between the two runs.
+    constexpr int kBranches = 4;
+    sk_sp<SkImageFilter> branches[kBranches];
+    for (int i = 0; i < kBranches; ++i) {
+        branches[i] = SkImageFilters::Blur(2.f + 3 * i, 2.f + 3 * i,
+                                           SkImageFilters::Offset(4.f * i, -3.f * i, nullptr));
+    }
+    sk_sp<SkImageFilter> merge = SkImageFilters::Merge(branches, kBranches);
+    sk_sp<SkImageFilter> blend = SkImageFilters::Blend(
+            SkBlendMode::kSrcOver, std::move(merge), SkImageFilters::Blur(5.f, 5.f, nullptr));
+    SkPaint paint;
+    paint.setImageFilter(SkImageFilters::DisplacementMap(SkColorChannel::kR,
+                                                         SkColorChannel::kG,
+                                                         12.f,
+                                                         SkImageFilters::Blur(8.f, 8.f, nullptr),
+                                                         std::move(blend)));
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->saveLayer(nullptr, &paint);
+    SkPaint shapePaint;
+    shapePaint.setAntiAlias(true);
+    for (int i = 0; i < 6; ++i) {
+        shapePaint.setColor(SkColorSetARGB(0xFF, 40 * i, 255 - 30 * i, 90 + 20 * i));
+        canvas->drawCircle(40.f + 32 * i, 60.f + 24 * i, 30.f, shapePaint);
+    }
+    canvas->restore();
+
+    SkBitmap bm;
+    bm.allocPixels(imageInfo);
+    SkAssertResult(surface->readPixels(bm, 0, 0));
+    return bm;
+}
+
+DEF_TEST(CPUSurface_ImageFilterDAG_IndependentOfThreadCount, reporter) {
+    std::unique_ptr<SkExecutor> threaded = SkExecutor::MakeFIFOThreadPool(4);
+    SkBitmap expected = draw_filter_dag(nullptr);
+    SkBitmap actual = draw_filter_dag(threaded.get());
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual));
+    REPORTER_ASSERT(reporter, actual.getColor(128, 128) != SK_ColorWHITE);
+}
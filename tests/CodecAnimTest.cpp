@@ -13,6 +13,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -21,6 +22,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -646,4 +648,73 @@ DEF_TEST(AnimCodecPlayer, r) {
     }
 }
 
+
+DEF_TEST(AnimCodecPlayer_keyFrames, r) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(2);
+
+    for (const char* file : { "images/alphabetAnim.gif", "images/required.gif",
+                              "images/stoplight.webp", "images/required.webp" }) {
+        auto data = GetResourceAsData(file);
+        if (!data) {
+            ERRORF(r, "Missing resource %s", file);
+            continue;
+        }
+        auto codec = SkCodec::MakeFromData(data);
+        REPORTER_ASSERT(r, codec);
+        const std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+        const int frameCount = SkToInt(frameInfos.size());
+
+        // The time at which each frame starts, in playback order.
+        std::vector<uint32_t> starts;
+        uint32_t start = 0;
+        for (const auto& info : frameInfos) {
+            if (info.fDuration > 0) {
+                starts.push_back(start);
+            }
+            start += info.fDuration;
+        }
+
+        auto readFrame = [](SkAnimCodecPlayer* player, uint32_t msec, SkBitmap* bm) {
+            player->seek(msec);
+            auto frame = player->getFrame();
+            return frame && bm->tryAllocPixels(frame->imageInfo()) &&
+                   frame->readPixels(bm->pixmap(), 0, 0);
+        };
+
+        SkAnimCodecPlayer reference(SkCodec::MakeFromData(data));
+        std::vector<SkBitmap> expected(starts.size());
+        for (size_t i = 0; i < starts.size(); ++i) {
+            REPORTER_ASSERT(r, readFrame(&reference, starts[i], &expected[i]));
+        }
+        // Every frame is kept, so playing again decodes nothing.
+        for (size_t i = 0; i < starts.size(); ++i) {
+            SkBitmap bm;
+            REPORTER_ASSERT(r, readFrame(&reference, starts[i], &bm));
+        }
+        REPORTER_ASSERT(r, reference.decodedFrameCount() == frameCount);
+
+        for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+            SkAnimCodecPlayer::Options options;
+            options.fMaxKeyFrames = 2;
+            options.fExecutor = exec;
+            SkAnimCodecPlayer player(SkCodec::MakeFromData(data), options);
+
+            // Play forward, then backward, which seeks back to an earlier frame every time.
+            for (size_t i = 0; i < starts.size(); ++i) {
+                SkBitmap bm;
+                REPORTER_ASSERT(r, readFrame(&player, starts[i], &bm));
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(bm, expected[i]),
+                                "%s frame %zu differs (executor: %d)", file, i, exec != nullptr);
+            }
+            for (size_t i = starts.size(); i-- > 0;) {
+                SkBitmap bm;
+                REPORTER_ASSERT(r, readFrame(&player, starts[i], &bm));
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(bm, expected[i]),
+                                "%s frame %zu differs playing backward (executor: %d)",
+                                file, i, exec != nullptr);
+            }
+        }
+    }
+}
+
 #endif
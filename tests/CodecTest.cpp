@@ -20,6 +20,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
@@ -43,6 +44,8 @@
 #include "src/base/SkAutoMalloc.h"
 #include "src/base/SkRandom.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkJpegRestartStrips.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkMD5.h"
@@ -67,8 +70,10 @@
 #include <setjmp.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <optional>
@@ -423,9 +428,10 @@ static void check_subset_decode(skiatest::Reporter* r,
             if (!supportsIncomplete) {
                 REPORTER_ASSERT(r, result == SkCodec::kSuccess);
             }
-            // Webp is the only codec that supports subsets, and it will have modified the subset
-            // to have even left/top.
-            REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            // Webp will have modified the subset to have even left/top.
+            if (codec->getEncodedFormat() == SkEncodedImageFormat::kWEBP) {
+                REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            }
         } else {
             // No subsets will work.
             REPORTER_ASSERT(r, result == SkCodec::kUnimplemented);
@@ -629,23 +635,41 @@ DEF_TEST(Codec_jpg, r) {
     check(r, "images/randPixels.jpg", SkISize::Make(8, 8), true, false, false);
 }
 
+// SkPngCodec decodes subsets, but SkPngRustCodec does not.
+#if defined(SK_CODEC_DECODES_PNG_WITH_LIBPNG)
+static constexpr bool kPngSupportsSubsets = true;
+#else
+static constexpr bool kPngSupportsSubsets = false;
+#endif
+
 DEF_TEST(Codec_png, r) {
-    check(r, "images/arrow.png", SkISize::Make(187, 312), false, false, true, true);
-    check(r, "images/baby_tux.png", SkISize::Make(240, 246), false, false, true, true);
-    check(r, "images/color_wheel.png", SkISize::Make(128, 128), false, false, true, true);
+    check(r, "images/arrow.png", SkISize::Make(187, 312), false, kPngSupportsSubsets, true, true);
+    check(r, "images/baby_tux.png", SkISize::Make(240, 246),
+          false, kPngSupportsSubsets, true, true);
+    check(r, "images/color_wheel.png", SkISize::Make(128, 128),
+          false, kPngSupportsSubsets, true, true);
     // half-transparent-white-pixel.png is too small to test incomplete
-    check(r, "images/half-transparent-white-pixel.png", SkISize::Make(1, 1), false, false, false, true);
-    check(r, "images/mandrill_128.png", SkISize::Make(128, 128), false, false, true, true);
+    check(r, "images/half-transparent-white-pixel.png", SkISize::Make(1, 1),
+          false, kPngSupportsSubsets, false, true);
+    check(r, "images/mandrill_128.png", SkISize::Make(128, 128),
+          false, kPngSupportsSubsets, true, true);
     // mandrill_16.png is too small (relative to embedded sRGB profile) to test incomplete
-    check(r, "images/mandrill_16.png", SkISize::Make(16, 16), false, false, false, true);
-    check(r, "images/mandrill_256.png", SkISize::Make(256, 256), false, false, true, true);
-    check(r, "images/mandrill_32.png", SkISize::Make(32, 32), false, false, true, true);
-    check(r, "images/mandrill_512.png", SkISize::Make(512, 512), false, false, true, true);
-    check(r, "images/mandrill_64.png", SkISize::Make(64, 64), false, false, true, true);
-    check(r, "images/plane.png", SkISize::Make(250, 126), false, false, true, true);
-    check(r, "images/plane_interlaced.png", SkISize::Make(250, 126), false, false, true, true);
-    check(r, "images/randPixels.png", SkISize::Make(8, 8), false, false, true, true);
-    check(r, "images/yellow_rose.png", SkISize::Make(400, 301), false, false, true, true);
+    check(r, "images/mandrill_16.png", SkISize::Make(16, 16),
+          false, kPngSupportsSubsets, false, true);
+    check(r, "images/mandrill_256.png", SkISize::Make(256, 256),
+          false, kPngSupportsSubsets, true, true);
+    check(r, "images/mandrill_32.png", SkISize::Make(32, 32),
+          false, kPngSupportsSubsets, true, true);
+    check(r, "images/mandrill_512.png", SkISize::Make(512, 512),
+          false, kPngSupportsSubsets, true, true);
+    check(r, "images/mandrill_64.png", SkISize::Make(64, 64),
+          false, kPngSupportsSubsets, true, true);
+    check(r, "images/plane.png", SkISize::Make(250, 126), false, kPngSupportsSubsets, true, true);
+    check(r, "images/plane_interlaced.png", SkISize::Make(250, 126),
+          false, kPngSupportsSubsets, true, true);
+    check(r, "images/randPixels.png", SkISize::Make(8, 8), false, kPngSupportsSubsets, true, true);
+    check(r, "images/yellow_rose.png", SkISize::Make(400, 301),
+          false, kPngSupportsSubsets, true, true);
 }
 
 static void verifyFirstFourDecodedBytes(skiatest::Reporter* r,
@@ -1618,6 +1642,77 @@ DEF_TEST(Codec_rowsDecoded, r) {
     REPORTER_ASSERT(r, rowsDecoded == 0);
 }
 
+// Subsets and scaled sizes of a PNG are decoded in one pass. The results should match the
+// corresponding pixels of a full decode.
+DEF_TEST(Codec_png_subsetAndScale, r) {
+    for (const char* path : {"images/plane.png", "images/plane_interlaced.png"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            return;
+        }
+        std::unique_ptr<SkCodec> codec = SkPngDecoder::Decode(data, nullptr);
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s\n", path);
+            continue;
+        }
+
+        const SkImageInfo fullInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+        SkBitmap full;
+        full.allocPixels(fullInfo);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(full.pixmap()));
+
+        struct {
+            SkIRect fSubset;
+            int     fSampleSize;
+        } recs[] = {
+            { fullInfo.bounds(),                                1 },
+            { fullInfo.bounds(),                                3 },
+            { fullInfo.bounds(),                                4 },
+            { SkIRect::MakeXYWH(17, 9, 60, 41),                 1 },
+            { SkIRect::MakeXYWH(17, 9, 60, 41),                 2 },
+            { SkIRect::MakeLTRB(1, fullInfo.height() / 2,
+                                fullInfo.width(), fullInfo.height()), 5 },
+        };
+        for (const auto& rec : recs) {
+            const SkIRect& subset = rec.fSubset;
+            const int sampleSize = rec.fSampleSize;
+            const SkImageInfo info = fullInfo.makeWH(
+                    SkCodecPriv::GetSampledDimension(subset.width(), sampleSize),
+                    SkCodecPriv::GetSampledDimension(subset.height(), sampleSize));
+            SkCodec::Options opts;
+            if (subset != fullInfo.bounds()) {
+                opts.fSubset = &subset;
+            } else {
+                REPORTER_ASSERT(r, codec->getScaledDimensions(1.0f / sampleSize) ==
+                                   info.dimensions());
+            }
+
+            SkBitmap bm;
+            bm.allocPixels(info);
+            const SkCodec::Result result = codec->getPixels(bm.pixmap(), &opts);
+            if (SkCodec::kSuccess != result) {
+                ERRORF(r, "%s: decoding %s at 1/%d failed with %s\n", path,
+                       subset != fullInfo.bounds() ? "a subset" : "the image", sampleSize,
+                       SkCodec::ResultToString(result));
+                continue;
+            }
+
+            const int start = SkCodecPriv::GetStartCoord(sampleSize);
+            bool matches = true;
+            for (int y = 0; y < info.height() && matches; ++y) {
+                for (int x = 0; x < info.width() && matches; ++x) {
+                    matches = *bm.getAddr32(x, y) ==
+                              *full.getAddr32(subset.left() + start + x * sampleSize,
+                                              subset.top() + start + y * sampleSize);
+                }
+            }
+            REPORTER_ASSERT(r, matches, "%s: subset (%d, %d, %d, %d) at 1/%d", path,
+                            subset.left(), subset.top(), subset.right(), subset.bottom(),
+                            sampleSize);
+        }
+    }
+}
+
 static void test_invalid_images(skiatest::Reporter* r, const char* path,
                                 SkCodec::Result expectedResult) {
     auto stream = GetResourceAsStream(path);
@@ -2217,6 +2312,102 @@ DEF_TEST(Codec_jpeg_can_return_data_from_original_stream, r) {
     REPORTER_ASSERT(r, SkJpegDecoder::IsJpeg(encodedData->data(), encodedData->size()));
 }
 
+// Baseline JPEGs with restart markers at the start of rows of MCUs are decoded in strips when
+// given an executor. The result should be identical to a serial decode.
+namespace {
+
+// Forwards to another executor, counting the work it is given.
+class CountingExecutor final : public SkExecutor {
+public:
+    explicit CountingExecutor(SkExecutor* executor) : fExecutor(executor) {}
+
+    void add(std::function<void(void)> work, int workList) override {
+        fCount.fetch_add(1, std::memory_order_relaxed);
+        fExecutor->add(std::move(work), workList);
+    }
+    void add(std::function<void(void)> work) override {
+        this->add(std::move(work), /* workList= */ 0);
+    }
+    int discardAllPendingWork() override { return fExecutor->discardAllPendingWork(); }
+    void borrow() override { fExecutor->borrow(); }
+
+    int count() const { return fCount.load(std::memory_order_relaxed); }
+
+private:
+    SkExecutor* fExecutor;
+    std::atomic<int> fCount{0};
+};
+
+}  // namespace
+
+// Decodes 'data' serially and with an executor, checks that they match, and returns the number of
+// tasks the executor was given.
+static int decode_concurrently(skiatest::Reporter* r, const char* path, sk_sp<SkData> data,
+                               SkExecutor* executor) {
+    std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(std::move(data), nullptr);
+    if (!codec) {
+        ERRORF(r, "Failed to create codec for %s\n", path);
+        return 0;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected.pixmap()));
+
+    CountingExecutor counting(executor);
+    SkCodec::Options options;
+    options.fExecutor = &counting;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(actual.pixmap(), &options));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual), "%s", path);
+    return counting.count();
+}
+
+DEF_TEST(Codec_jpeg_concurrentRestartStrips, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    REPORTER_ASSERT(r, SkJpegRestartStrips::MaxStripCount(127) == 1);
+    REPORTER_ASSERT(r, SkJpegRestartStrips::MaxStripCount(128) == 2);
+    REPORTER_ASSERT(r, SkJpegRestartStrips::MaxStripCount(207) == 3);
+    REPORTER_ASSERT(r, SkJpegRestartStrips::MaxStripCount(4000) == 16);
+
+    // These have a restart interval at the start of every row of MCUs, so they are split into as
+    // many strips as their height allows, and each strip is decoded as one task.
+    for (const char* path : {"images/icc-v2-gbr.jpg",         // 4:2:0, 207 rows
+                             "images/mandrill_cmyk.jpg",      // CMYK, 128 rows
+                             "images/crbug1465627.jpeg"}) {   // 200 rows
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            SkDebugf("Missing resource '%s'\n", path);
+            return;
+        }
+        std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(data, nullptr);
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s\n", path);
+            continue;
+        }
+        const int stripCount = SkJpegRestartStrips::MaxStripCount(codec->dimensions().height());
+        REPORTER_ASSERT(r, stripCount >= 2, "%s", path);
+        REPORTER_ASSERT(r, SkJpegRestartStrips::Split(data.get(), stripCount).size() ==
+                           (size_t)stripCount, "%s", path);
+
+        const int tasks = decode_concurrently(r, path, data, executor.get());
+        REPORTER_ASSERT(r, tasks == stripCount, "%s: %d tasks, expected %d", path, tasks,
+                        stripCount);
+    }
+
+    // Progressive images, and those without restart markers, are decoded serially.
+    for (const char* path : {"images/mandrill_512_q075.jpg", "images/brickwork-texture.jpg"}) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        REPORTER_ASSERT(r, SkJpegRestartStrips::Split(data.get(), 4).empty(), "%s", path);
+        const int tasks = decode_concurrently(r, path, data, executor.get());
+        REPORTER_ASSERT(r, tasks == 0, "%s: %d tasks", path, tasks);
+    }
+}
+
 DEF_TEST(Codec_jpeg_decode_progressive_truncated_stream, r) {
     constexpr char path[] = "images/progressive_kitten_missing_eof.jpg";
     std::unique_ptr<SkStream> stream(GetResourceAsStream(path));
@@ -15,6 +15,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -30,9 +31,11 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
 #include "modules/skcms/src/skcms_public.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkColorPriv.h"
 #include "src/core/SkConvertPixels.h"
 #include "src/core/SkImageInfoPriv.h"
+#include "src/encode/SkPngFilters.h"
 #include "tests/Test.h"
 #include "tools/DecodeUtils.h"
 
@@ -53,9 +56,12 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <initializer_list>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 static sk_sp<SkData> encode(SkEncodedImageFormat format, const SkPixmap& src) {
@@ -394,6 +400,69 @@ DEF_TEST(Encode_JpegDownsample, r) {
     REPORTER_ASSERT(r, almost_equals(bm1, bm2, 60));
 }
 
+DEF_TEST(Encode_JpegConcurrent, r) {
+    // Tall enough that every format is split into several strips, and wide enough that the
+    // rows end in partial MCUs.
+    const SkImageInfo kInfos[] = {
+            SkImageInfo::MakeN32Premul(100, 1500),
+            SkImageInfo::Make(100, 1500, kRGB_888x_SkColorType, kOpaque_SkAlphaType),
+            SkImageInfo::MakeA8(300, 3100),
+    };
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const SkImageInfo& info : kInfos) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        for (int y = 0; y < info.height(); ++y) {
+            for (int x = 0; x < info.width(); ++x) {
+                bitmap.erase(SkColorSetARGB(0xFF - (y & 0x3F),
+                                            (x + y) & 0xFF,
+                                            (2 * x) & 0xFF,
+                                            (y / 3) ^ ((x * 7919 + y * 104729) % 251)),
+                             SkIRect::MakeXYWH(x, y, 1, 1));
+            }
+        }
+
+        for (auto downsample : {SkJpegEncoder::Downsample::k420,
+                                SkJpegEncoder::Downsample::k422,
+                                SkJpegEncoder::Downsample::k444}) {
+            SkJpegEncoder::Options options;
+            options.fQuality = 90;
+            options.fDownsample = downsample;
+            sk_sp<SkData> serial = SkJpegEncoder::Encode(bitmap.pixmap(), options);
+            options.fExecutor = executor.get();
+            sk_sp<SkData> concurrent = SkJpegEncoder::Encode(bitmap.pixmap(), options);
+            REPORTER_ASSERT(r, serial && concurrent);
+            if (!serial || !concurrent) {
+                continue;
+            }
+
+            // The strips only change the entropy coding, so the pixels are the same.
+            SkBitmap serialBitmap, concurrentBitmap;
+            REPORTER_ASSERT(r, SkImages::DeferredFromEncodedData(serial)->asLegacyBitmap(
+                                       &serialBitmap));
+            REPORTER_ASSERT(r, SkImages::DeferredFromEncodedData(concurrent)->asLegacyBitmap(
+                                       &concurrentBitmap));
+            REPORTER_ASSERT(r, almost_equals(serialBitmap, concurrentBitmap, 0),
+                            "colorType %d, downsample %d",
+                            info.colorType(), static_cast<int>(downsample));
+        }
+    }
+}
+
+DEF_TEST(Encode_JpegConcurrentTooTall, r) {
+    // Each strip is short enough for libjpeg, but the whole image is taller than its
+    // JPEG_MAX_DIMENSION of 65500, so nothing may be written.
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(8, 65501));
+    bitmap.eraseColor(SK_ColorBLACK);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkJpegEncoder::Options options;
+    options.fExecutor = executor.get();
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, !SkJpegEncoder::Encode(&stream, bitmap.pixmap(), options));
+    REPORTER_ASSERT(r, stream.bytesWritten() == 0);
+}
+
 static inline void pushComment(
         std::vector<std::string>& comments, const char* keyword, const char* text) {
     comments.push_back(keyword);
@@ -505,6 +574,110 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+DEF_TEST(Encode_PngConcurrent, r) {
+    // Tall enough that every format is split into several strips.
+    const SkImageInfo kInfos[] = {
+            SkImageInfo::MakeN32Premul(300, 700),
+            SkImageInfo::MakeN32(300, 700, kOpaque_SkAlphaType),
+            SkImageInfo::Make(200, 700, kRGBA_F16_SkColorType, kOpaque_SkAlphaType),
+            SkImageInfo::MakeA8(500, 700),
+    };
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const SkImageInfo& info : kInfos) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        for (int y = 0; y < info.height(); ++y) {
+            for (int x = 0; x < info.width(); ++x) {
+                // Smooth gradients with some noise, so that different filters are chosen.
+                uint8_t noise = (x * 7919 + y * 104729) % 251 < 32 ? 0x40 : 0;
+                bitmap.erase(SkColorSetARGB(0xFF - (y & 0x3F),
+                                            (x + y) & 0xFF,
+                                            (2 * x) & 0xFF,
+                                            (y / 3) ^ noise),
+                             SkIRect::MakeXYWH(x, y, 1, 1));
+            }
+        }
+
+        // Level 1 learns a filter from the first rows, which both paths must agree on.
+        for (auto [filters, zlibLevel] : {std::make_pair(SkPngEncoder::FilterFlag::kAll, 6),
+                                          std::make_pair(SkPngEncoder::FilterFlag::kPaeth, 6),
+                                          std::make_pair(SkPngEncoder::FilterFlag::kAll, 1)}) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filters;
+            options.fZLibLevel = zlibLevel;
+            sk_sp<SkData> serial = SkPngEncoder::Encode(bitmap.pixmap(), options);
+            options.fExecutor = executor.get();
+            sk_sp<SkData> concurrent = SkPngEncoder::Encode(bitmap.pixmap(), options);
+            REPORTER_ASSERT(r, serial && concurrent);
+            if (!serial || !concurrent) {
+                continue;
+            }
+
+            SkBitmap serialBitmap, concurrentBitmap;
+            REPORTER_ASSERT(r, SkImages::DeferredFromEncodedData(serial)->asLegacyBitmap(
+                                       &serialBitmap));
+            REPORTER_ASSERT(r, SkImages::DeferredFromEncodedData(concurrent)->asLegacyBitmap(
+                                       &concurrentBitmap));
+            REPORTER_ASSERT(r, almost_equals(serialBitmap, concurrentBitmap, 0),
+                            "colorType %d, filters 0x%x, level %d",
+                            info.colorType(), static_cast<int>(filters), zlibLevel);
+        }
+    }
+}
+
+static uint8_t reference_png_filter(SkPngFilters::Type type, int x, int a, int b, int c) {
+    int prediction = 0;
+    switch (type) {
+        case SkPngFilters::Type::kNone:  prediction = 0;           break;
+        case SkPngFilters::Type::kSub:   prediction = a;           break;
+        case SkPngFilters::Type::kUp:    prediction = b;           break;
+        case SkPngFilters::Type::kAvg:   prediction = (a + b) / 2; break;
+        case SkPngFilters::Type::kPaeth: {
+            int p = a + b - c;
+            int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+            prediction = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+            break;
+        }
+    }
+    return static_cast<uint8_t>(x - prediction);
+}
+
+DEF_TEST(Encode_PngFilters_MatchReference, r) {
+    SkRandom random;
+    for (size_t bpp : {1, 2, 3, 4, 6, 8}) {
+        // Long enough to cover the vector loop and a scalar tail.
+        const size_t size = bpp * 37;
+        std::vector<uint8_t> row(size), prev(size), filtered(size), adaptive(size + 1),
+                scratch(size + 1);
+        for (size_t i = 0; i < size; ++i) {
+            row[i] = random.nextBits(8);
+            prev[i] = random.nextBits(8);
+        }
+
+        uint64_t bestSum = UINT64_MAX;
+        for (int t = 0; t < SkPngFilters::kTypeCount; ++t) {
+            const auto type = static_cast<SkPngFilters::Type>(t);
+            SkPngFilters::Filter(type, row.data(), prev.data(), size, bpp, filtered.data());
+            uint64_t sum = 0;
+            for (size_t i = 0; i < size; ++i) {
+                const int a = i >= bpp ? row[i - bpp] : 0;
+                const int c = i >= bpp ? prev[i - bpp] : 0;
+                REPORTER_ASSERT(r, filtered[i] == reference_png_filter(type, row[i], a, prev[i], c),
+                                "type %d, bpp %zu, byte %zu", t, bpp, i);
+                sum += std::abs(static_cast<int8_t>(filtered[i]));
+            }
+            REPORTER_ASSERT(r, SkPngFilters::SumOfMagnitudes(filtered.data(), size) == sum);
+            bestSum = std::min(bestSum, sum);
+        }
+
+        SkPngFilters::Type chosen = SkPngFilters::FilterAdaptive(
+                (int)SkPngEncoder::FilterFlag::kAll, row.data(), prev.data(), size, bpp,
+                adaptive.data(), scratch.data());
+        REPORTER_ASSERT(r, adaptive[0] == static_cast<uint8_t>(chosen));
+        REPORTER_ASSERT(r, SkPngFilters::SumOfMagnitudes(adaptive.data() + 1, size) == bestSum);
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
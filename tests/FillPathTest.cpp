@@ -5,18 +5,30 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPathBuilder.h"
 #include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkScan.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
 struct FakeBlitter : public SkBlitter {
     FakeBlitter()
@@ -53,3 +65,144 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+static SkBitmap fill_with(SkAAFillAlgorithm algorithm, const SkPath& path, int size = 32) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeA8(size, size));
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bm);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkAutoAAFillAlgorithm autoAlgorithm(algorithm);
+    canvas.drawPath(path, paint);
+    return bm;
+}
+
+// The sparse accumulation rasterizer should agree with AAA (up to rounding) on overlapping
+// axis-aligned shapes, where both compute exact pixel coverage.
+DEF_TEST(FillPathSparseAccumulation, reporter) {
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd}) {
+        SkPath path = SkPathBuilder(fillType)
+                              .addRect({2.5f, 2.5f, 20.5f, 20.5f})
+                              .addRect({10.25f, 10.75f, 29.5f, 28.5f})
+                              .addRect({4, 24, 8, 30}, SkPathDirection::kCCW)
+                              .detach();
+        SkBitmap aaa = fill_with(SkAAFillAlgorithm::kAnalytic, path);
+        SkBitmap accum = fill_with(SkAAFillAlgorithm::kSparseAccumulation, path);
+
+        int maxDiff = 0;
+        for (int y = 0; y < aaa.height(); ++y) {
+            for (int x = 0; x < aaa.width(); ++x) {
+                maxDiff = std::max(maxDiff, std::abs(*aaa.getAddr8(x, y) - *accum.getAddr8(x, y)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 2, "max diff %d", maxDiff);
+        // The overlap is filled by winding and empty by even-odd.
+        REPORTER_ASSERT(reporter, *accum.getAddr8(15, 15) ==
+                                  (fillType == SkPathFillType::kWinding ? 0xFF : 0));
+    }
+}
+
+static SkPath lissajous(SkPathFillType fillType, bool curves) {
+    auto at = [](float t) {
+        return SkPoint{50 + 45 * std::sin(3 * t), 50 + 45 * std::sin(2 * t)};
+    };
+    constexpr int kSegments = 300;
+    constexpr float kStep = 2 * SK_FloatPI / kSegments;
+    SkPathBuilder builder(fillType);
+    builder.moveTo(at(0));
+    for (int i = 1; i <= kSegments; ++i) {
+        const SkPoint end = at(i * kStep);
+        if (curves) {
+            // Pick the control point so the quad passes through the curve's midpoint.
+            const SkPoint start = at((i - 1) * kStep), mid = at((i - 0.5f) * kStep);
+            builder.quadTo(mid * 2 - (start + end) * 0.5f, end);
+        } else {
+            builder.lineTo(end);
+        }
+    }
+    return builder.close().detach();
+}
+
+// Paths with enough points that AntiFillPath picks the sparse accumulation rasterizer. Where many
+// edges cross within a pixel neither rasterizer is exact (AAA stops computing edge intersections,
+// and accumulation sums the windings of the pieces), so this allows a mean difference of 3/255
+// and up to 1% of the pixels differing by more than 32/255.
+DEF_TEST(FillPathSparseAccumulation_ComplexPaths, reporter) {
+    SkPathBuilder circles;
+    for (int i = 0; i < 40; ++i) {
+        circles.addCircle(20 + i * 1.5f, 30 + (i % 7) * 5.3f, 12.5f + (i % 5));
+    }
+    const struct {
+        const char* fName;
+        SkPath      fPath;
+    } kCases[] = {
+        {"overlapping circles", circles.detach()},
+        {"self-intersecting lines", lissajous(SkPathFillType::kEvenOdd, /*curves=*/false)},
+        {"self-intersecting quads", lissajous(SkPathFillType::kWinding, /*curves=*/true)},
+    };
+    for (const auto& c : kCases) {
+        constexpr int kSize = 100;
+        SkBitmap aaa = fill_with(SkAAFillAlgorithm::kAnalytic, c.fPath, kSize);
+        SkBitmap chosen = fill_with(SkAAFillAlgorithm::kHeuristic, c.fPath, kSize);
+        SkBitmap accum = fill_with(SkAAFillAlgorithm::kSparseAccumulation, c.fPath, kSize);
+        REPORTER_ASSERT(reporter, !memcmp(chosen.getPixels(), accum.getPixels(),
+                                          accum.computeByteSize()), "%s", c.fName);
+
+        int totalDiff = 0, outliers = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                const int diff = std::abs(*aaa.getAddr8(x, y) - *accum.getAddr8(x, y));
+                totalDiff += diff;
+                outliers += diff > 32;
+            }
+        }
+        REPORTER_ASSERT(reporter, totalDiff <= 3 * kSize * kSize,
+                        "%s: mean diff %g", c.fName, (double)totalDiff / (kSize * kSize));
+        REPORTER_ASSERT(reporter, outliers <= kSize * kSize / 100,
+                        "%s: %d pixels differ by more than 32", c.fName, outliers);
+    }
+}
+
+// A path far wider than the clip is accumulated only across the clip, with the winding of
+// everything left of the clip carried into its first column, so the clipped pixels match the
+// pixels of a fill clipped only to the canvas.
+DEF_TEST(FillPathSparseAccumulation_WidePathSmallClip, reporter) {
+    constexpr int kSize = 100;
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd}) {
+        // About 3600 pixels wide, centered on the canvas.
+        const SkPath path = lissajous(fillType, /*curves=*/true)
+                                    .makeTransform(SkMatrix::Translate(50, 0) *
+                                                   SkMatrix::Scale(40, 1) *
+                                                   SkMatrix::Translate(-50, 0));
+        const SkBitmap full = fill_with(SkAAFillAlgorithm::kSparseAccumulation, path, kSize);
+
+        const SkIRect clip = SkIRect::MakeLTRB(20, 10, 70, 90);
+        SkBitmap clipped;
+        clipped.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        clipped.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(clipped);
+            canvas.clipIRect(clip);
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            SkAutoAAFillAlgorithm autoAlgorithm(SkAAFillAlgorithm::kSparseAccumulation);
+            canvas.drawPath(path, paint);
+        }
+
+        int maxDiff = 0, outside = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                const int a = *clipped.getAddr8(x, y);
+                if (clip.contains(x, y)) {
+                    maxDiff = std::max(maxDiff, std::abs(a - *full.getAddr8(x, y)));
+                } else {
+                    outside += a != 0;
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "max diff %d", maxDiff);
+        REPORTER_ASSERT(reporter, outside == 0);
+    }
+}
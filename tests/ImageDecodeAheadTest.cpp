@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkRefCnt.h"
+#include "src/image/SkImageDecodeAhead.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Runs work only when a thread waiting on it borrows this executor, so that the tests control
+// when requests are decoded.
+class BorrowOnlyExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { fWork.push_back(std::move(work)); }
+
+    void borrow() override {
+        if (!fWork.empty()) {
+            std::function<void(void)> work = std::move(fWork.front());
+            fWork.pop_front();
+            work();
+        }
+    }
+
+private:
+    std::deque<std::function<void(void)>> fWork;
+};
+
+std::vector<SkImageDecodeAhead::Request> make_requests() {
+    std::vector<SkImageDecodeAhead::Request> requests;
+    for (const char* path : {"images/mandrill_128.png", "images/color_wheel.png",
+                             "images/plane.png"}) {
+        sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(GetResourceAsData(path));
+        if (!image) {
+            return {};
+        }
+        requests.push_back({std::move(image), 0});
+    }
+    return requests;
+}
+
+}  // namespace
+
+DEF_TEST(ImageDecodeAhead_DecodesIntoBitmapCache, r) {
+    std::vector<SkImageDecodeAhead::Request> requests = make_requests();
+    if (requests.empty()) {
+        return;
+    }
+    size_t bytes = 0;
+    for (const auto& request : requests) {
+        bytes += request.fImage->imageInfo().computeMinByteSize();
+    }
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(4, 4);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> rasterImage = bitmap.asImage();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkImageDecodeAhead decodeAhead(*executor, SIZE_MAX);
+    decodeAhead.add(requests);
+    // Images that were already added, and images that aren't lazy, are ignored.
+    decodeAhead.add(requests);
+    decodeAhead.add({{rasterImage, 0}});
+    decodeAhead.wait();
+
+    SkImageDecodeAhead::Stats stats = decodeAhead.stats();
+    REPORTER_ASSERT(r, stats.fQueueDepth == 0);
+    REPORTER_ASSERT(r, stats.fDecoded == 3);
+    REPORTER_ASSERT(r, stats.fSkipped == 0);
+    REPORTER_ASSERT(r, stats.fBytesDecoded == bytes);
+
+    for (const auto& request : requests) {
+        // The pixels could in theory have been purged by another test, but if prepare() finds
+        // them it must count a hit.
+        const bool cached = decodeAhead.prepare(request.fImage.get());
+        REPORTER_ASSERT(r, decodeAhead.stats().fHits == (cached ? 1 : 0) + stats.fHits);
+        stats = decodeAhead.stats();
+    }
+    REPORTER_ASSERT(r, !decodeAhead.prepare(rasterImage.get()));
+    REPORTER_ASSERT(r, stats.fHits + stats.fMisses == 3);
+}
+
+DEF_TEST(ImageDecodeAhead_PriorityAndBudget, r) {
+    std::vector<SkImageDecodeAhead::Request> requests = make_requests();
+    if (requests.empty()) {
+        return;
+    }
+    // Only the highest priority image fits in the budget.
+    requests[2].fPriority = 1;
+    const size_t budget = requests[2].fImage->imageInfo().computeMinByteSize();
+
+    BorrowOnlyExecutor executor;
+    SkImageDecodeAhead decodeAhead(executor, budget);
+    decodeAhead.add(requests);
+    REPORTER_ASSERT(r, decodeAhead.stats().fQueueDepth == 3);
+
+    // Playback needs the first image before anything has been decoded ahead, so it is decoded
+    // on this thread. That doesn't count against the budget.
+    decodeAhead.prepare(requests[0].fImage.get());
+    SkImageDecodeAhead::Stats stats = decodeAhead.stats();
+    REPORTER_ASSERT(r, stats.fQueueDepth == 2);
+    REPORTER_ASSERT(r, stats.fMisses == 1);
+    REPORTER_ASSERT(r, stats.fDecoded == 0);
+
+    decodeAhead.wait();
+    stats = decodeAhead.stats();
+    REPORTER_ASSERT(r, stats.fQueueDepth == 0);
+    REPORTER_ASSERT(r, stats.fDecoded == 1);
+    REPORTER_ASSERT(r, stats.fSkipped == 1);
+    REPORTER_ASSERT(r, stats.fBytesDecoded == budget);
+}
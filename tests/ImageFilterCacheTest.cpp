@@ -187,6 +187,70 @@ static void test_explicit_purging(skiatest::Reporter* reporter,
     REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
 }
 
+// When the cache is full, results that were cheap to produce are purged before older, expensive ones
+static void test_cost_aware_purge(skiatest::Reporter* reporter,
+                                  const sk_sp<SkSpecialImage>& image) {
+    const size_t kCacheSize = 2 * image->getSize() + 10;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey expensiveKey(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey cheapKey(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey newKey(2, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+
+    skif::FilterResult result(image, skif::LayerSpace<SkIPoint>({0, 0}));
+    auto blur = SkImageFilters::Blur(20, 20, nullptr);
+    auto colorFilter = make_filter();
+    cache->set(expensiveKey, blur.get(), result, /*recomputeNanos=*/1e6);
+    cache->set(cheapKey, colorFilter.get(), result, /*recomputeNanos=*/1e3);
+
+    // Adding a third result purges the cheap one, even though the expensive one is older.
+    cache->set(newKey, colorFilter.get(), result, /*recomputeNanos=*/1e3);
+    skif::FilterResult foundImage;
+    REPORTER_ASSERT(reporter, cache->get(expensiveKey, &foundImage));
+    REPORTER_ASSERT(reporter, !cache->get(cheapKey, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(newKey, &foundImage));
+
+    SkImageFilterCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(reporter, stats.fHits == 2);
+    REPORTER_ASSERT(reporter, stats.fMisses == 1);
+    REPORTER_ASSERT(reporter, stats.fBytesSaved == 2 * image->getSize());
+    REPORTER_ASSERT(reporter, stats.fRecomputeNanosSaved == 1e6 + 1e3);
+    REPORTER_ASSERT(reporter, stats.hitRate() == 2.0 / 3.0);
+}
+
+// Priorities compare across shards: results without a cost are purged least recently used first
+// wherever their keys land, and an expensive result that is never used again still ages out.
+static void test_purge_order_across_shards(skiatest::Reporter* reporter,
+                                           const sk_sp<SkSpecialImage>& image) {
+    const size_t kCacheSize = 2 * image->getSize() + 10;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    auto key = [&](uint32_t id) {
+        return SkImageFilterCacheKey(id, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    };
+    skif::FilterResult result(image, skif::LayerSpace<SkIPoint>({0, 0}));
+    auto filter = make_filter();
+    skif::FilterResult foundImage;
+
+    for (uint32_t id = 0; id < 32; ++id) {
+        cache->set(key(id), filter.get(), result);
+    }
+    for (uint32_t id = 0; id < 32; ++id) {
+        REPORTER_ASSERT(reporter, cache->get(key(id), &foundImage) == (id >= 30));
+    }
+
+    // Each result added purges the previous one, raising the priority of the next, until it is
+    // above the priority of the expensive result.
+    cache->set(key(100), filter.get(), result, /*recomputeNanos=*/1e6);
+    for (uint32_t id = 101; id < 101 + 2000; ++id) {
+        cache->set(key(id), filter.get(), result, /*recomputeNanos=*/1e3);
+    }
+    REPORTER_ASSERT(reporter, !cache->get(key(100), &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key(101 + 1999), &foundImage));
+}
+
 DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     SkBitmap srcBM = create_bm();
 
@@ -203,6 +267,8 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_cost_aware_purge(reporter, fullImg);
+    test_purge_order_across_shards(reporter, fullImg);
 }
 
 
@@ -19,6 +19,7 @@
 #include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
@@ -45,7 +46,9 @@
 #include "include/gpu/ganesh/GrTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBitmapDevice.h"
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -92,7 +95,10 @@
 #endif
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <utility>
 #include <limits>
@@ -1258,6 +1264,313 @@ DEF_TEST(ImageFilterMatrixConvolutionBorder, reporter) {
     canvas.restore();
 }
 
+// Random premul pixels with transparent gaps, so that morphology and convolution see edges.
+static sk_sp<SkImage> make_random_premul_image(int width, int height) {
+    SkRandom random;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            SkColor c = random.nextU() % 4 ? random.nextU() : SK_ColorTRANSPARENT;
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(c);
+        }
+    }
+    return bitmap.asImage();
+}
+
+static SkBitmap draw_filtered_image(sk_sp<SkImage> image, SkIPoint origin, SkISize size,
+                                    sk_sp<SkImageFilter> filter) {
+    SkBitmap result;
+    result.allocN32Pixels(size.width(), size.height());
+    SkCanvas canvas(result);
+    canvas.clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setImageFilter(std::move(filter));
+    canvas.drawImage(image, origin.fX, origin.fY, SkSamplingOptions(), &paint);
+    return result;
+}
+
+DEF_TEST(ImageFilterMorphology_LargeRadiusMatchesNaive, reporter) {
+    constexpr SkISize kSize = {96, 96};
+    constexpr SkIPoint kOrigin = {24, 28};
+    sk_sp<SkImage> image = make_random_premul_image(48, 40);
+    SkBitmap imageBitmap;
+    SkAssertResult(image->asLegacyBitmap(&imageBitmap));
+
+    auto imagePixel = [&](int x, int y, int channel) -> int {
+        x -= kOrigin.fX;
+        y -= kOrigin.fY;
+        if (x < 0 || x >= imageBitmap.width() || y < 0 || y >= imageBitmap.height()) {
+            return 0;
+        }
+        return (*imageBitmap.getAddr32(x, y) >> (8 * channel)) & 0xFF;
+    };
+
+    for (bool dilate : {true, false}) {
+        for (SkISize radii : {SkISize{1, 2}, SkISize{7, 3}, SkISize{19, 23}}) {
+            sk_sp<SkImageFilter> filter =
+                    dilate ? SkImageFilters::Dilate(radii.width(), radii.height(), nullptr)
+                           : SkImageFilters::Erode(radii.width(), radii.height(), nullptr);
+            SkBitmap actual = draw_filtered_image(image, kOrigin, kSize, std::move(filter));
+
+            int mismatches = 0;
+            for (int y = 0; y < kSize.height(); ++y) {
+                for (int x = 0; x < kSize.width(); ++x) {
+                    uint32_t expected = 0;
+                    for (int channel = 0; channel < 4; ++channel) {
+                        int aggregate = dilate ? 0 : 255;
+                        for (int dy = -radii.height(); dy <= radii.height(); ++dy) {
+                            for (int dx = -radii.width(); dx <= radii.width(); ++dx) {
+                                int v = imagePixel(x + dx, y + dy, channel);
+                                aggregate = dilate ? std::max(aggregate, v)
+                                                   : std::min(aggregate, v);
+                            }
+                        }
+                        expected |= aggregate << (8 * channel);
+                    }
+                    mismatches += *actual.getAddr32(x, y) != expected;
+                }
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0, "dilate %d, radii %dx%d: %d mismatches",
+                            dilate, radii.width(), radii.height(), mismatches);
+        }
+    }
+}
+
+DEF_TEST(ImageFilterMatrixConvolution_SeparableMatchesGeneral, reporter) {
+    // A rank 1 kernel is applied as two 1D passes, but a tiny change to one coefficient makes it
+    // rank 2 and goes through the general path. Both should match a direct evaluation of the
+    // convolution, for a symmetric kernel centered on each pixel and for a lopsided kernel whose
+    // offset puts it mostly above and to the right of each pixel.
+    struct Case {
+        std::array<float, 5> fRow;
+        std::array<float, 3> fColumn;
+        SkIPoint fOffset;
+        float fGain;
+        float fBias;
+    };
+    const Case kCases[] = {
+        {{1, 4, 6, 4, 1}, {1, 2, 1}, {2, 1}, 1.f / 64, 0.f},
+        {{-1, 0.5f, 2, 3, 0.25f}, {2, -1, 0.5f}, {0, 2}, 1.f / 6, 20.f},
+    };
+    constexpr SkISize kKernelSize = {5, 3};
+    constexpr SkISize kSize = {64, 64};
+    constexpr SkIPoint kOrigin = {8, 8};
+    sk_sp<SkImage> image = make_random_premul_image(48, 48);
+    SkBitmap imageBitmap;
+    SkAssertResult(image->asLegacyBitmap(&imageBitmap));
+
+    // The image's color at (x,y) in the result, in [0,1], and unpremultiplied when 'unpremul'.
+    auto imageColor = [&](int x, int y, bool unpremul) -> std::array<float, 4> {
+        x -= kOrigin.fX;
+        y -= kOrigin.fY;
+        if (x < 0 || x >= imageBitmap.width() || y < 0 || y >= imageBitmap.height()) {
+            return {0, 0, 0, 0};
+        }
+        std::array<float, 4> c;
+        for (int channel = 0; channel < 4; ++channel) {
+            c[channel] = ((*imageBitmap.getAddr32(x, y) >> (8 * channel)) & 0xFF) / 255.f;
+        }
+        if (unpremul && c[3] > 0.f) {
+            for (int channel = 0; channel < 3; ++channel) {
+                c[channel] /= c[3];
+            }
+        }
+        return c;
+    };
+
+    for (const Case& c : kCases) {
+        float separable[15], general[15];
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 5; ++x) {
+                separable[y * 5 + x] = general[y * 5 + x] = c.fColumn[y] * c.fRow[x];
+            }
+        }
+        general[0] += 1e-3f;
+
+        for (bool convolveAlpha : {true, false}) {
+            SkBitmap results[2];
+            for (int i = 0; i < 2; ++i) {
+                sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                        kKernelSize, i == 0 ? separable : general, c.fGain, c.fBias, c.fOffset,
+                        SkTileMode::kDecal, convolveAlpha, nullptr);
+                results[i] = draw_filtered_image(image, kOrigin, kSize, std::move(filter));
+            }
+
+            int maxError = 0;
+            for (int y = 0; y < kSize.height(); ++y) {
+                for (int x = 0; x < kSize.width(); ++x) {
+                    std::array<float, 4> sum = {0, 0, 0, 0};
+                    for (int ky = 0; ky < kKernelSize.height(); ++ky) {
+                        for (int kx = 0; kx < kKernelSize.width(); ++kx) {
+                            std::array<float, 4> p = imageColor(x - c.fOffset.fX + kx,
+                                                                y - c.fOffset.fY + ky,
+                                                                !convolveAlpha);
+                            for (int channel = 0; channel < 4; ++channel) {
+                                sum[channel] += separable[ky * 5 + kx] * p[channel];
+                            }
+                        }
+                    }
+                    for (float& v : sum) {
+                        v = v * c.fGain + c.fBias / 255.f;
+                    }
+                    const float a = convolveAlpha ? std::clamp(sum[3], 0.f, 1.f)
+                                                  : imageColor(x, y, true)[3];
+                    for (int channel = 0; channel < 4; ++channel) {
+                        float v = channel == 3 ? a
+                                               : std::clamp(convolveAlpha ? sum[channel]
+                                                                          : sum[channel] * a,
+                                                            0.f, a);
+                        int expected = (int) std::lround(v * 255.f);
+                        for (const SkBitmap& result : results) {
+                            int actual = (*result.getAddr32(x, y) >> (8 * channel)) & 0xFF;
+                            maxError = std::max(maxError, std::abs(actual - expected));
+                        }
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, maxError <= 1, "offset (%d, %d), convolveAlpha %d, error %d",
+                            c.fOffset.fX, c.fOffset.fY, convolveAlpha, maxError);
+            REPORTER_ASSERT(reporter, results[0].getColor(32, 32) != SK_ColorTRANSPARENT);
+        }
+    }
+}
+
+DEF_TEST(ImageFilterLighting_MatchesReference, reporter) {
+    constexpr SkISize kSize = {80, 72};
+    constexpr SkIPoint kOrigin = {16, 12};
+    constexpr float kSurfaceScale = 2.f, kK = 0.9f, kShininess = 8.f;
+    constexpr float kFalloff = 2.f, kCutoffAngle = 40.f;
+    constexpr SkColor kLightColor = SkColorSetRGB(0xF0, 0xC0, 0x80);
+    const SkPoint3 kLocation = {70.f, 20.f, 30.f}, kTarget = {30.f, 50.f, 0.f},
+                   kDirection = {-1.f, 1.f, 2.f};
+    sk_sp<SkImage> image = make_random_premul_image(48, 40);
+    SkBitmap imageBitmap;
+    SkAssertResult(image->asLegacyBitmap(&imageBitmap));
+
+    auto alphaAt = [&](int x, int y) {
+        x -= kOrigin.fX;
+        y -= kOrigin.fY;
+        if (x < 0 || x >= imageBitmap.width() || y < 0 || y >= imageBitmap.height()) {
+            return 0.f;
+        }
+        return SkGetPackedA32(*imageBitmap.getAddr32(x, y)) / 255.f;
+    };
+    auto normalize = [](SkV3 v) {
+        float length = v.length();
+        return length > 0.f ? v * (1.f / length) : SkV3{0.f, 0.f, 0.f};
+    };
+
+    enum class LightType { kDistant, kPoint, kSpot };
+    struct {
+        LightType fType;
+        bool fSpecular;
+        sk_sp<SkImageFilter> fFilter;
+    } lights[] = {
+        {LightType::kDistant, false, SkImageFilters::DistantLitDiffuse(
+                kDirection, kLightColor, kSurfaceScale, kK, nullptr)},
+        {LightType::kPoint, true, SkImageFilters::PointLitSpecular(
+                kLocation, kLightColor, kSurfaceScale, kK, kShininess, nullptr)},
+        {LightType::kSpot, false, SkImageFilters::SpotLitDiffuse(
+                kLocation, kTarget, kFalloff, kCutoffAngle, kLightColor, kSurfaceScale, kK,
+                nullptr)},
+    };
+
+    const float cosCutoff = SkScalarCos(SkDegreesToRadians(kCutoffAngle));
+    const SkV3 spotDir = normalize({kTarget.fX - kLocation.fX,
+                                    kTarget.fY - kLocation.fY,
+                                    kTarget.fZ - kLocation.fZ});
+    for (const auto& light : lights) {
+        SkBitmap actual = draw_filtered_image(image, kOrigin, kSize, light.fFilter);
+
+        int maxError = 0;
+        for (int y = 0; y < kSize.height(); ++y) {
+            for (int x = 0; x < kSize.width(); ++x) {
+                // The Sobel normal and lighting equations of sk_normal and sk_lighting
+                float nx = 0.25f * ((alphaAt(x+1, y-1) + 2*alphaAt(x+1, y) + alphaAt(x+1, y+1)) -
+                                    (alphaAt(x-1, y-1) + 2*alphaAt(x-1, y) + alphaAt(x-1, y+1)));
+                float ny = 0.25f * ((alphaAt(x-1, y+1) + 2*alphaAt(x, y+1) + alphaAt(x+1, y+1)) -
+                                    (alphaAt(x-1, y-1) + 2*alphaAt(x, y-1) + alphaAt(x+1, y-1)));
+                SkV3 normal = normalize({-kSurfaceScale * nx, -kSurfaceScale * ny, 1.f});
+                SkV3 toLight = light.fType == LightType::kDistant
+                        ? normalize({kDirection.fX, kDirection.fY, kDirection.fZ})
+                        : normalize({kLocation.fX - (x + 0.5f),
+                                     kLocation.fY - (y + 0.5f),
+                                     kLocation.fZ - kSurfaceScale * alphaAt(x, y)});
+
+                float scale = 1.f;
+                if (light.fType == LightType::kSpot) {
+                    float cosAngle = -toLight.dot(spotDir);
+                    scale = cosAngle < cosCutoff ? 0.f : std::pow(cosAngle, kFalloff);
+                    if (cosAngle >= cosCutoff && cosAngle < cosCutoff + 0.016f) {
+                        scale *= (cosAngle - cosCutoff) / 0.016f;
+                    }
+                }
+                float coeff = light.fSpecular
+                        ? std::pow(std::max(normal.dot(normalize(toLight + SkV3{0.f, 0.f, 1.f})),
+                                            0.f), kShininess)
+                        : normal.dot(toLight);
+
+                int expected[4];
+                const int lightColor[3] = {(int) SkColorGetR(kLightColor),
+                                           (int) SkColorGetG(kLightColor),
+                                           (int) SkColorGetB(kLightColor)};
+                for (int c = 0; c < 3; ++c) {
+                    expected[c] = (int) std::lrint(
+                            255 * SkTPin(coeff * scale * kK * lightColor[c] / 255.f, 0.f, 1.f));
+                }
+                expected[3] = light.fSpecular ? std::max({expected[0], expected[1], expected[2]})
+                                              : 255;
+
+                SkPMColor pm = *actual.getAddr32(x, y);
+                const int actualChannels[4] = {(int) SkGetPackedR32(pm), (int) SkGetPackedG32(pm),
+                                               (int) SkGetPackedB32(pm), (int) SkGetPackedA32(pm)};
+                for (int c = 0; c < 4; ++c) {
+                    maxError = std::max(maxError, std::abs(actualChannels[c] - expected[c]));
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, maxError <= 2, "light %d, error %d",
+                        (int) light.fType, maxError);
+    }
+}
+
+DEF_TEST(ImageFilterDisplacement_MatchesReference, reporter) {
+    constexpr SkISize kSize = {80, 72};
+    constexpr SkIPoint kOrigin = {16, 12};
+    constexpr float kScale = 12.f;
+    sk_sp<SkImage> color = make_random_premul_image(48, 40);
+    sk_sp<SkImage> displacement = make_random_premul_image(64, 56);
+    SkBitmap colorBitmap, displacementBitmap;
+    SkAssertResult(color->asLegacyBitmap(&colorBitmap));
+    SkAssertResult(displacement->asLegacyBitmap(&displacementBitmap));
+
+    // Displace X by the unpremultiplied red channel and Y by alpha.
+    sk_sp<SkImageFilter> filter = SkImageFilters::DisplacementMap(
+            SkColorChannel::kR, SkColorChannel::kA, kScale,
+            SkImageFilters::Image(displacement, SkFilterMode::kNearest), nullptr);
+    SkBitmap actual = draw_filtered_image(color, kOrigin, kSize, std::move(filter));
+
+    int mismatches = 0;
+    for (int y = 0; y < kSize.height(); ++y) {
+        for (int x = 0; x < kSize.width(); ++x) {
+            SkPMColor d = x < displacementBitmap.width() && y < displacementBitmap.height()
+                                  ? *displacementBitmap.getAddr32(x, y) : 0;
+            float a = SkGetPackedA32(d) * (1 / 255.f);
+            float r = SkGetPackedR32(d) * (1 / 255.f) * (a > 0.f ? 1.f / a : 0.f);
+            int sx = (int) std::floor((x - kOrigin.fX + 0.5f) + kScale * (r - 0.5f));
+            int sy = (int) std::floor((y - kOrigin.fY + 0.5f) + kScale * (a - 0.5f));
+
+            SkPMColor expected = sx >= 0 && sx < colorBitmap.width() &&
+                                 sy >= 0 && sy < colorBitmap.height()
+                                         ? *colorBitmap.getAddr32(sx, sy) : 0;
+            mismatches += *actual.getAddr32(x, y) != expected;
+        }
+    }
+    // Allow for a sample point that rounds to the other side of a pixel edge.
+    REPORTER_ASSERT(reporter, mismatches <= kSize.area() / 100, "%d mismatches", mismatches);
+}
+
 static void test_big_kernel(skiatest::Reporter* reporter, GrRecordingContext* rContext) {
     // Check that a kernel that is too big for the GPU still works
     SkScalar identityKernel[49] = {
@@ -1835,6 +2148,202 @@ DEF_TEST(ImageFilterBlurLargeImage, reporter) {
     test_large_blur_input(reporter, surface->getCanvas());
 }
 
+static SkBitmap raster_blur(const SkBitmap& src, float sigmaX, float sigmaY) {
+    auto surface(SkSurfaces::Raster(src.info()));
+    SkPaint paint;
+    paint.setImageFilter(SkImageFilters::Blur(sigmaX, sigmaY, nullptr));
+    surface->getCanvas()->drawImage(src.asImage(), 0, 0, SkSamplingOptions(), &paint);
+
+    SkBitmap result;
+    result.allocPixels(src.info());
+    SkAssertResult(surface->readPixels(result, 0, 0));
+    return result;
+}
+
+static SkBitmap transpose_bitmap(const SkBitmap& src) {
+    SkBitmap dst;
+    dst.allocPixels(src.info().makeWH(src.height(), src.width()));
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *dst.getAddr32(y, x) = *src.getAddr32(x, y);
+        }
+    }
+    return dst;
+}
+
+// The raster vertical blur pass transposes bands of columns and blurs them as rows, so blurring
+// along Y must exactly match blurring the transposed image along X.
+DEF_TEST(ImageFilterBlur_VerticalMatchesTransposedHorizontal, reporter) {
+    // Odd dimensions so that neither the column bands nor the transpose tiles fit evenly.
+    SkBitmap src;
+    src.allocN32Pixels(301, 203);
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    SkBitmap srcT = transpose_bitmap(src);
+
+    // Covers the gaussian pass and triple box passes with windows narrower and wider than a band.
+    for (float sigma : {1.5f, 8.f, 60.f}) {
+        SkBitmap vertical = raster_blur(src, 0.f, sigma);
+        SkBitmap horizontal = raster_blur(srcT, sigma, 0.f);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(vertical, transpose_bitmap(horizontal)),
+                        "sigma %g", sigma);
+    }
+}
+
+// Large raster blurs are evaluated on a downsampled copy of the source. Both those and the full
+// resolution blurs should stay close to an exact gaussian blur of a square. Most of the allowed
+// error comes from the box passes approximating the gaussian, not from the downsampling.
+DEF_TEST(ImageFilterBlur_LargeSigmaMatchesGaussian, reporter) {
+    static constexpr int kSize = 512;
+    static constexpr int kSquareStart = 192;
+    static constexpr int kSquareEnd = 320;
+    static constexpr int kTolerance = 8;
+
+    SkBitmap src;
+    src.allocN32Pixels(kSize, kSize);
+    src.eraseColor(SK_ColorTRANSPARENT);
+    src.erase(SK_ColorWHITE, SkIRect::MakeLTRB(kSquareStart, kSquareStart, kSquareEnd, kSquareEnd));
+
+    for (float sigma : {20.f, 40.f, 70.f}) {
+        SkBitmap blurred = raster_blur(src, sigma, sigma);
+
+        // The fraction of a 1D gaussian centered at 'x' that falls within the square.
+        auto coverage = [sigma](int x) {
+            const double center = x + 0.5;
+            const double scale = 1.0 / (std::sqrt(2.0) * sigma);
+            return 0.5 * (std::erf((kSquareEnd - center) * scale) -
+                          std::erf((kSquareStart - center) * scale));
+        };
+
+        int maxError = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                const int expected = (int) std::lround(255 * coverage(x) * coverage(y));
+                maxError = std::max(maxError,
+                                    std::abs((int) SkColorGetA(blurred.getColor(x, y)) - expected));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxError <= kTolerance, "sigma %g, error %d", sigma, maxError);
+    }
+}
+
+// Large raster blurs are evaluated on a downsampled copy of the source, which should stay within
+// 4/255 per channel of blurring at full resolution with the same sigma.
+DEF_TEST(ImageFilterBlur_PyramidMatchesFullResolution, reporter) {
+    static constexpr int kSize = 512;
+    static constexpr int kTolerance = 4;
+
+    // Hard edges, thin lines, single pixels and translucent colors, none aligned to the blocks
+    // the downsampling averages.
+    SkBitmap src;
+    src.allocN32Pixels(kSize, kSize);
+    src.eraseColor(SK_ColorTRANSPARENT);
+    src.erase(SK_ColorRED, SkIRect::MakeLTRB(161, 157, 350, 353));
+    src.erase(0x800000FF, SkIRect::MakeLTRB(203, 95, 281, 401));
+    src.erase(SK_ColorGREEN, SkIRect::MakeLTRB(101, 100, 103, 421));
+    src.erase(SK_ColorWHITE, SkIRect::MakeLTRB(301, 303, 302, 304));
+
+    // The 8888 and A8 blur algorithms both use the pyramid.
+    SkBitmap alphaSrc;
+    alphaSrc.allocPixels(src.info().makeColorType(kAlpha_8_SkColorType));
+    SkAssertResult(src.readPixels(alphaSrc.pixmap()));
+
+    for (const SkBitmap& image : {src, alphaSrc}) {
+        for (SkSize sigma : {SkSize{32, 32}, SkSize{45, 45}, SkSize{70, 70}, SkSize{135, 135},
+                             SkSize{40, 120}}) {
+            SkBitmap pyramid = raster_blur(image, sigma.width(), sigma.height());
+            SkBitmap fullRes;
+            {
+                SkAutoDisableBlurPyramid disablePyramid;
+                fullRes = raster_blur(image, sigma.width(), sigma.height());
+            }
+
+            // Every byte of these color types is a channel.
+            int maxError = 0;
+            for (int y = 0; y < kSize; ++y) {
+                const uint8_t* a = static_cast<const uint8_t*>(pyramid.getAddr(0, y));
+                const uint8_t* b = static_cast<const uint8_t*>(fullRes.getAddr(0, y));
+                for (size_t i = 0; i < pyramid.info().minRowBytes(); ++i) {
+                    maxError = std::max(maxError, std::abs(a[i] - b[i]));
+                }
+            }
+            REPORTER_ASSERT(reporter, maxError <= kTolerance,
+                            "colorType %d, sigma (%g, %g), error %d",
+                            image.colorType(), sigma.width(), sigma.height(), maxError);
+        }
+    }
+}
+
+// Draws 'square', blurred by 'sigma', onto a surface of 'size', and returns the 256x256
+// neighborhood around 'center'.
+static SkBitmap blurred_square_neighborhood(SkISize size, SkIRect square, SkIPoint center,
+                                            float sigma, bool useLayer) {
+    auto surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(size));
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint filterPaint;
+    filterPaint.setImageFilter(SkImageFilters::Blur(sigma, sigma, nullptr));
+    if (useLayer) {
+        const SkRect layerBounds = SkRect::Make(square);
+        canvas->saveLayer(&layerBounds, &filterPaint);
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        canvas->drawIRect(square, paint);
+        canvas->restore();
+    } else {
+        SkBitmap squareBitmap;
+        squareBitmap.allocN32Pixels(square.width(), square.height());
+        squareBitmap.eraseColor(SK_ColorRED);
+        canvas->drawImage(squareBitmap.asImage(), square.fLeft, square.fTop,
+                          SkSamplingOptions(), &filterPaint);
+    }
+
+    SkBitmap neighborhood;
+    neighborhood.allocN32Pixels(256, 256);
+    SkAssertResult(surface->readPixels(neighborhood, center.fX - 128, center.fY - 128));
+    return neighborhood;
+}
+
+DEF_TEST(ImageFilterTiledOutput_MatchesUntiled, reporter) {
+    // Large enough that SkCanvas evaluates the filter output in tiles, with the square placed
+    // over the corner shared by four tiles. A sigma of 40 is blurred at reduced resolution, which
+    // must average the same pixels in every tile.
+    const SkISize bigSize = {4200, 4100};
+    const SkIPoint tileCorner = {2048, 2048};
+    for (float sigma : {6.f, 40.f}) {
+        for (bool useLayer : {true, false}) {
+            SkBitmap expected = blurred_square_neighborhood(
+                    {256, 256}, SkIRect::MakeXYWH(96, 96, 64, 64), {128, 128}, sigma, useLayer);
+            SkBitmap actual = blurred_square_neighborhood(
+                    bigSize, SkIRect::MakeXYWH(2016, 2016, 64, 64), tileCorner, sigma, useLayer);
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                            "sigma: %g layer: %d", sigma, useLayer);
+            if (sigma < 8.f) {
+                REPORTER_ASSERT(reporter, actual.getColor(128, 128) == SK_ColorRED);
+            }
+            REPORTER_ASSERT(reporter, actual.getColor(128 + 36, 128) != SK_ColorTRANSPARENT);
+        }
+    }
+
+    // A sigma of 150 is more than the raster blur engine evaluates directly, so the blur rescales
+    // its input relative to the bounds requested of it. The square reaches past the first tile's
+    // blur margin, so each tile would request, and rescale, a different part of it. The output
+    // must instead match a single evaluation on a surface too small to be tiled.
+    const SkIRect bigSquare = SkIRect::MakeLTRB(1900, 1900, 2800, 2800);
+    for (bool useLayer : {true, false}) {
+        SkBitmap expected = blurred_square_neighborhood(
+                {3300, 3300}, bigSquare, tileCorner, 150.f, useLayer);
+        SkBitmap actual = blurred_square_neighborhood(
+                bigSize, bigSquare, tileCorner, 150.f, useLayer);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                        "sigma: 150 layer: %d", useLayer);
+        REPORTER_ASSERT(reporter, actual.getColor(0, 0) != SK_ColorTRANSPARENT);
+    }
+}
+
 static void test_make_with_filter(
         skiatest::Reporter* reporter,
         const std::function<sk_sp<SkSurface>(int width, int height)>& createSurface,
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkImageInfo.h"
@@ -19,11 +20,15 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
+#include "src/core/SkCanvasPriv.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <climits>
+#include <cmath>
 #include <initializer_list>
+#include <iterator>
 #include <string>
 
 static bool has_green_pixels(const SkBitmap& bm) {
@@ -457,3 +462,64 @@ DEF_TEST(big_tiled_rect_crbug_927075, reporter) {
         canvas->drawRect(r, paint);
     }
 }
+
+// The batched solid-color rect path should match drawing each rect on its own, whether a rect is
+// memset directly (integral edges, opaque) or goes through a blitter.
+DEF_TEST(Rect_DrawEdgeAAQuadSet, reporter) {
+    const SkRect rects[] = {
+        {  0,  0,    40,  40},  // integral
+        { 10, 10, 30.5f,  50},  // fractional
+        { 45,  5,    75,  35},  // integral, drawn with a translucent color
+        { 55, 60,    60,  90},  // narrow
+        {-20, 70,    20, 130},  // straddles the clip
+    };
+    const SkColor4f colors[] = {
+        SkColor4f::FromColor(SK_ColorRED),
+        SkColor4f::FromColor(SK_ColorGREEN),
+        SkColor4f::FromColor(0x800000FF),
+        SkColor4f::FromColor(SK_ColorYELLOW),
+        SkColor4f::FromColor(SK_ColorCYAN),
+    };
+
+    const auto info = SkImageInfo::MakeN32Premul(100, 100);
+    for (SkCanvas::QuadAAFlags aa : {SkCanvas::kNone_QuadAAFlags, SkCanvas::kAll_QuadAAFlags}) {
+        for (SkBlendMode mode : {SkBlendMode::kSrcOver, SkBlendMode::kSrc}) {
+            for (SkScalar scale : {1.f, 1.5f, -1.f}) {
+                SkBitmap expected, actual;
+                for (SkBitmap* bm : {&expected, &actual}) {
+                    bm->allocPixels(info);
+                    bm->eraseColor(SK_ColorWHITE);
+                    SkCanvas canvas(*bm);
+                    canvas.clipRect({0, 0, 90, 100});
+                    if (scale < 0) {
+                        canvas.translate(100, 0);
+                    }
+                    canvas.scale(scale, std::abs(scale));
+                    if (bm == &expected) {
+                        for (size_t i = 0; i < std::size(rects); ++i) {
+                            canvas.experimental_DrawEdgeAAQuad(rects[i], nullptr, aa, colors[i],
+                                                               mode);
+                        }
+                    } else {
+                        SkCanvasPriv::DrawEdgeAAQuadSet(&canvas, rects, colors, aa, mode);
+                    }
+                }
+                REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                                "aa=%d mode=%d scale=%g", aa, (int)mode, scale);
+            }
+        }
+    }
+
+    // The batch is only skipped when none of it draws: a transparent first color must not make
+    // the visible rects after it get rejected.
+    const SkRect someRects[] = {{10, 10, 20, 20}, {30, 30, 40, 40}};
+    const SkColor4f someColors[] = {SkColors::kTransparent, SkColors::kRed};
+    SkBitmap bm;
+    bm.allocPixels(info);
+    bm.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bm);
+    SkCanvasPriv::DrawEdgeAAQuadSet(&canvas, someRects, someColors, SkCanvas::kNone_QuadAAFlags,
+                                    SkBlendMode::kSrcOver);
+    REPORTER_ASSERT(reporter, bm.getColor(15, 15) == SK_ColorWHITE);
+    REPORTER_ASSERT(reporter, bm.getColor(35, 35) == SK_ColorRED);
+}
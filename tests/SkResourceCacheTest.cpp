@@ -9,6 +9,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -24,6 +25,8 @@
 #include "src/core/SkCachedData.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkShardedResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/image/SkImage_Base.h"
 #include "src/lazy/SkDiscardableMemoryPool.h"
 #include "tests/Test.h"
@@ -306,3 +309,92 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+static bool always_valid(const SkResourceCache::Rec&, void*) { return true; }
+
+static size_t sum_bytes_used(SkShardedResourceCache* cache) {
+    size_t bytesUsed = 0;
+    cache->visitAll([](const SkResourceCache::Rec& rec, void* context) {
+        *static_cast<size_t*>(context) += rec.bytesUsed();
+    }, &bytesUsed);
+    return bytesUsed;
+}
+
+DEF_TEST(ResourceCache_Sharded_RespectsBudget, reporter) {
+    constexpr int kRecsInBudget = 100;
+    SkShardedResourceCache cache(kRecsInBudget * 1024, 8);
+    int flags = 0;
+
+    for (int i = 0; i < 3 * kRecsInBudget; ++i) {
+        auto rec = std::make_unique<TestRec>(1, i, &flags);
+        rec->fCanBePurged = true;
+        cache.add(rec.release());
+        REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() < cache.getTotalByteLimit());
+    }
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == sum_bytes_used(&cache));
+    // The most recent Rec is always kept.
+    REPORTER_ASSERT(reporter, cache.find(TestKey(1, 3 * kRecsInBudget - 1), always_valid, nullptr));
+
+    cache.purgeSharedID(1);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 3 * kRecsInBudget - 1), always_valid, nullptr));
+}
+
+static bool always_stale(const SkResourceCache::Rec&, void*) { return false; }
+
+DEF_TEST(ResourceCache_Sharded_FoundRecsOutlivePurge, reporter) {
+    SkShardedResourceCache cache(4 * 1024, 1);
+    int flags = 0;
+    for (int32_t data = 0; data < 3; ++data) {
+        auto rec = std::make_unique<TestRec>(1, data, &flags);
+        rec->fCanBePurged = true;
+        cache.add(rec.release());
+    }
+
+    // Finding the oldest Rec doesn't reorder the list, but the purge caused by the next add()
+    // should skip over it.
+    REPORTER_ASSERT(reporter, cache.find(TestKey(1, 0), always_valid, nullptr));
+    auto rec = std::make_unique<TestRec>(1, 3, &flags);
+    rec->fCanBePurged = true;
+    cache.add(rec.release());
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 3 * 1024);
+    REPORTER_ASSERT(reporter, cache.find(TestKey(1, 0), always_valid, nullptr));
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 1), always_valid, nullptr));
+    REPORTER_ASSERT(reporter, cache.find(TestKey(1, 2), always_valid, nullptr));
+    REPORTER_ASSERT(reporter, cache.find(TestKey(1, 3), always_valid, nullptr));
+
+    // A stale Rec is still removed.
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 2), always_stale, nullptr));
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 2), always_valid, nullptr));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 2 * 1024);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == sum_bytes_used(&cache));
+}
+
+DEF_TEST(ResourceCache_Sharded_ConcurrentFindAndAdd, reporter) {
+    constexpr int kThreads = 8;
+    constexpr int kRecsPerThread = 200;
+    SkShardedResourceCache cache(2 * kThreads * kRecsPerThread * 1024);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(kThreads);
+
+    SkTaskGroup(*executor).batch(kThreads, [&](int thread) {
+        int flags = 0;
+        for (int i = 0; i < kRecsPerThread; ++i) {
+            const int32_t data = thread * kRecsPerThread + i;
+            if (!cache.find(TestKey(1, data), always_valid, nullptr)) {
+                auto rec = std::make_unique<TestRec>(1, data, &flags);
+                rec->fCanBePurged = true;
+                cache.add(rec.release());
+            }
+            // Look up a Rec another thread may be adding right now.
+            const int32_t other = ((thread + 1) % kThreads) * kRecsPerThread + i;
+            cache.find(TestKey(1, other), always_valid, nullptr);
+        }
+    });
+
+    // Everything fits in the budget, so nothing was purged.
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == kThreads * kRecsPerThread * 1024);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == sum_bytes_used(&cache));
+    for (int32_t data = 0; data < kThreads * kRecsPerThread; ++data) {
+        REPORTER_ASSERT(reporter, cache.find(TestKey(1, data), always_valid, nullptr));
+    }
+}
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkMatrix.h"
@@ -16,10 +17,13 @@
 #include "src/core/SkStrike.h"  // IWYU pragma: keep
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <memory>
+
 DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
     SkStrikeCache cache;
 
@@ -61,3 +65,51 @@ DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
 
 
 }
+
+DEF_TEST(SkStrikeCache_RecentlyFoundStrikeSurvivesPurge, Reporter) {
+    SkStrikeCache cache;
+
+    SkFont font = ToolUtils::DefaultFont();
+    SkPaint defaultPaint;
+    auto make_spec = [&](float size) {
+        font.setSize(size);
+        return SkStrikeSpec::MakeMask(font, defaultPaint,
+                                      SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                                      SkScalerContextFlags::kNone, SkMatrix::I());
+    };
+    SkStrikeSpec specs[] = {make_spec(10), make_spec(11), make_spec(12), make_spec(13)};
+
+    for (const SkStrikeSpec& spec : specs) {
+        spec.findOrCreateStrike(&cache);
+    }
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 4);
+
+    // Finding the oldest strike doesn't reorder the cache, but it is still treated as recently
+    // used, so the next oldest strike is purged instead.
+    REPORTER_ASSERT(Reporter, specs[0].findOrCreateStrike(&cache) != nullptr);
+    cache.setCacheCountLimit(3);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 3);
+    REPORTER_ASSERT(Reporter, cache.findStrike(specs[0].descriptor()) != nullptr);
+    REPORTER_ASSERT(Reporter, cache.findStrike(specs[1].descriptor()) == nullptr);
+}
+
+DEF_TEST(SkStrikeCache_ConcurrentFindOrCreate, Reporter) {
+    SkStrikeCache cache;
+    constexpr int kThreads = 8;
+    constexpr int kSizes = 4;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(kThreads);
+
+    SkTaskGroup(*executor).batch(kThreads, [&](int thread) {
+        SkFont font = ToolUtils::DefaultFont();
+        SkPaint defaultPaint;
+        for (int i = 0; i < 100; ++i) {
+            font.setSize(10 + (thread + i) % kSizes);
+            SkStrikeSpec spec = SkStrikeSpec::MakeMask(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I());
+            sk_sp<SkStrike> strike = spec.findOrCreateStrike(&cache);
+            REPORTER_ASSERT(Reporter, strike && strike->getDescriptor() == spec.descriptor());
+        }
+    });
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == kSizes);
+}
@@ -11,12 +11,14 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkSwizzle.h"
 #include "src/codec/SkSampler.h"
+#include "src/core/SkMasks.h"
 #include "src/core/SkSwizzlePriv.h"
 #include "tests/Test.h"
 
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 static void check_fill(skiatest::Reporter* r,
                        const SkImageInfo& imageInfo,
@@ -160,6 +162,99 @@ DEF_TEST(PublicSwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
 
+DEF_TEST(SwizzleOpts_sourceFormats, r) {
+    // Widths that cover the vectorized loops and their tails.
+    for (int n : {1, 3, 7, 8, 11, 16, 17, 33, 100}) {
+        std::vector<uint8_t> src(8 * n);
+        for (size_t i = 0; i < src.size(); i++) {
+            src[i] = (uint8_t)(i * 37 + 11);
+        }
+        std::vector<uint32_t> dst(n);
+
+        // 16-bit channels are big-endian, so the first byte of each is the most significant.
+        SkOpts::RGB16_to_RGB1(dst.data(), src.data(), n);
+        for (int i = 0; i < n; i++) {
+            const uint8_t* p = &src[6 * i];
+            REPORTER_ASSERT(r, dst[i] == (0xFF000000 | p[4] << 16 | p[2] << 8 | p[0]));
+        }
+        SkOpts::RGB16_to_BGR1(dst.data(), src.data(), n);
+        for (int i = 0; i < n; i++) {
+            const uint8_t* p = &src[6 * i];
+            REPORTER_ASSERT(r, dst[i] == (0xFF000000 | p[0] << 16 | p[2] << 8 | p[4]));
+        }
+        SkOpts::RGBA16_to_RGBA(dst.data(), src.data(), n);
+        for (int i = 0; i < n; i++) {
+            const uint8_t* p = &src[8 * i];
+            REPORTER_ASSERT(r, dst[i] == ((uint32_t)p[6] << 24 | p[4] << 16 | p[2] << 8 | p[0]));
+        }
+        SkOpts::RGBA16_to_BGRA(dst.data(), src.data(), n);
+        for (int i = 0; i < n; i++) {
+            const uint8_t* p = &src[8 * i];
+            REPORTER_ASSERT(r, dst[i] == ((uint32_t)p[6] << 24 | p[0] << 16 | p[2] << 8 | p[4]));
+        }
+
+        uint32_t table[256];
+        for (int i = 0; i < 256; i++) {
+            table[i] = 0xFF000000 | (uint32_t)(i * 0x010203);
+        }
+        SkOpts::index_to_8888(dst.data(), src.data(), n, table);
+        for (int i = 0; i < n; i++) {
+            REPORTER_ASSERT(r, dst[i] == table[src[i]]);
+        }
+
+        // Masks of every size from 1 to 8 bits, and wider ones that SkMasks truncates.
+        const SkMasks::InputMasks inputs16[] = {
+            {0x7C00, 0x03E0, 0x001F, 0x8000},
+            {0xF800, 0x07E0, 0x001F, 0},
+            {0x0F00, 0x00F0, 0x000F, 0xF000},
+            {0xE000, 0x1C00, 0x0300, 0x00FF},
+        };
+        const SkMasks::InputMasks inputs32[] = {
+            {0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000},
+            {0x3FF00000, 0x000FFC00, 0x000003FF, 0xC0000000},
+            {0xFE000000, 0x01F80000, 0x00070000, 0x0000FFFF},
+        };
+        auto check_masks = [&](const SkMasks::InputMasks& input, int bytesPerPixel) {
+            std::unique_ptr<SkMasks> masks(SkMasks::CreateMasks(input, bytesPerPixel));
+            const SkMasks::MaskInfo channels[4] = {
+                masks->redInfo(), masks->greenInfo(), masks->blueInfo(), masks->alphaInfo(),
+            };
+            std::vector<uint32_t> opaque(n);
+            if (bytesPerPixel == 2) {
+                const uint16_t* src16 = reinterpret_cast<const uint16_t*>(src.data());
+                SkOpts::masked16_to_RGBA(dst.data(), src16, n, channels);
+                SkOpts::masked16_to_RGB1(opaque.data(), src16, n, channels);
+            } else {
+                const uint32_t* src32 = reinterpret_cast<const uint32_t*>(src.data());
+                SkOpts::masked32_to_RGBA(dst.data(), src32, n, channels);
+                SkOpts::masked32_to_RGB1(opaque.data(), src32, n, channels);
+            }
+            for (int i = 0; i < n; i++) {
+                uint32_t p;
+                if (bytesPerPixel == 2) {
+                    uint16_t p16;
+                    memcpy(&p16, &src[2 * i], 2);
+                    p = p16;
+                } else {
+                    memcpy(&p, &src[4 * i], 4);
+                }
+                const uint32_t expected = (uint32_t)masks->getAlpha(p) << 24 |
+                                          masks->getBlue(p) << 16 |
+                                          masks->getGreen(p) << 8 |
+                                          masks->getRed(p);
+                REPORTER_ASSERT(r, dst[i] == expected);
+                REPORTER_ASSERT(r, opaque[i] == (expected | 0xFF000000));
+            }
+        };
+        for (const auto& input : inputs16) {
+            check_masks(input, 2);
+        }
+        for (const auto& input : inputs32) {
+            check_masks(input, 4);
+        }
+    }
+}
+
 using fn_reciprocal = float (*)(float);
 static void test_reciprocal_alpha(
         skiatest::Reporter* reporter,
@@ -7,6 +7,8 @@
 
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedOrigin.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkAlphaType.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
@@ -20,10 +22,14 @@
 #include "include/effects/SkColorMatrix.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkConvertYUVAPixels.h"
+#include "src/core/SkYUVMath.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -207,6 +213,108 @@ DEF_TEST(Jpeg_YUV_Encode, r) {
     }
 }
 
+// SkConvertYUVAPixels() should match libjpeg's own conversion of the planes to RGB.
+DEF_TEST(Jpeg_YUV_ConvertToRGBA, r) {
+    const char* paths[] = {
+            "images/color_wheel.jpg",
+            "images/mandrill_512_q075.jpg",
+            "images/mandrill_h1v1.jpg",
+            "images/mandrill_h2v1.jpg",
+            "images/cropped_mandrill.jpg",
+    };
+    for (const auto* path : paths) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        SkYUVAPixmaps planes = decode_yuva(r, SkMemoryStream::Make(data));
+        std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+        if (!planes.isValid() || !codec) {
+            continue;
+        }
+        SkBitmap expected;
+        expected.allocPixels(codec->getInfo().makeColorType(kRGBA_8888_SkColorType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected.pixmap()));
+
+        for (SkColorType colorType : {kRGBA_8888_SkColorType, kRGBA_F16_SkColorType}) {
+            SkBitmap converted;
+            converted.allocPixels(expected.info().makeColorType(colorType));
+            if (!SkConvertYUVAPixels(converted.pixmap(), planes, codec->getInfo().colorSpace())) {
+                ERRORF(r, "%s: failed to convert to color type %d", path, colorType);
+                continue;
+            }
+            SkBitmap actual;
+            actual.allocPixels(expected.info());
+            REPORTER_ASSERT(r, converted.readPixels(actual.pixmap()));
+
+            // libjpeg converts in fixed point, so allow for its rounding.
+            constexpr int kTolerance = 3;
+            int maxDiff = 0;
+            for (int y = 0; y < expected.height(); ++y) {
+                const uint8_t* a = static_cast<const uint8_t*>(expected.getAddr(0, y));
+                const uint8_t* b = static_cast<const uint8_t*>(actual.getAddr(0, y));
+                for (int i = 0; i < 4 * expected.width(); ++i) {
+                    maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+                }
+            }
+            REPORTER_ASSERT(r, maxDiff <= kTolerance, "%s, color type %d: max difference %d",
+                            path, colorType, maxDiff);
+        }
+    }
+}
+
+// With an alpha plane, SkConvertYUVAPixels() should premultiply the converted colors by it for a
+// premul dst, and leave them as they are for an unpremul one.
+DEF_TEST(YUVA_ConvertToRGBA_Alpha, r) {
+    constexpr SkISize kSize = {16, 8};
+    constexpr SkYUVColorSpace kColorSpace = kJPEG_Full_SkYUVColorSpace;
+    SkYUVAInfo yuvaInfo(kSize, SkYUVAInfo::PlaneConfig::kY_U_V_A, SkYUVAInfo::Subsampling::k444,
+                        kColorSpace);
+    SkYUVAPixmaps planes = SkYUVAPixmaps::Allocate(
+            SkYUVAPixmapInfo(yuvaInfo, SkYUVAPixmapInfo::DataType::kUnorm8, nullptr));
+    REPORTER_ASSERT(r, planes.isValid());
+    for (int y = 0; y < kSize.height(); ++y) {
+        for (int x = 0; x < kSize.width(); ++x) {
+            *planes.plane(0).writable_addr8(x, y) = SkToU8(16 * x + 5);
+            *planes.plane(1).writable_addr8(x, y) = SkToU8(96 + 8 * y);
+            *planes.plane(2).writable_addr8(x, y) = SkToU8(160 - 4 * x);
+            *planes.plane(3).writable_addr8(x, y) = SkToU8(255 - 36 * y);
+        }
+    }
+
+    float yuvToRGB[20];
+    SkColorMatrix_YUV2RGB(kColorSpace, yuvToRGB);
+    for (SkAlphaType alphaType : {kPremul_SkAlphaType, kUnpremul_SkAlphaType}) {
+        SkBitmap dst;
+        dst.allocPixels(SkImageInfo::Make(kSize, kRGBA_8888_SkColorType, alphaType));
+        REPORTER_ASSERT(r, SkConvertYUVAPixels(dst.pixmap(), planes, nullptr));
+
+        int maxDiff = 0;
+        for (int y = 0; y < kSize.height(); ++y) {
+            for (int x = 0; x < kSize.width(); ++x) {
+                const float yuv[3] = {*planes.plane(0).addr8(x, y) / 255.f,
+                                      *planes.plane(1).addr8(x, y) / 255.f,
+                                      *planes.plane(2).addr8(x, y) / 255.f};
+                const float a = *planes.plane(3).addr8(x, y) / 255.f;
+                const uint8_t* actual = static_cast<const uint8_t*>(dst.getAddr(x, y));
+                for (int c = 0; c < 3; ++c) {
+                    const float* m = yuvToRGB + 5 * c;
+                    float expected = std::clamp(
+                            m[0] * yuv[0] + m[1] * yuv[1] + m[2] * yuv[2] + m[4], 0.f, 1.f);
+                    if (alphaType == kPremul_SkAlphaType) {
+                        expected *= a;
+                    }
+                    const int rounded = (int)std::lround(255 * expected);
+                    maxDiff = std::max(maxDiff, std::abs(actual[c] - rounded));
+                }
+                const int roundedA = (int)std::lround(255 * a);
+                maxDiff = std::max(maxDiff, std::abs(actual[3] - roundedA));
+            }
+        }
+        REPORTER_ASSERT(r, maxDiff <= 1, "alpha type %d: max difference %d", alphaType, maxDiff);
+    }
+}
+
 // Be sure that the two matrices are inverses of each other
 // (i.e. rgb2yuv and yuv2rgb
 DEF_TEST(YUVMath, reporter) {
@@ -14,6 +14,7 @@
 #include "include/core/SkSurface.h"
 #include "src/codec/SkCodecImageGenerator.h"
 #include "src/core/SkColorPriv.h"
+#include "src/core/SkConvertYUVAPixels.h"
 #include "src/core/SkYUVAInfoLocation.h"
 #include "src/core/SkYUVMath.h"
 #include "src/image/SkImage_Base.h"
@@ -81,6 +82,13 @@ protected:
             fFlattened.allocPixels(info);
             SkASSERT(info == this->getInfo());
 
+            // Planes that need no reorientation are converted in one pass, with the chroma
+            // upsampled smoothly like a JPEG decoder would.
+            if (fPixmaps.yuvaInfo().origin() == kTopLeft_SkEncodedOrigin &&
+                SkConvertYUVAPixels(fFlattened.pixmap(), fPixmaps, info.colorSpace())) {
+                return fFlattened.readPixels(info, pixels, rowBytes, 0, 0);
+            }
+
             float mtx[20];
             SkColorMatrix_YUV2RGB(fPixmaps.yuvaInfo().yuvColorSpace(), mtx);
             SkYUVAInfo::YUVALocations yuvaLocations = fPixmaps.toYUVALocations();